@@ -0,0 +1,192 @@
+/******************************************************************************
+* File Name:   analog_backend.h
+*
+* Description: This file is the interface between the self tests in
+*              self_test.c and the analog hardware they exercise. The target
+*              implementation (analog_backend_hw.c) drives the SAR, LPCOMP and
+*              CTB blocks through the PDL and the Class-B Safety Test Library.
+*              The host implementation (host_sim/analog_sim.c) models the same
+*              blocks so that the self tests can run as a native executable.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef ANALOG_BACKEND_H_
+#define ANALOG_BACKEND_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#if defined(SELF_TEST_HOST_SIM)
+#include "analog_sim.h"
+#else
+#include "cyhal.h"
+#include "cybsp.h"
+#include "SelfTest.h"
+#endif
+#include "self_test_target.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Page of the non-volatile result store: the unit that is erased and written
+ * at once, a multiple of the flash sector and program page size. It is one
+ * flash row on PSoC 6 and one large work flash sector on XMC7000. The store
+ * takes ANALOG_BACKEND_NV_PAGES of them.
+ */
+#if COMPONENT_CAT1C
+#define ANALOG_BACKEND_NV_PAGE_SIZE        (2048u)
+#define ANALOG_BACKEND_NV_PAGES            (8u)
+#else
+#define ANALOG_BACKEND_NV_PAGE_SIZE        (512u)
+#define ANALOG_BACKEND_NV_PAGES            (16u)
+#endif
+
+/* Settling time of the analog reference after analog_backend_init, the AREF
+ * on PSoC 6 and the SAR2 reference buffer on XMC7000. It must cover the
+ * start-up time given in the device datasheet for the configured start-up
+ * mode; conversions taken earlier read high.
+ */
+#ifndef ANALOG_BACKEND_REF_SETTLE_US
+    #define ANALOG_BACKEND_REF_SETTLE_US   (100u)
+#endif
+
+/* Longest wait for a blocking SAR conversion; a channel that does not complete
+ * in time reads 0, which fails every test.
+ */
+#define ANALOG_BACKEND_SAR_TIMEOUT_US      (1000u)
+
+/* Number of LPCOMP channels. Channel 0 is CYBSP_DUT_LPCOMP_CHANNEL, the one
+ * wired to the comparator input pins; channel 1 is the other channel.
+ */
+#define ANALOG_COMP_CHANNELS               (2u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Routing of the comparator inputs on the analog mux buses */
+typedef enum
+{
+    /* VPLUS pin on AMUXBUS B, VMINUS pin on AMUXBUS A */
+    ANALOG_COMP_ROUTE_VPLUS_AMUXB = 0u,
+    /* VPLUS pin on AMUXBUS A, VMINUS pin on AMUXBUS B */
+    ANALOG_COMP_ROUTE_VPLUS_AMUXA = 1u
+} analog_comp_route_t;
+
+/* Source of a comparator channel input */
+typedef enum
+{
+    ANALOG_COMP_INPUT_PIN = 0u,    /* Dedicated input pin of the channel */
+    ANALOG_COMP_INPUT_AMUXA,       /* AMUXBUS A, switched directly */
+    ANALOG_COMP_INPUT_AMUXB,       /* AMUXBUS B, switched directly */
+    ANALOG_COMP_INPUT_VREF         /* Local reference, negative input only */
+} analog_comp_input_t;
+
+/* Source of the opamp Vplus input */
+typedef enum
+{
+    ANALOG_OPAMP_INPUT_PIN = 0u,   /* Vplus input pin, the reference under test */
+    ANALOG_OPAMP_INPUT_AMUXA       /* AMUXBUS A, the starting level of a step */
+} analog_opamp_input_t;
+
+/* Called from the conversion complete interrupt of an asynchronous conversion */
+typedef void (*analog_adc_done_cb_t)(void);
+
+/* Reason the core left deep sleep */
+typedef enum
+{
+    ANALOG_WAKE_TIMER = 0u,        /* The low-power timer expired */
+    ANALOG_WAKE_COMPARATOR,        /* The comparator supervisor fired */
+    ANALOG_WAKE_OTHER              /* Any other interrupt */
+} analog_wake_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint8_t analog_backend_init(void);
+uint32_t analog_backend_ref_settle_us(void);
+void analog_backend_time_init(void);
+uint32_t analog_backend_time_us(void);
+uint32_t analog_backend_cpu_ticks(void);
+uint32_t analog_backend_cpu_ticks_per_us(void);
+void analog_backend_delay_us(uint32_t us);
+analog_wake_t analog_backend_deep_sleep(uint32_t duration_us);
+
+uint8_t analog_backend_adc_selftest(uint32_t channel, int16_t expected_res,
+        int16_t accuracy, uint32_t vbg_channel);
+void analog_backend_adc_start(uint32_t channel);
+bool analog_backend_adc_is_done(void);
+void analog_backend_adc_stop(void);
+int32_t analog_backend_adc_read_mv(uint32_t channel);
+void analog_backend_adc_scan(const uint32_t *channels, uint32_t count,
+        int16_t *counts);
+void analog_backend_adc_async_start(const uint32_t *channels, uint32_t count,
+        int16_t *counts, analog_adc_done_cb_t done_cb);
+void analog_backend_adc_async_cancel(void);
+int32_t analog_backend_adc_counts_to_mv(uint32_t channel, int16_t counts);
+
+const uint8_t *analog_backend_nv_page(uint32_t page);
+bool analog_backend_nv_write(uint32_t page, const uint8_t *data);
+bool analog_backend_nv_busy(void);
+
+void analog_backend_wdt_start(uint32_t timeout_ms);
+void analog_backend_wdt_kick(void);
+bool analog_backend_wdt_caused_reset(void);
+
+#if SELF_TEST_HAS_COMPARATOR
+void analog_backend_comp_setup(void);
+void analog_backend_comp_route(analog_comp_route_t route);
+uint8_t analog_backend_comp_selftest(uint32_t expected_res);
+uint32_t analog_backend_comp_read(void);
+void analog_backend_comp_connect(uint32_t channel_mask, analog_comp_input_t vplus,
+        analog_comp_input_t vminus);
+uint32_t analog_backend_comp_read_channel(uint32_t channel);
+void analog_backend_comp_supervise(bool enable);
+#endif
+
+#if SELF_TEST_HAS_OPAMP
+void analog_backend_opamp_setup(void);
+uint8_t analog_backend_opamp_selftest(int16_t expected_res, int16_t accuracy,
+        uint32_t sar_channel);
+void analog_backend_opamp_input(analog_opamp_input_t input);
+#endif
+
+#endif /* ANALOG_BACKEND_H_ */
+
+/* [] END OF FILE */
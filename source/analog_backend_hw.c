@@ -0,0 +1,1467 @@
+/******************************************************************************
+* File Name:   analog_backend_hw.c
+*
+* Description: This file implements the analog backend on the target. The
+*              self tests are forwarded to the Class-B Safety Test Library
+*              and the peripherals are configured through the PDL.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "analog_backend.h"
+#include "cy_retarget_io.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#if COMPONENT_CAT1C
+/* VDDA in millivolts, used to scale SAR2 results */
+#if defined(CY_CFG_PWR_VDDA_MV)
+    #define ANALOG_BACKEND_VDDA_MV         (CY_CFG_PWR_VDDA_MV)
+#else
+    #define ANALOG_BACKEND_VDDA_MV         (3300u)
+#endif
+/* Full scale of the 12-bit SAR2 result */
+#define ANALOG_BACKEND_SAR2_FULL_SCALE     (4096u)
+/* CPU interrupt the SAR2 channel interrupts are routed to */
+#define ANALOG_BACKEND_SAR2_CPU_IRQ        (NvicMux3_IRQn)
+#endif
+
+/* Priority of the conversion complete interrupt */
+#define ANALOG_BACKEND_SAR_IRQ_PRIORITY    (3u)
+
+#if (CY_CPU_CORTEX_M0P)
+/* The CM0+ has no DWT cycle counter; its free-running 24-bit SysTick
+ * down-counter is extended to 32 bits instead.
+ */
+#define ANALOG_BACKEND_SYSTICK_MASK        (0x00FFFFFFuL)
+#if COMPONENT_CAT1A
+/* CPU interrupt the SAR interrupt is muxed to on the CM0+ */
+#define ANALOG_BACKEND_SAR_CM0P_IRQ        (NvicMux3_IRQn)
+#endif
+#endif
+
+#if SELF_TEST_HAS_COMPARATOR
+/* Index of the comparator input pins in comp_route_hsiom */
+#define COMP_PIN_VPLUS                     (0u)
+#define COMP_PIN_VMINUS                    (1u)
+/* Priority of the comparator supervisor interrupt */
+#define ANALOG_BACKEND_COMP_IRQ_PRIORITY   (3u)
+/* Interrupt mask of the comparator channel; the PDL channel and interrupt
+ * encodings are identical.
+ */
+#define COMP_INTR_MASK                     ((uint32_t)CYBSP_DUT_LPCOMP_CHANNEL)
+#endif
+
+/* Clock of the low-power timer that ends deep sleep, the LFCLK */
+#define ANALOG_BACKEND_LPTIMER_HZ          (32768u)
+/* Priority of the low-power timer interrupt */
+#define ANALOG_BACKEND_LPTIMER_PRIORITY    (7u)
+/* Longest wait for the debug UART to drain before deep sleep */
+#define ANALOG_BACKEND_UART_FLUSH_MS       (50u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Conversion channel started by analog_backend_adc_start */
+static uint32_t adc_pending_channel;
+
+/* State of the asynchronous conversion in progress */
+static const uint32_t *async_channels;
+static uint32_t async_count;
+static int16_t *async_counts;
+static analog_adc_done_cb_t async_done_cb;
+#if COMPONENT_CAT1A
+static bool async_irq_ready;
+#elif COMPONENT_CAT1C
+static uint32_t async_index;
+static uint32_t async_irq_ready_mask;
+#endif
+
+/* Time the analog reference was enabled at */
+static uint32_t ref_start_us;
+
+/* State of the microsecond time base built on the CPU cycle counter */
+static uint32_t time_last_cycles;
+static uint32_t time_us;
+static uint32_t time_rem_cycles;
+static bool time_started;
+#if (CY_CPU_CORTEX_M0P)
+static uint32_t systick_last;
+static uint32_t systick_cycles;
+#endif
+
+#if SELF_TEST_HAS_COMPARATOR
+/* HSIOM selection of the VPLUS and VMINUS pins for each comparator routing */
+static const en_hsiom_sel_t comp_route_hsiom[][2] =
+{
+    [ANALOG_COMP_ROUTE_VPLUS_AMUXB] = { HSIOM_SEL_AMUXB, HSIOM_SEL_AMUXA },
+    [ANALOG_COMP_ROUTE_VPLUS_AMUXA] = { HSIOM_SEL_AMUXA, HSIOM_SEL_AMUXB },
+};
+
+/* Routing currently applied to the comparator input pins */
+static analog_comp_route_t comp_route_current;
+
+/* LPCOMP channel and input switch of each backend channel and input */
+static const cy_en_lpcomp_channel_t comp_channels[ANALOG_COMP_CHANNELS] =
+{
+    CYBSP_DUT_LPCOMP_CHANNEL,
+    (CY_LPCOMP_CHANNEL_0 == CYBSP_DUT_LPCOMP_CHANNEL) ? CY_LPCOMP_CHANNEL_1 : CY_LPCOMP_CHANNEL_0,
+};
+static const cy_en_lpcomp_inputs_t comp_input_sw[] =
+{
+    [ANALOG_COMP_INPUT_PIN] = CY_LPCOMP_SW_GPIO,
+    [ANALOG_COMP_INPUT_AMUXA] = CY_LPCOMP_SW_AMUXBUSA,
+    [ANALOG_COMP_INPUT_AMUXB] = CY_LPCOMP_SW_AMUXBUSB,
+    [ANALOG_COMP_INPUT_VREF] = CY_LPCOMP_SW_LOCAL_VREF,
+};
+
+/* Inputs currently connected to each channel, and the channels and local
+ * reference enabled by analog_backend_comp_connect
+ */
+static analog_comp_input_t comp_inputs_current[ANALOG_COMP_CHANNELS][2];
+static uint32_t comp_channels_ready;
+static bool comp_vref_ready;
+
+/* State of the comparator supervisor */
+static volatile bool comp_wake_pending;
+static bool comp_supervisor_ready;
+static cy_stc_lpcomp_context_t comp_syspm_context;
+static cy_stc_syspm_callback_params_t comp_syspm_params =
+{
+    .base       = CYBSP_DUT_LPCOMP_HW,
+    .context    = &comp_syspm_context
+};
+static cy_stc_syspm_callback_t comp_syspm_callback =
+{
+    .callback       = &Cy_LPComp_DeepSleepCallback,
+    .type           = CY_SYSPM_DEEPSLEEP,
+    .skipMode       = 0u,
+    .callbackParams = &comp_syspm_params,
+    .prevItm        = NULL,
+    .nextItm        = NULL,
+    .order          = 0u
+};
+#endif
+
+/* Low-power timer that ends deep sleep */
+static cyhal_lptimer_t lp_timer;
+static bool lp_timer_ready;
+
+#if SELF_TEST_HAS_OPAMP
+/* CTB configuration built once from CYBSP_DUT_OPAMP_config */
+static cy_stc_ctb_config_t opamp_ctb_config;
+/* Vplus input pin switches closed by the generated routing */
+static uint32_t opamp_pin_switches;
+#endif
+
+/* Hardware watchdog of the self-test supervisor */
+static cyhal_wdt_t wdt_obj;
+static bool wdt_ready;
+
+#if !(CY_CPU_CORTEX_M0P)
+/* Flash reserved for the result store, in the emulated EEPROM region. In the
+ * dual-core build the store is kept by the CM4 only.
+ */
+CY_SECTION(".cy_em_eeprom") CY_ALIGN(ANALOG_BACKEND_NV_PAGE_SIZE)
+static const uint8_t nv_region[ANALOG_BACKEND_NV_PAGES * ANALOG_BACKEND_NV_PAGE_SIZE] = { 0u };
+
+/* State of the page write in progress, see analog_backend_nv_busy */
+static cyhal_flash_t nv_flash;
+static bool nv_ready;
+static uint32_t nv_sector_size;
+static uint32_t nv_program_size;
+static const uint8_t *nv_data;
+static uint32_t nv_addr;
+static uint32_t nv_erased;
+static uint32_t nv_programmed;
+#endif
+
+/*******************************************************************************
+* Function Name: analog_backend_sar_isr
+********************************************************************************
+* Summary:
+* Conversion complete interrupt of an asynchronous conversion. The results are
+* copied to the caller's buffer and the completion callback is invoked. On
+* CAT1C devices the channels are converted one after the other and the next
+* channel is triggered from here.
+*
+*******************************************************************************/
+static void analog_backend_sar_isr(void)
+{
+#if COMPONENT_CAT1A
+    uint32_t i;
+
+    if (0u != (Cy_SAR_GetInterruptStatusMasked(CYBSP_DUT_SAR_ADC_HW) & CY_SAR_INTR_EOS))
+    {
+        Cy_SAR_SetInterruptMask(CYBSP_DUT_SAR_ADC_HW, 0u);
+        Cy_SAR_ClearInterrupt(CYBSP_DUT_SAR_ADC_HW, CY_SAR_INTR_EOS);
+
+        for (i = 0u; i < async_count; i++)
+        {
+            async_counts[i] = Cy_SAR_GetResult16(CYBSP_DUT_SAR_ADC_HW, async_channels[i]);
+        }
+        async_done_cb();
+    }
+#elif COMPONENT_CAT1C
+    uint32_t channel = async_channels[async_index];
+
+    if (0u != (Cy_SAR2_Channel_GetInterruptStatusMasked(CYBSP_DUT_SAR_ADC_HW, channel) &
+            CY_SAR2_INT_GRP_DONE))
+    {
+        Cy_SAR2_Channel_SetInterruptMask(CYBSP_DUT_SAR_ADC_HW, channel, 0u);
+        async_counts[async_index] =
+                (int16_t)Cy_SAR2_Channel_GetResult(CYBSP_DUT_SAR_ADC_HW, channel, NULL);
+        Cy_SAR2_Channel_ClearInterrupt(CYBSP_DUT_SAR_ADC_HW, channel, CY_SAR2_INT_GRP_DONE);
+
+        async_index++;
+        if (async_index < async_count)
+        {
+            channel = async_channels[async_index];
+            Cy_SAR2_Channel_SetInterruptMask(CYBSP_DUT_SAR_ADC_HW, channel,
+                    CY_SAR2_INT_GRP_DONE);
+            Cy_SAR2_Channel_SoftwareTrigger(CYBSP_DUT_SAR_ADC_HW, channel);
+        }
+        else
+        {
+            async_done_cb();
+        }
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_cycles
+********************************************************************************
+* Summary:
+* Returns the 32-bit CPU cycle count: the DWT cycle counter on the CM4 and the
+* SysTick counter, extended in software, on the CM0+. The extension must be
+* called at least once per SysTick wrap (2^24 cycles).
+*
+*******************************************************************************/
+static uint32_t analog_backend_cycles(void)
+{
+#if (CY_CPU_CORTEX_M0P)
+    uint32_t now = (0u - SysTick->VAL) & ANALOG_BACKEND_SYSTICK_MASK;
+
+    systick_cycles += (now - systick_last) & ANALOG_BACKEND_SYSTICK_MASK;
+    systick_last = now;
+    return systick_cycles;
+#else
+    return DWT->CYCCNT;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_init
+********************************************************************************
+* Summary:
+* Initializes and enables the analog reference and the SAR ADC. Must be called
+* once, on the core that runs the self tests, before any other function of
+* the analog backend. It does not wait for the reference to settle: the
+* caller can do other init work meanwhile and check
+* analog_backend_ref_settle_us before the first conversion. Starts the time
+* base if it is not running yet.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  OK_STATUS on success, ERROR_STATUS otherwise
+*
+*******************************************************************************/
+uint8_t analog_backend_init(void)
+{
+    analog_backend_time_init();
+
+#if COMPONENT_CAT1A
+    /* Init AREF */
+    if (CY_SYSANALOG_SUCCESS != Cy_SysAnalog_Init(&self_test_aref_0_config))
+    {
+        return ERROR_STATUS;
+    }
+    Cy_SysAnalog_Enable();
+
+    /* Initialize SAR ADC */
+    if (CY_SAR_SUCCESS != Cy_SAR_Init(CYBSP_DUT_SAR_ADC_HW, &CYBSP_DUT_SAR_ADC_config))
+    {
+        return ERROR_STATUS;
+    }
+    Cy_SAR_Enable(CYBSP_DUT_SAR_ADC_HW);
+
+#elif COMPONENT_CAT1C
+    /* Initialize the SAR2 module */
+    if (CY_SAR2_SUCCESS != Cy_SAR2_Init(CYBSP_DUT_SAR_ADC_HW, &CYBSP_DUT_SAR_ADC_config))
+    {
+        return ERROR_STATUS;
+    }
+    /* Set ePASS MMIO reference buffer mode for bangap voltage */
+    Cy_SAR2_SetReferenceBufferMode(PASS0_EPASS_MMIO, CY_SAR2_REF_BUF_MODE_ON);
+#endif
+    ref_start_us = analog_backend_time_us();
+
+    return OK_STATUS;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_ref_settle_us
+********************************************************************************
+* Summary:
+* Returns the time left until the analog reference enabled by
+* analog_backend_init has settled, ANALOG_BACKEND_REF_SETTLE_US after it was
+* enabled.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  Remaining settling time in microseconds, 0 once the reference has settled
+*
+*******************************************************************************/
+uint32_t analog_backend_ref_settle_us(void)
+{
+    uint32_t elapsed = analog_backend_time_us() - ref_start_us;
+
+    return (elapsed < ANALOG_BACKEND_REF_SETTLE_US) ?
+            (ANALOG_BACKEND_REF_SETTLE_US - elapsed) : 0u;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_time_init
+********************************************************************************
+* Summary:
+* Enables the CPU cycle counter used as the time base of the self tests.
+* Calling it again has no effect, so the time base and the CPU cycle counter
+* run on from the first call and time stamps taken before a later call stay
+* valid.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_time_init(void)
+{
+    if (time_started)
+    {
+        return;
+    }
+
+#if (CY_CPU_CORTEX_M0P)
+    SysTick->LOAD = ANALOG_BACKEND_SYSTICK_MASK;
+    SysTick->VAL = 0u;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    systick_last = 0u;
+    systick_cycles = 0u;
+#else
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0u;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    time_last_cycles = 0u;
+    time_us = 0u;
+    time_rem_cycles = 0u;
+    time_started = true;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_time_us
+********************************************************************************
+* Summary:
+* Returns a free running microsecond counter. The cycle counter wraps after
+* 2^32 CPU cycles, so this function must be called at least once per wrap
+* period (about 28 s at 150 MHz).
+*
+* Parameters:
+*  none
+*
+* Return :
+*  Time in microseconds, wrapping at 2^32
+*
+*******************************************************************************/
+uint32_t analog_backend_time_us(void)
+{
+    uint32_t cycles_per_us = SystemCoreClock / 1000000u;
+    uint32_t now = analog_backend_cycles();
+    uint64_t elapsed = (uint64_t)(now - time_last_cycles) + time_rem_cycles;
+
+    time_last_cycles = now;
+    time_us += (uint32_t)(elapsed / cycles_per_us);
+    time_rem_cycles = (uint32_t)(elapsed % cycles_per_us);
+
+    return time_us;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_cpu_ticks
+********************************************************************************
+* Summary:
+* Returns the CPU cycle counter, for measuring short code sections.
+* analog_backend_time_init must have been called.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  CPU cycles, wrapping at 2^32
+*
+*******************************************************************************/
+uint32_t analog_backend_cpu_ticks(void)
+{
+    return analog_backend_cycles();
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_cpu_ticks_per_us
+********************************************************************************
+* Summary:
+* Returns the rate of analog_backend_cpu_ticks.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  CPU cycles per microsecond
+*
+*******************************************************************************/
+uint32_t analog_backend_cpu_ticks_per_us(void)
+{
+    return SystemCoreClock / 1000000u;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_delay_us
+********************************************************************************
+* Summary:
+* Busy-waits for the given time.
+*
+* Parameters:
+*  us : Time to wait in microseconds, at most 65535
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_delay_us(uint32_t us)
+{
+    Cy_SysLib_DelayUs((uint16_t)us);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_deep_sleep
+********************************************************************************
+* Summary:
+* Puts the core into deep sleep until the low-power timer expires after the
+* given time or another wake-up source fires, such as the comparator
+* supervisor. The debug UART is drained first so that no output is lost. The
+* CPU cycle counter stops in deep sleep, so the slept time measured on the
+* low-power timer is added to the microsecond time base.
+*
+* Parameters:
+*  duration_us : Longest time to sleep in microseconds
+*
+* Return :
+*  Reason the core woke up
+*
+*******************************************************************************/
+analog_wake_t analog_backend_deep_sleep(uint32_t duration_us)
+{
+    uint32_t ticks = (uint32_t)(((uint64_t)duration_us * ANALOG_BACKEND_LPTIMER_HZ) / 1000000u);
+    uint32_t start;
+    uint32_t slept;
+
+    if (!lp_timer_ready)
+    {
+        if (CY_RSLT_SUCCESS != cyhal_lptimer_init(&lp_timer))
+        {
+            CY_ASSERT(0);
+        }
+        cyhal_lptimer_enable_event(&lp_timer, CYHAL_LPTIMER_COMPARE_MATCH,
+                ANALOG_BACKEND_LPTIMER_PRIORITY, true);
+        lp_timer_ready = true;
+    }
+
+#if SELF_TEST_HAS_COMPARATOR
+    if (comp_wake_pending)
+    {
+        comp_wake_pending = false;
+        return ANALOG_WAKE_COMPARATOR;
+    }
+#endif
+    if (0u == ticks)
+    {
+        return ANALOG_WAKE_TIMER;
+    }
+
+    (void)cy_retarget_io_wait_tx_complete(&cy_retarget_io_uart_obj,
+            ANALOG_BACKEND_UART_FLUSH_MS);
+
+    /* Bring the time base up to date before the cycle counter stops */
+    (void)analog_backend_time_us();
+    start = cyhal_lptimer_read(&lp_timer);
+    (void)cyhal_lptimer_set_delay(&lp_timer, ticks);
+    (void)cyhal_syspm_deepsleep();
+    slept = cyhal_lptimer_read(&lp_timer) - start;
+
+    time_last_cycles = analog_backend_cycles();
+    time_us += (uint32_t)(((uint64_t)slept * 1000000u) / ANALOG_BACKEND_LPTIMER_HZ);
+
+#if SELF_TEST_HAS_COMPARATOR
+    if (comp_wake_pending)
+    {
+        comp_wake_pending = false;
+        return ANALOG_WAKE_COMPARATOR;
+    }
+#endif
+    return (slept >= ticks) ? ANALOG_WAKE_TIMER : ANALOG_WAKE_OTHER;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_selftest
+********************************************************************************
+* Summary:
+* Runs the Safety Test Library ADC test on CYBSP_DUT_SAR_ADC_HW. The result is
+* converted to millivolts before it is compared against the expected value.
+*
+* Parameters:
+*  channel      : SAR channel the reference voltage is connected to
+*  expected_res : Expected result in millivolts
+*  accuracy     : Allowed deviation from expected_res in millivolts
+*  vbg_channel  : SAR channel the bandgap voltage is connected to
+*
+* Return :
+*  OK_STATUS if the test passed, ERROR_STATUS otherwise
+*
+*******************************************************************************/
+uint8_t analog_backend_adc_selftest(uint32_t channel, int16_t expected_res,
+        int16_t accuracy, uint32_t vbg_channel)
+{
+    return SelfTests_ADC(CYBSP_DUT_SAR_ADC_HW, channel, expected_res, accuracy,
+            vbg_channel, 1);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_start
+********************************************************************************
+* Summary:
+* Starts a single conversion of one SAR channel and returns immediately.
+*
+* Parameters:
+*  channel : SAR channel to convert
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_adc_start(uint32_t channel)
+{
+    adc_pending_channel = channel;
+
+#if COMPONENT_CAT1A
+    Cy_SAR_SetChanMask(CYBSP_DUT_SAR_ADC_HW, 1uL << channel);
+    Cy_SAR_StartConvert(CYBSP_DUT_SAR_ADC_HW, CY_SAR_START_CONVERT_SINGLE_SHOT);
+#elif COMPONENT_CAT1C
+    Cy_SAR2_Channel_ClearInterrupt(CYBSP_DUT_SAR_ADC_HW, channel, CY_SAR2_INT_GRP_DONE);
+    Cy_SAR2_Channel_SoftwareTrigger(CYBSP_DUT_SAR_ADC_HW, channel);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_is_done
+********************************************************************************
+* Summary:
+* Checks, without waiting, whether the conversion started by
+* analog_backend_adc_start has completed.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  true if the result is available
+*
+*******************************************************************************/
+bool analog_backend_adc_is_done(void)
+{
+#if COMPONENT_CAT1A
+    return (CY_SAR_SUCCESS ==
+            Cy_SAR_IsEndConversion(CYBSP_DUT_SAR_ADC_HW, CY_SAR_RETURN_STATUS));
+#elif COMPONENT_CAT1C
+    return (0u != (Cy_SAR2_Channel_GetInterruptStatus(CYBSP_DUT_SAR_ADC_HW,
+            adc_pending_channel) & CY_SAR2_INT_GRP_DONE));
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_stop
+********************************************************************************
+* Summary:
+* Abandons the conversion started by analog_backend_adc_start, e.g. after it
+* timed out, so that the next conversion starts on an idle SAR.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_adc_stop(void)
+{
+#if COMPONENT_CAT1A
+    Cy_SAR_StopConvert(CYBSP_DUT_SAR_ADC_HW);
+#elif COMPONENT_CAT1C
+    Cy_SAR2_Channel_Disable(CYBSP_DUT_SAR_ADC_HW, adc_pending_channel);
+    Cy_SAR2_Channel_ClearInterrupt(CYBSP_DUT_SAR_ADC_HW, adc_pending_channel,
+            CY_SAR2_INT_GRP_DONE);
+    Cy_SAR2_Channel_Enable(CYBSP_DUT_SAR_ADC_HW, adc_pending_channel);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_scan
+********************************************************************************
+* Summary:
+* Converts a set of SAR channels and waits for the results. On CAT1A devices
+* all channels are converted in one scan of the sequencer; on CAT1C devices
+* the SAR2 channels are triggered one after the other. The wait is bounded by
+* ANALOG_BACKEND_SAR_TIMEOUT_US, after which the results read 0.
+*
+* Parameters:
+*  channels : SAR channels to convert
+*  count    : Number of channels
+*  counts   : Returns the raw results, in the order of channels
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_adc_scan(const uint32_t *channels, uint32_t count,
+        int16_t *counts)
+{
+    uint32_t start;
+    uint32_t i;
+#if COMPONENT_CAT1A
+    uint32_t chan_mask = 0u;
+
+    for (i = 0u; i < count; i++)
+    {
+        chan_mask |= 1uL << channels[i];
+    }
+
+    Cy_SAR_SetChanMask(CYBSP_DUT_SAR_ADC_HW, chan_mask);
+    Cy_SAR_StartConvert(CYBSP_DUT_SAR_ADC_HW, CY_SAR_START_CONVERT_SINGLE_SHOT);
+    start = analog_backend_time_us();
+    while (!analog_backend_adc_is_done())
+    {
+        if ((analog_backend_time_us() - start) >= ANALOG_BACKEND_SAR_TIMEOUT_US)
+        {
+            Cy_SAR_StopConvert(CYBSP_DUT_SAR_ADC_HW);
+            (void)memset(counts, 0, count * sizeof(counts[0]));
+            return;
+        }
+    }
+
+    for (i = 0u; i < count; i++)
+    {
+        counts[i] = Cy_SAR_GetResult16(CYBSP_DUT_SAR_ADC_HW, channels[i]);
+    }
+#elif COMPONENT_CAT1C
+    for (i = 0u; i < count; i++)
+    {
+        counts[i] = 0;
+        Cy_SAR2_Channel_ClearInterrupt(CYBSP_DUT_SAR_ADC_HW, channels[i], CY_SAR2_INT_GRP_DONE);
+        Cy_SAR2_Channel_SoftwareTrigger(CYBSP_DUT_SAR_ADC_HW, channels[i]);
+        start = analog_backend_time_us();
+        while (0u == (Cy_SAR2_Channel_GetInterruptStatus(CYBSP_DUT_SAR_ADC_HW,
+                channels[i]) & CY_SAR2_INT_GRP_DONE))
+        {
+            if ((analog_backend_time_us() - start) >= ANALOG_BACKEND_SAR_TIMEOUT_US)
+            {
+                break;
+            }
+        }
+        if (0u != (Cy_SAR2_Channel_GetInterruptStatus(CYBSP_DUT_SAR_ADC_HW,
+                channels[i]) & CY_SAR2_INT_GRP_DONE))
+        {
+            counts[i] = (int16_t)Cy_SAR2_Channel_GetResult(CYBSP_DUT_SAR_ADC_HW,
+                    channels[i], NULL);
+        }
+        Cy_SAR2_Channel_ClearInterrupt(CYBSP_DUT_SAR_ADC_HW, channels[i], CY_SAR2_INT_GRP_DONE);
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_async_start
+********************************************************************************
+* Summary:
+* Starts the conversion of a set of SAR channels and returns immediately. When
+* the last channel has been converted, the raw results are stored in counts (in
+* the order of channels) and done_cb is invoked from the interrupt. The buffers
+* must stay valid until then.
+*
+* Parameters:
+*  channels : SAR channels to convert
+*  count    : Number of channels
+*  counts   : Buffer for the raw results, count entries
+*  done_cb  : Completion callback, invoked in interrupt context
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_adc_async_start(const uint32_t *channels, uint32_t count,
+        int16_t *counts, analog_adc_done_cb_t done_cb)
+{
+    uint32_t i;
+#if COMPONENT_CAT1A
+    uint32_t chan_mask = 0u;
+#endif
+
+    async_channels = channels;
+    async_count = count;
+    async_counts = counts;
+    async_done_cb = done_cb;
+
+#if COMPONENT_CAT1A
+    if (!async_irq_ready)
+    {
+        const cy_stc_sysint_t irq_cfg =
+        {
+#if (CY_CPU_CORTEX_M0P)
+            .intrSrc = ANALOG_BACKEND_SAR_CM0P_IRQ,
+            .cm0pSrc = CYBSP_DUT_SAR_ADC_IRQ,
+#else
+            .intrSrc = CYBSP_DUT_SAR_ADC_IRQ,
+#endif
+            .intrPriority = ANALOG_BACKEND_SAR_IRQ_PRIORITY
+        };
+
+        (void)Cy_SysInt_Init(&irq_cfg, analog_backend_sar_isr);
+        NVIC_EnableIRQ(irq_cfg.intrSrc);
+        async_irq_ready = true;
+    }
+
+    for (i = 0u; i < count; i++)
+    {
+        chan_mask |= 1uL << channels[i];
+    }
+
+    Cy_SAR_SetChanMask(CYBSP_DUT_SAR_ADC_HW, chan_mask);
+    Cy_SAR_ClearInterrupt(CYBSP_DUT_SAR_ADC_HW, CY_SAR_INTR_EOS);
+    Cy_SAR_SetInterruptMask(CYBSP_DUT_SAR_ADC_HW, CY_SAR_INTR_EOS);
+    Cy_SAR_StartConvert(CYBSP_DUT_SAR_ADC_HW, CY_SAR_START_CONVERT_SINGLE_SHOT);
+#elif COMPONENT_CAT1C
+    for (i = 0u; i < count; i++)
+    {
+        if (0u == (async_irq_ready_mask & (1uL << channels[i])))
+        {
+            /* All channel interrupts share one CPU interrupt */
+            const cy_stc_sysint_t irq_cfg =
+            {
+                .intrSrc = ((uint32_t)ANALOG_BACKEND_SAR2_CPU_IRQ << CY_SYSINT_INTRSRC_MUXIRQ_SHIFT) |
+                        ((uint32_t)pass_0_interrupts_sar_0_IRQn + channels[i]),
+                .intrPriority = ANALOG_BACKEND_SAR_IRQ_PRIORITY
+            };
+
+            (void)Cy_SysInt_Init(&irq_cfg, analog_backend_sar_isr);
+            async_irq_ready_mask |= 1uL << channels[i];
+        }
+    }
+    NVIC_EnableIRQ(ANALOG_BACKEND_SAR2_CPU_IRQ);
+
+    async_index = 0u;
+    Cy_SAR2_Channel_ClearInterrupt(CYBSP_DUT_SAR_ADC_HW, channels[0], CY_SAR2_INT_GRP_DONE);
+    Cy_SAR2_Channel_SetInterruptMask(CYBSP_DUT_SAR_ADC_HW, channels[0], CY_SAR2_INT_GRP_DONE);
+    Cy_SAR2_Channel_SoftwareTrigger(CYBSP_DUT_SAR_ADC_HW, channels[0]);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_async_cancel
+********************************************************************************
+* Summary:
+* Abandons the asynchronous conversion in progress; its callback is not
+* invoked.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_adc_async_cancel(void)
+{
+#if COMPONENT_CAT1A
+    Cy_SAR_SetInterruptMask(CYBSP_DUT_SAR_ADC_HW, 0u);
+    Cy_SAR_ClearInterrupt(CYBSP_DUT_SAR_ADC_HW, CY_SAR_INTR_EOS);
+#elif COMPONENT_CAT1C
+    if (async_index < async_count)
+    {
+        Cy_SAR2_Channel_SetInterruptMask(CYBSP_DUT_SAR_ADC_HW,
+                async_channels[async_index], 0u);
+    }
+    async_index = async_count;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_counts_to_mv
+********************************************************************************
+* Summary:
+* Converts a raw result of a SAR channel to millivolts.
+*
+* Parameters:
+*  channel : SAR channel the result was taken from
+*  counts  : Raw result
+*
+* Return :
+*  Result in millivolts
+*
+*******************************************************************************/
+int32_t analog_backend_adc_counts_to_mv(uint32_t channel, int16_t counts)
+{
+#if COMPONENT_CAT1A
+    return (int32_t)Cy_SAR_CountsTo_mVolts(CYBSP_DUT_SAR_ADC_HW, channel, counts);
+#elif COMPONENT_CAT1C
+    (void)channel;
+    return (int32_t)(((uint32_t)(uint16_t)counts * ANALOG_BACKEND_VDDA_MV) /
+            ANALOG_BACKEND_SAR2_FULL_SCALE);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_read_mv
+********************************************************************************
+* Summary:
+* Returns the last conversion result of a SAR channel in millivolts.
+*
+* Parameters:
+*  channel : SAR channel
+*
+* Return :
+*  Result in millivolts
+*
+*******************************************************************************/
+int32_t analog_backend_adc_read_mv(uint32_t channel)
+{
+#if COMPONENT_CAT1A
+    int16_t counts = Cy_SAR_GetResult16(CYBSP_DUT_SAR_ADC_HW, channel);
+
+    return (int32_t)Cy_SAR_CountsTo_mVolts(CYBSP_DUT_SAR_ADC_HW, channel, counts);
+#elif COMPONENT_CAT1C
+    uint16_t counts = Cy_SAR2_Channel_GetResult(CYBSP_DUT_SAR_ADC_HW, channel, NULL);
+
+    Cy_SAR2_Channel_ClearInterrupt(CYBSP_DUT_SAR_ADC_HW, channel, CY_SAR2_INT_GRP_DONE);
+    return (int32_t)(((uint32_t)counts * ANALOG_BACKEND_VDDA_MV) /
+            ANALOG_BACKEND_SAR2_FULL_SCALE);
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_nv_page
+********************************************************************************
+* Summary:
+* Returns a page of the result store. The flash is memory mapped, so the page
+* is read in place.
+*
+* Parameters:
+*  page : Page, below ANALOG_BACKEND_NV_PAGES
+*
+* Return :
+*  ANALOG_BACKEND_NV_PAGE_SIZE bytes of the page, NULL on the CM0+
+*
+*******************************************************************************/
+const uint8_t *analog_backend_nv_page(uint32_t page)
+{
+#if (CY_CPU_CORTEX_M0P)
+    (void)page;
+    return NULL;
+#else
+    return &nv_region[page * ANALOG_BACKEND_NV_PAGE_SIZE];
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_nv_write
+********************************************************************************
+* Summary:
+* Starts rewriting a page of the result store. The write runs in the
+* background: its sectors are erased and its program pages programmed one at a
+* time, each started by analog_backend_nv_busy once the previous one has
+* completed, so no call waits on the flash.
+*
+* Parameters:
+*  page : Page, below ANALOG_BACKEND_NV_PAGES
+*  data : ANALOG_BACKEND_NV_PAGE_SIZE bytes, word aligned, to be kept unchanged
+*         until the write has completed
+*
+* Return :
+*  true if the write was started, false if a write is in progress or the
+*  flash is not available
+*
+*******************************************************************************/
+bool analog_backend_nv_write(uint32_t page, const uint8_t *data)
+{
+#if (CY_CPU_CORTEX_M0P)
+    (void)page;
+    (void)data;
+    return false;
+#else
+    cyhal_flash_info_t info;
+    uint32_t addr = (uint32_t)&nv_region[page * ANALOG_BACKEND_NV_PAGE_SIZE];
+    uint32_t i;
+
+    if (NULL != nv_data)
+    {
+        return false;
+    }
+
+    if (!nv_ready)
+    {
+        if (CY_RSLT_SUCCESS != cyhal_flash_init(&nv_flash))
+        {
+            return false;
+        }
+        cyhal_flash_get_info(&nv_flash, &info);
+        for (i = 0u; i < info.block_count; i++)
+        {
+            const cyhal_flash_block_info_t *block = &info.blocks[i];
+
+            if ((addr >= block->start_address) &&
+                (addr < (block->start_address + block->size)))
+            {
+                nv_sector_size = block->sector_size;
+                nv_program_size = block->page_size;
+            }
+        }
+        CY_ASSERT((0u != nv_sector_size) &&
+                  (0u == (ANALOG_BACKEND_NV_PAGE_SIZE % nv_sector_size)));
+        nv_ready = true;
+    }
+
+    nv_data = data;
+    nv_addr = addr;
+    nv_erased = 0u;
+    nv_programmed = 0u;
+    (void)analog_backend_nv_busy();
+
+    return true;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_nv_busy
+********************************************************************************
+* Summary:
+* Advances the page write in progress: once the current flash operation has
+* completed, the next sector erase or page program is started.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  true while the page write is in progress
+*
+*******************************************************************************/
+bool analog_backend_nv_busy(void)
+{
+#if (CY_CPU_CORTEX_M0P)
+    return false;
+#else
+    if (NULL == nv_data)
+    {
+        return false;
+    }
+    if (!cyhal_flash_is_operation_complete(&nv_flash))
+    {
+        return true;
+    }
+
+    if (nv_erased < ANALOG_BACKEND_NV_PAGE_SIZE)
+    {
+        (void)cyhal_flash_start_erase(&nv_flash, nv_addr + nv_erased);
+        nv_erased += nv_sector_size;
+        return true;
+    }
+    if (nv_programmed < ANALOG_BACKEND_NV_PAGE_SIZE)
+    {
+        (void)cyhal_flash_start_program(&nv_flash, nv_addr + nv_programmed,
+                (const uint32_t *)(const void *)&nv_data[nv_programmed]);
+        nv_programmed += nv_program_size;
+        return true;
+    }
+
+    nv_data = NULL;
+    return false;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_wdt_start
+********************************************************************************
+* Summary:
+* Starts the hardware watchdog, or changes its timeout if it runs already.
+*
+* Parameters:
+*  timeout_ms : Time without a kick after which the device is reset
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_wdt_start(uint32_t timeout_ms)
+{
+    if (wdt_ready)
+    {
+        cyhal_wdt_free(&wdt_obj);
+    }
+    if (CY_RSLT_SUCCESS != cyhal_wdt_init(&wdt_obj, timeout_ms))
+    {
+        CY_ASSERT(0);
+    }
+    wdt_ready = true;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_wdt_kick
+********************************************************************************
+* Summary:
+* Restarts the timeout of the hardware watchdog.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_wdt_kick(void)
+{
+    cyhal_wdt_kick(&wdt_obj);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_wdt_caused_reset
+********************************************************************************
+* Summary:
+* Checks whether the watchdog caused the last reset, and clears the reset
+* reason so that it is reported once.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  true after a watchdog reset
+*
+*******************************************************************************/
+bool analog_backend_wdt_caused_reset(void)
+{
+    bool wdt_reset = (0u != ((uint32_t)cyhal_system_get_reset_reason() &
+            (uint32_t)CYHAL_SYSTEM_RESET_WDT));
+
+    cyhal_system_clear_reset_reason();
+    return wdt_reset;
+}
+
+#if SELF_TEST_HAS_COMPARATOR
+/*******************************************************************************
+* Function Name: analog_backend_comp_setup
+********************************************************************************
+* Summary:
+* Initializes and enables the LPCOMP with the device configurator generated
+* structure and configures the comparator input pins for analog operation,
+* routed for ANALOG_COMP_ROUTE_VPLUS_AMUXB. Called once; the test runs only
+* change the routing with analog_backend_comp_route.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_comp_setup(void)
+{
+    cy_en_lpcomp_status_t result;
+    const en_hsiom_sel_t *sel = comp_route_hsiom[ANALOG_COMP_ROUTE_VPLUS_AMUXB];
+
+    result = Cy_LPComp_Init(CYBSP_DUT_LPCOMP_HW, CYBSP_DUT_LPCOMP_CHANNEL,
+            &CYBSP_DUT_LPCOMP_config);
+    if (result != CY_LPCOMP_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+    Cy_LPComp_Enable(CYBSP_DUT_LPCOMP_HW, CYBSP_DUT_LPCOMP_CHANNEL);
+
+    Cy_GPIO_Pin_FastInit(CYBSP_DUT_LPCOMP_VPLUS_PORT, CYBSP_DUT_LPCOMP_VPLUS_PIN,
+            CY_GPIO_DM_ANALOG, 0u, sel[COMP_PIN_VPLUS]);
+    Cy_GPIO_Pin_FastInit(CYBSP_DUT_LPCOMP_VMINUS_PORT, CYBSP_DUT_LPCOMP_VMINUS_PIN,
+            CY_GPIO_DM_ANALOG, 0u, sel[COMP_PIN_VMINUS]);
+    comp_route_current = ANALOG_COMP_ROUTE_VPLUS_AMUXB;
+    comp_channels_ready = 1uL << 0;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_route
+********************************************************************************
+* Summary:
+* Connects the comparator input pins to AMUXBUS A and AMUXBUS B. Only the HSIOM
+* selection of the two pins is written, and only if the routing changes; the
+* drive mode is set once by analog_backend_comp_setup.
+*
+* Parameters:
+*  route : Bus assignment of the VPLUS and VMINUS pins
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_comp_route(analog_comp_route_t route)
+{
+    const en_hsiom_sel_t *sel = comp_route_hsiom[route];
+
+    if (route == comp_route_current)
+    {
+        return;
+    }
+
+    Cy_GPIO_SetHSIOM(CYBSP_DUT_LPCOMP_VPLUS_PORT, CYBSP_DUT_LPCOMP_VPLUS_PIN,
+            sel[COMP_PIN_VPLUS]);
+    Cy_GPIO_SetHSIOM(CYBSP_DUT_LPCOMP_VMINUS_PORT, CYBSP_DUT_LPCOMP_VMINUS_PIN,
+            sel[COMP_PIN_VMINUS]);
+    comp_route_current = route;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_selftest
+********************************************************************************
+* Summary:
+* Runs the Safety Test Library comparator test on CYBSP_DUT_LPCOMP_HW.
+*
+* Parameters:
+*  expected_res : Expected comparator output
+*
+* Return :
+*  OK_STATUS if the test passed, ERROR_STATUS otherwise
+*
+*******************************************************************************/
+uint8_t analog_backend_comp_selftest(uint32_t expected_res)
+{
+    return SelfTests_Comparator(CYBSP_DUT_LPCOMP_HW, CYBSP_DUT_LPCOMP_CHANNEL,
+            expected_res);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_read
+********************************************************************************
+* Summary:
+* Returns the current comparator output.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  1 if the positive input is above the negative input, 0 otherwise
+*
+*******************************************************************************/
+uint32_t analog_backend_comp_read(void)
+{
+    return Cy_LPComp_GetCompare(CYBSP_DUT_LPCOMP_HW, CYBSP_DUT_LPCOMP_CHANNEL);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_connect
+********************************************************************************
+* Summary:
+* Connects the inputs of the given comparator channels, in one pass over the
+* channels. Only the input switches that change are written. A channel other
+* than channel 0 is initialized with the configuration of channel 0 the first
+* time it is connected, and the local reference is enabled the first time it
+* is used; both then stay enabled. analog_backend_comp_setup must have been
+* called, and the outputs must be given time to settle before they are read.
+*
+* Parameters:
+*  channel_mask : Channels to connect, bit n for channel n
+*  vplus        : Source of the positive inputs
+*  vminus       : Source of the negative inputs
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_comp_connect(uint32_t channel_mask, analog_comp_input_t vplus,
+        analog_comp_input_t vminus)
+{
+    uint32_t ch;
+
+    if ((ANALOG_COMP_INPUT_VREF == vminus) && !comp_vref_ready)
+    {
+        Cy_LPComp_UlpReferenceEnable(CYBSP_DUT_LPCOMP_HW);
+        comp_vref_ready = true;
+    }
+
+    for (ch = 0u; ch < ANALOG_COMP_CHANNELS; ch++)
+    {
+        if (0u == (channel_mask & (1uL << ch)))
+        {
+            continue;
+        }
+        if (0u == (comp_channels_ready & (1uL << ch)))
+        {
+            (void)Cy_LPComp_Init(CYBSP_DUT_LPCOMP_HW, comp_channels[ch],
+                    &CYBSP_DUT_LPCOMP_config);
+            Cy_LPComp_Enable(CYBSP_DUT_LPCOMP_HW, comp_channels[ch]);
+            comp_channels_ready |= 1uL << ch;
+        }
+        else if ((vplus == comp_inputs_current[ch][COMP_PIN_VPLUS]) &&
+                 (vminus == comp_inputs_current[ch][COMP_PIN_VMINUS]))
+        {
+            continue;
+        }
+        Cy_LPComp_SetInputs(CYBSP_DUT_LPCOMP_HW, comp_channels[ch], comp_input_sw[vplus],
+                comp_input_sw[vminus]);
+        comp_inputs_current[ch][COMP_PIN_VPLUS] = vplus;
+        comp_inputs_current[ch][COMP_PIN_VMINUS] = vminus;
+    }
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_read_channel
+********************************************************************************
+* Summary:
+* Returns the current output of a comparator channel.
+*
+* Parameters:
+*  channel : Channel, below ANALOG_COMP_CHANNELS
+*
+* Return :
+*  1 if the positive input is above the negative input, 0 otherwise
+*
+*******************************************************************************/
+uint32_t analog_backend_comp_read_channel(uint32_t channel)
+{
+    return Cy_LPComp_GetCompare(CYBSP_DUT_LPCOMP_HW, comp_channels[channel]);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_isr
+********************************************************************************
+* Summary:
+* Comparator supervisor interrupt. Masks itself so that a slowly crossing
+* input fires only once per supervision period.
+*
+*******************************************************************************/
+static void analog_backend_comp_isr(void)
+{
+    Cy_LPComp_SetInterruptMask(CYBSP_DUT_LPCOMP_HW, 0u);
+    Cy_LPComp_ClearInterrupt(CYBSP_DUT_LPCOMP_HW, COMP_INTR_MASK);
+    comp_wake_pending = true;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_supervise
+********************************************************************************
+* Summary:
+* Starts or stops supervising the comparator input. While supervising, the
+* comparator stays routed for normal operation (VPLUS on AMUXBUS B) and keeps
+* running in deep sleep; a rising edge of its output, meaning the input
+* crossed the threshold, wakes the core and ends analog_backend_deep_sleep
+* with ANALOG_WAKE_COMPARATOR. analog_backend_comp_setup must have been
+* called. The comparator tests change the routing, so supervision must be
+* stopped while they run.
+*
+* Parameters:
+*  enable : true to start supervising, false to stop
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_comp_supervise(bool enable)
+{
+    const cy_stc_sysint_t comp_irq_cfg =
+    {
+        .intrSrc = lpcomp_interrupt_IRQn,
+        .intrPriority = ANALOG_BACKEND_COMP_IRQ_PRIORITY
+    };
+
+    if (!enable)
+    {
+        Cy_LPComp_SetInterruptMask(CYBSP_DUT_LPCOMP_HW, 0u);
+        return;
+    }
+
+    if (!comp_supervisor_ready)
+    {
+        (void)Cy_SysInt_Init(&comp_irq_cfg, analog_backend_comp_isr);
+        NVIC_EnableIRQ(comp_irq_cfg.intrSrc);
+        (void)Cy_SysPm_RegisterCallback(&comp_syspm_callback);
+        Cy_LPComp_SetInterruptTriggerMode(CYBSP_DUT_LPCOMP_HW, CYBSP_DUT_LPCOMP_CHANNEL,
+                CY_LPCOMP_INTR_RISING);
+        comp_supervisor_ready = true;
+    }
+
+    analog_backend_comp_route(ANALOG_COMP_ROUTE_VPLUS_AMUXB);
+    Cy_LPComp_ClearInterrupt(CYBSP_DUT_LPCOMP_HW, COMP_INTR_MASK);
+
+    /* An input that is already across the threshold produces no edge */
+    if (ANALOG_COMP_RESULT2 != analog_backend_comp_read())
+    {
+        comp_wake_pending = true;
+    }
+    else
+    {
+        Cy_LPComp_SetInterruptMask(CYBSP_DUT_LPCOMP_HW, COMP_INTR_MASK);
+    }
+}
+#endif
+
+#if SELF_TEST_HAS_OPAMP
+/*******************************************************************************
+* Function Name: analog_backend_opamp_setup
+********************************************************************************
+* Summary:
+* Initializes and enables opamp 0 of the CTB with the device configurator
+* generated opamp structure. The CTB configuration is built once from it, as the
+* generated structure is not a compile-time constant. Called once; the opamp
+* then stays enabled.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_opamp_setup(void)
+{
+    cy_en_ctb_status_t result;
+
+    /* Opamp0 configuration */
+    opamp_ctb_config.oa0Power = CYBSP_DUT_OPAMP_config.oaPower;
+    opamp_ctb_config.oa0Mode = CYBSP_DUT_OPAMP_config.oaMode;
+    opamp_ctb_config.oa0Pump = CYBSP_DUT_OPAMP_config.oaPump;
+    opamp_ctb_config.oa0CompEdge = CYBSP_DUT_OPAMP_config.oaCompEdge;
+    opamp_ctb_config.oa0CompLevel = CYBSP_DUT_OPAMP_config.oaCompLevel;
+    opamp_ctb_config.oa0CompBypass = CYBSP_DUT_OPAMP_config.oaCompBypass;
+    opamp_ctb_config.oa0CompHyst = CYBSP_DUT_OPAMP_config.oaCompHyst;
+    opamp_ctb_config.oa0CompIntrEn = CYBSP_DUT_OPAMP_config.oaCompIntrEn;
+
+    /*Initialize the OPAMP0 with device configurator generated structure*/
+    result = Cy_CTB_Init(CYBSP_DUT_OPAMP_HW, &opamp_ctb_config);
+    if (result != CY_CTB_SUCCESS)
+    {
+        CY_ASSERT(0);
+    }
+    /*Enable Opamp0*/
+    Cy_CTB_Enable(CYBSP_DUT_OPAMP_HW);
+
+    /* Remember the Vplus pin the routing connected, for analog_backend_opamp_input */
+    opamp_pin_switches = Cy_CTB_GetAnalogSwitch(CYBSP_DUT_OPAMP_HW, CY_CTB_SWITCH_OA0_SW) &
+            ((uint32_t)CY_CTB_SW_OA0_POS_PIN0_MASK | (uint32_t)CY_CTB_SW_OA0_POS_PIN6_MASK);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_opamp_selftest
+********************************************************************************
+* Summary:
+* Runs the Safety Test Library opamp test, measuring the opamp output through
+* CYBSP_DUT_SAR_ADC_HW.
+*
+* Parameters:
+*  expected_res : Expected result in millivolts
+*  accuracy     : Allowed deviation from expected_res in millivolts
+*  sar_channel  : SAR channel the opamp output is connected to
+*
+* Return :
+*  OK_STATUS if the test passed, ERROR_STATUS otherwise
+*
+*******************************************************************************/
+uint8_t analog_backend_opamp_selftest(int16_t expected_res, int16_t accuracy,
+        uint32_t sar_channel)
+{
+    return SelfTests_Opamp(CYBSP_DUT_SAR_ADC_HW, expected_res, accuracy,
+            sar_channel, 1);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_opamp_input
+********************************************************************************
+* Summary:
+* Switches the Vplus input of opamp 0 between its input pin and AMUXBUS A,
+* break before make. Switching back to the pin applies a step from the
+* AMUXBUS A level to the reference under test. On AMUXBUS A, the comparator
+* pins are routed so that the VMINUS pin, the higher comparator input, drives
+* the bus.
+*
+* Parameters:
+*  input : New source of the Vplus input
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_backend_opamp_input(analog_opamp_input_t input)
+{
+    if (ANALOG_OPAMP_INPUT_AMUXA == input)
+    {
+#if SELF_TEST_HAS_COMPARATOR
+        analog_backend_comp_route(ANALOG_COMP_ROUTE_VPLUS_AMUXB);
+#endif
+        Cy_CTB_SetAnalogSwitch(CYBSP_DUT_OPAMP_HW, CY_CTB_SWITCH_OA0_SW, opamp_pin_switches,
+                CY_CTB_SWITCH_OPEN);
+        Cy_CTB_SetAnalogSwitch(CYBSP_DUT_OPAMP_HW, CY_CTB_SWITCH_OA0_SW,
+                (uint32_t)CY_CTB_SW_OA0_POS_AMUXBUSA_MASK, CY_CTB_SWITCH_CLOSE);
+    }
+    else
+    {
+        Cy_CTB_SetAnalogSwitch(CYBSP_DUT_OPAMP_HW, CY_CTB_SWITCH_OA0_SW,
+                (uint32_t)CY_CTB_SW_OA0_POS_AMUXBUSA_MASK, CY_CTB_SWITCH_OPEN);
+        Cy_CTB_SetAnalogSwitch(CYBSP_DUT_OPAMP_HW, CY_CTB_SWITCH_OA0_SW, opamp_pin_switches,
+                CY_CTB_SWITCH_CLOSE);
+    }
+}
+#endif
+
+/* [] END OF FILE */
@@ -0,0 +1,155 @@
+/******************************************************************************
+* File Name:   main_cm0p.c
+*
+* Description: This is the CM0+ entry point of the dual-core build
+*              (SELF_TEST_DUAL_CORE). The CM0+ runs the periodic analog self
+*              tests and posts each result to the mailbox published by the
+*              CM4, which keeps the CM4 free for the application. This file
+*              belongs to the CM0+ project of a dual-core application and is
+*              excluded from the single-core build by .cyignore.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "cy_pdl.h"
+#include "cybsp.h"
+#include "self_test.h"
+#include "self_test_sched.h"
+#include "self_test_trace.h"
+#include "self_test_mailbox.h"
+#include "self_test_wdt.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Mailbox published by the CM4 */
+static self_test_mailbox_t *cm0p_mailbox;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void sched_result_cb(self_test_id_t id, uint8_t status, int32_t value);
+
+/*******************************************************************************
+* Function Name: sched_result_cb
+********************************************************************************
+* Summary:
+* Called by the self-test scheduler when a periodic test completes. The result
+* is posted to the CM4 without waiting.
+*
+* Parameters:
+*  id     : Test that completed
+*  status : OK_STATUS if the test passed
+*  value  : Measured value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sched_result_cb(self_test_id_t id, uint8_t status, int32_t value)
+{
+    const self_test_mailbox_msg_t msg =
+    {
+        .time_us = analog_backend_time_us(),
+        .value = value,
+        .id = (uint8_t)id,
+        .status = status,
+    };
+
+    (void)self_test_mailbox_post(cm0p_mailbox, &msg);
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* Starts the CM4, waits once for the mailbox and then runs the self-test
+* scheduler forever.
+*
+* Parameters:
+*  none
+*
+* Return:
+*  int
+*
+*******************************************************************************/
+int main(void)
+{
+    const self_test_sched_config_t sched_config =
+    {
+        .tick_budget_us = SELF_TEST_SCHED_TICK_BUDGET_US,
+        .period_us = SELF_TEST_SCHED_PERIOD_US,
+        .coverage_us = SELF_TEST_SCHED_COVERAGE_US,
+        .max_period_us = SELF_TEST_SCHED_MAX_PERIOD_US,
+        .result_cb = sched_result_cb,
+    };
+
+    /* Enable global interrupts */
+    __enable_irq();
+
+    /* Start the CM4; it publishes the mailbox after the board initialization */
+    Cy_SysEnableCM4(CY_CORTEX_M4_APPL_ADDR);
+    do
+    {
+        cm0p_mailbox = self_test_mailbox_attach();
+    } while (NULL == cm0p_mailbox);
+
+    /* Initialize the AREF and the SAR ADC */
+    if (OK_STATUS != analog_backend_init())
+    {
+        CY_ASSERT(0);
+    }
+
+    /* One-time LPCOMP, input pin and CTB setup for all test runs */
+    self_test_setup();
+    self_test_sched_init(&sched_config);
+
+    /* This core runs the tests, so it owns the watchdog */
+    self_test_wdt_init();
+
+    for (;;)
+    {
+        self_test_sched_tick();
+        self_test_wdt_service();
+
+        /* There is no console on this core; the phase timings are kept in
+         * RAM for the debugger.
+         */
+        self_test_trace_collect();
+    }
+}
+
+/* [] END OF FILE */
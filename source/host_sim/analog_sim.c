@@ -0,0 +1,1051 @@
+/******************************************************************************
+* File Name:   analog_sim.c
+*
+* Description: This file implements the host model of the SAR ADC, LPCOMP and
+*              opamp, and the analog backend on top of it. Conversions take a
+*              configurable amount of simulated time and carry a configurable
+*              offset, noise and injected fault.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include <time.h>
+#include "analog_backend.h"
+#include "wdt_sim.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#define SAR_MAX_COUNT      ((1u << ANALOG_SIM_SAR_RESOLUTION_BITS) - 1u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static analog_sim_config_t sim_config;
+static uint64_t sim_time_us;
+static uint32_t sim_conversions;
+static uint32_t sim_scans;
+static uint32_t sim_noise_state;
+static analog_comp_route_t sim_comp_route;
+static analog_comp_input_t sim_comp_inputs[ANALOG_COMP_CHANNELS][2];
+static bool sim_comp_enabled;
+static bool sim_opamp_enabled;
+static analog_opamp_input_t sim_opamp_input;
+static uint64_t sim_opamp_step_us;
+static int32_t sim_opamp_from_mv;
+static bool sim_comp_supervising;
+static uint64_t sim_asleep_us;
+static uint64_t sim_ref_start_us;
+static uint64_t sim_ref_ready_us;
+static uint64_t sim_adc_done_us;
+static uint16_t sim_adc_result[ANALOG_SIM_SAR_CHANNELS];
+static analog_adc_done_cb_t sim_async_done_cb;
+static uint64_t sim_async_done_us;
+static const uint32_t *sim_async_channels;
+static uint32_t sim_async_count;
+static int16_t *sim_async_counts;
+
+/*******************************************************************************
+* Function Name: sim_noise
+********************************************************************************
+* Summary:
+* Returns uniform noise in the range [-noise_mv, noise_mv] from a xorshift32
+* generator, so that runs are reproducible for a given seed.
+*
+*******************************************************************************/
+static int32_t sim_noise(void)
+{
+    uint32_t x = sim_noise_state;
+    uint32_t span = (2u * sim_config.noise_mv) + 1u;
+
+    if (0u == sim_config.noise_mv)
+    {
+        return 0;
+    }
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    sim_noise_state = x;
+
+    return (int32_t)(x % span) - (int32_t)sim_config.noise_mv;
+}
+
+/*******************************************************************************
+* Function Name: sim_conv_time_us
+********************************************************************************
+* Summary:
+* Returns the duration of one conversion, including an injected stall.
+*
+*******************************************************************************/
+static uint32_t sim_conv_time_us(void)
+{
+    if (ANALOG_SIM_FAULT_SAR_STALL == sim_config.fault)
+    {
+        return sim_config.conv_time_us + (uint32_t)sim_config.fault_param;
+    }
+    return sim_config.conv_time_us;
+}
+
+/*******************************************************************************
+* Function Name: sim_scan_setup
+********************************************************************************
+* Summary:
+* Accounts the setup of a SAR scan: the channel configuration and the start
+* of the sequencer, paid once however many channels the scan converts.
+* Returns its duration.
+*
+*******************************************************************************/
+static uint32_t sim_scan_setup(void)
+{
+    sim_scans++;
+    return sim_config.scan_setup_us;
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_default_config
+********************************************************************************
+* Summary:
+* Fills a configuration for a healthy device: VDDA = 3.3 V, VDDA/3 on channel
+* 0, 2VDDA/3 on channel 2, opamp output on channel 1, AMUXBUS A above AMUXBUS B,
+* both above the comparator reference, an opamp slewing at 100 mV/us that
+* settles with a 2 us half-life, 2 us conversions, 1 us to set up a scan and
+* 20 us peripheral initialization.
+*
+* Parameters:
+*  config : Configuration to fill
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_sim_default_config(analog_sim_config_t *config)
+{
+    (void)memset(config, 0, sizeof(*config));
+
+    config->vdda_mv = 3300u;
+    config->channel_mv[0] = config->vdda_mv / 3u;
+    config->channel_mv[2] = (2u * config->vdda_mv) / 3u;
+    config->amuxa_mv = (2u * config->vdda_mv) / 3u;
+    config->amuxb_mv = config->vdda_mv / 3u;
+    config->comp_vref_mv = 450u;
+    config->opamp_in_mv = config->vdda_mv / 3u;
+    config->opamp_channel = 1u;
+    config->opamp_slew_mv_per_us = 100u;
+    config->opamp_settle_ns = 2000u;
+    config->conv_time_us = 2u;
+    config->scan_setup_us = 1u;
+    config->init_time_us = 20u;
+    config->fault = ANALOG_SIM_FAULT_NONE;
+    config->seed = 0x2545F491u;
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_init
+********************************************************************************
+* Summary:
+* Resets the model, the simulated clock and the peripheral state.
+*
+* Parameters:
+*  config : Model configuration, copied
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_sim_init(const analog_sim_config_t *config)
+{
+    sim_config = *config;
+    sim_time_us = 0u;
+    sim_conversions = 0u;
+    sim_scans = 0u;
+    sim_noise_state = (0u != config->seed) ? config->seed : 1u;
+    sim_comp_route = ANALOG_COMP_ROUTE_VPLUS_AMUXB;
+    (void)memset(sim_comp_inputs, 0, sizeof(sim_comp_inputs));
+    sim_comp_enabled = false;
+    sim_opamp_enabled = false;
+    sim_opamp_input = ANALOG_OPAMP_INPUT_PIN;
+    sim_opamp_step_us = 0u;
+    sim_opamp_from_mv = 0;
+    sim_comp_supervising = false;
+    sim_asleep_us = 0u;
+    sim_ref_start_us = 0u;
+    sim_ref_ready_us = 0u;
+    sim_adc_done_us = 0u;
+    (void)memset(sim_adc_result, 0, sizeof(sim_adc_result));
+    sim_async_done_cb = NULL;
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_reseed
+********************************************************************************
+* Summary:
+* Restarts the noise generator with a new seed without resetting the clock or
+* the peripheral state, so that repeated trials see independent noise.
+*
+*******************************************************************************/
+void analog_sim_reseed(uint32_t seed)
+{
+    sim_config.seed = seed;
+    sim_noise_state = (0u != seed) ? seed : 1u;
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_config
+********************************************************************************
+* Summary:
+* Returns the live model configuration, so that a caller can change inputs or
+* inject a fault between tests.
+*
+*******************************************************************************/
+analog_sim_config_t *analog_sim_config(void)
+{
+    return &sim_config;
+}
+
+/*******************************************************************************
+* Function Name: sim_opamp_output_mv
+********************************************************************************
+* Summary:
+* Returns the opamp output at the current simulated time. After each step of
+* its input, the output ramps at the slew rate while the error is large, then
+* the error halves every opamp_settle_ns, interpolated linearly within each
+* half-life.
+*
+*******************************************************************************/
+static int32_t sim_opamp_output_mv(void)
+{
+    int32_t target = (int32_t)sim_config.opamp_in_mv;
+    uint32_t slew = sim_config.opamp_slew_mv_per_us;
+    uint32_t half_ns = sim_config.opamp_settle_ns;
+    uint64_t dt_ns = (sim_time_us - sim_opamp_step_us) * 1000u;
+    uint32_t err;
+    uint32_t knee;
+    uint64_t ramp_ns;
+    int32_t sign = 1;
+
+    if (!sim_opamp_enabled)
+    {
+        return 0;
+    }
+    if (ANALOG_OPAMP_INPUT_AMUXA == sim_opamp_input)
+    {
+        target = (int32_t)sim_config.amuxa_mv;
+    }
+    if ((ANALOG_SIM_FAULT_OPAMP_SLOW == sim_config.fault) && (sim_config.fault_param > 1))
+    {
+        slew /= (uint32_t)sim_config.fault_param;
+        half_ns *= (uint32_t)sim_config.fault_param;
+    }
+    if ((0u == slew) || (0u == half_ns))
+    {
+        return target;
+    }
+
+    if (target < sim_opamp_from_mv)
+    {
+        sign = -1;
+    }
+    err = (uint32_t)((target - sim_opamp_from_mv) * sign);
+
+    /* Error below which the exponential tail is slower than the slew limit */
+    knee = (slew * half_ns) / 1000u;
+    if (err > knee)
+    {
+        ramp_ns = ((uint64_t)(err - knee) * 1000u) / slew;
+        if (dt_ns < ramp_ns)
+        {
+            return sim_opamp_from_mv + (sign * (int32_t)((slew * dt_ns) / 1000u));
+        }
+        dt_ns -= ramp_ns;
+        err = knee;
+    }
+
+    if ((dt_ns / half_ns) >= 32u)
+    {
+        return target;
+    }
+    err >>= (uint32_t)(dt_ns / half_ns);
+    err -= (uint32_t)(((uint64_t)err * (dt_ns % half_ns)) / (2u * half_ns));
+
+    return target - (sign * (int32_t)err);
+}
+
+/*******************************************************************************
+* Function Name: sim_ref_mv
+********************************************************************************
+* Summary:
+* Returns the SAR reference voltage. After analog_backend_init it ramps up
+* linearly from 0 V and reaches VDDA when it has settled.
+*
+*******************************************************************************/
+static uint32_t sim_ref_mv(void)
+{
+    uint64_t ref_mv;
+
+    if (sim_time_us >= sim_ref_ready_us)
+    {
+        return sim_config.vdda_mv;
+    }
+    ref_mv = (sim_config.vdda_mv * (sim_time_us - sim_ref_start_us)) /
+            (sim_ref_ready_us - sim_ref_start_us);
+
+    return (0u != ref_mv) ? (uint32_t)ref_mv : 1u;
+}
+
+/*******************************************************************************
+* Function Name: sim_sar_sample
+********************************************************************************
+* Summary:
+* Returns the raw SAR code of a channel for the current model state.
+*
+*******************************************************************************/
+static uint16_t sim_sar_sample(uint32_t channel)
+{
+    int32_t mv = 0;
+    int32_t counts;
+
+    sim_conversions++;
+
+    if (ANALOG_SIM_FAULT_ADC_STUCK == sim_config.fault)
+    {
+        return (uint16_t)((uint32_t)sim_config.fault_param & SAR_MAX_COUNT);
+    }
+
+    if (channel < ANALOG_SIM_SAR_CHANNELS)
+    {
+        mv = (int32_t)sim_config.channel_mv[channel];
+    }
+
+    if (channel == sim_config.opamp_channel)
+    {
+        mv = 0;
+        if (sim_opamp_enabled)
+        {
+            mv = sim_opamp_output_mv();
+            if (ANALOG_SIM_FAULT_OPAMP_OFFSET == sim_config.fault)
+            {
+                mv += sim_config.fault_param;
+            }
+        }
+    }
+
+    if (ANALOG_SIM_FAULT_REF_DRIFT == sim_config.fault)
+    {
+        mv += sim_config.fault_param;
+    }
+
+    mv += sim_config.offset_mv + sim_noise();
+
+    counts = (int32_t)(((int64_t)mv * (int64_t)(SAR_MAX_COUNT + 1u)) /
+            (int64_t)sim_ref_mv());
+    if (counts < 0)
+    {
+        counts = 0;
+    }
+    else if (counts > (int32_t)SAR_MAX_COUNT)
+    {
+        counts = (int32_t)SAR_MAX_COUNT;
+    }
+
+    return (uint16_t)counts;
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_sar_convert
+********************************************************************************
+* Summary:
+* Performs one blocking conversion of a SAR channel and advances the simulated
+* clock by the configured conversion time.
+*
+* Parameters:
+*  channel : SAR channel
+*
+* Return :
+*  Raw SAR code
+*
+*******************************************************************************/
+uint16_t analog_sim_sar_convert(uint32_t channel)
+{
+    /* The SAR is owned by a pending interrupt driven conversion */
+    CY_ASSERT(NULL == sim_async_done_cb);
+    analog_sim_advance_us(sim_conv_time_us());
+
+    return sim_sar_sample(channel);
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_sar_counts_to_mv
+********************************************************************************
+* Summary:
+* Converts a raw SAR code to millivolts using the modelled reference.
+*
+*******************************************************************************/
+int32_t analog_sim_sar_counts_to_mv(uint16_t counts)
+{
+    return (int32_t)(((uint32_t)counts * sim_config.vdda_mv) /
+            (SAR_MAX_COUNT + 1u));
+}
+
+/*******************************************************************************
+* Function Name: sim_comp_input_mv
+********************************************************************************
+* Summary:
+* Returns the voltage on one input of a comparator channel. The input pins of
+* channel 0 take the voltage of the bus they are routed to; the pins of
+* channel 1 are not connected.
+*
+*******************************************************************************/
+static int32_t sim_comp_input_mv(uint32_t channel, uint32_t pin)
+{
+    switch (sim_comp_inputs[channel][pin])
+    {
+        case ANALOG_COMP_INPUT_AMUXA:
+            if ((0u == channel) && (ANALOG_SIM_FAULT_COMP_SWITCH_OPEN == sim_config.fault))
+            {
+                return 0;
+            }
+            return (int32_t)sim_config.amuxa_mv;
+
+        case ANALOG_COMP_INPUT_AMUXB:
+            return (int32_t)sim_config.amuxb_mv;
+
+        case ANALOG_COMP_INPUT_VREF:
+            return (int32_t)sim_config.comp_vref_mv;
+
+        default:
+            break;
+    }
+
+    if (0u != channel)
+    {
+        return 0;
+    }
+    /* Pin 0 is VPLUS: on AMUXBUS B for ANALOG_COMP_ROUTE_VPLUS_AMUXB */
+    if ((ANALOG_COMP_ROUTE_VPLUS_AMUXA == sim_comp_route) == (0u == pin))
+    {
+        return (int32_t)sim_config.amuxa_mv;
+    }
+    return (int32_t)sim_config.amuxb_mv;
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_comp_channel_output
+********************************************************************************
+* Summary:
+* Returns the output of a comparator channel for its current inputs.
+*
+*******************************************************************************/
+uint32_t analog_sim_comp_channel_output(uint32_t channel)
+{
+    if (0u == channel)
+    {
+        if (ANALOG_SIM_FAULT_COMP_STUCK_HIGH == sim_config.fault)
+        {
+            return 1u;
+        }
+        if (ANALOG_SIM_FAULT_COMP_STUCK_LOW == sim_config.fault)
+        {
+            return 0u;
+        }
+    }
+    else if (ANALOG_SIM_FAULT_COMP_AUX_STUCK == sim_config.fault)
+    {
+        return (0 != sim_config.fault_param) ? 1u : 0u;
+    }
+    if (!sim_comp_enabled)
+    {
+        return 0u;
+    }
+
+    return ((sim_comp_input_mv(channel, 0u) + sim_noise()) >
+            sim_comp_input_mv(channel, 1u)) ? 1u : 0u;
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_comp_output
+********************************************************************************
+* Summary:
+* Returns the output of comparator channel 0, the one under test.
+*
+*******************************************************************************/
+uint32_t analog_sim_comp_output(void)
+{
+    return analog_sim_comp_channel_output(0u);
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_time_us
+********************************************************************************
+* Summary:
+* Returns the simulated time in microseconds since analog_sim_init.
+*
+*******************************************************************************/
+uint64_t analog_sim_time_us(void)
+{
+    return sim_time_us;
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_advance_us
+********************************************************************************
+* Summary:
+* Advances the simulated clock, e.g. to model a settling delay or application
+* work. A pending asynchronous conversion that completes in this interval
+* invokes its completion callback, as the interrupt would, and the modelled
+* watchdog resets the device if it expired.
+*
+*******************************************************************************/
+void analog_sim_advance_us(uint32_t us)
+{
+    sim_time_us += us;
+
+    if ((NULL != sim_async_done_cb) && (sim_time_us >= sim_async_done_us))
+    {
+        analog_adc_done_cb_t done_cb = sim_async_done_cb;
+        uint32_t i;
+
+        sim_async_done_cb = NULL;
+        for (i = 0u; i < sim_async_count; i++)
+        {
+            sim_async_counts[i] = (int16_t)sim_sar_sample(sim_async_channels[i]);
+        }
+        done_cb();
+    }
+
+    wdt_sim_poll();
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_conversions
+********************************************************************************
+* Summary:
+* Returns the number of SAR conversions performed since analog_sim_init.
+*
+*******************************************************************************/
+uint32_t analog_sim_conversions(void)
+{
+    return sim_conversions;
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_scans
+********************************************************************************
+* Summary:
+* Returns the number of SAR scans set up since analog_sim_init.
+*
+*******************************************************************************/
+uint32_t analog_sim_scans(void)
+{
+    return sim_scans;
+}
+
+/*******************************************************************************
+* Function Name: analog_sim_asleep_us
+********************************************************************************
+* Summary:
+* Returns the simulated time spent in analog_backend_deep_sleep.
+*
+*******************************************************************************/
+uint64_t analog_sim_asleep_us(void)
+{
+    return sim_asleep_us;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_init
+********************************************************************************
+* Summary:
+* The model is configured by analog_sim_init. Enabling the reference starts
+* its settling, ANALOG_BACKEND_REF_SETTLE_US or fault_param times that with
+* an injected slow reference.
+*
+*******************************************************************************/
+uint8_t analog_backend_init(void)
+{
+    uint64_t settle_us = ANALOG_BACKEND_REF_SETTLE_US;
+
+    if ((ANALOG_SIM_FAULT_REF_SLOW == sim_config.fault) && (sim_config.fault_param > 0))
+    {
+        settle_us *= (uint32_t)sim_config.fault_param;
+    }
+    sim_ref_start_us = sim_time_us;
+    sim_ref_ready_us = sim_time_us + settle_us;
+
+    return OK_STATUS;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_ref_settle_us
+********************************************************************************
+* Summary:
+* Host model of the settling time check. As on the device, it only knows the
+* settling time budget, not the modelled reference.
+*
+*******************************************************************************/
+uint32_t analog_backend_ref_settle_us(void)
+{
+    uint64_t elapsed = sim_time_us - sim_ref_start_us;
+
+    return (elapsed < ANALOG_BACKEND_REF_SETTLE_US) ?
+            (uint32_t)(ANALOG_BACKEND_REF_SETTLE_US - elapsed) : 0u;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_time_init
+********************************************************************************
+* Summary:
+* The host time base is the simulated clock, nothing to initialize.
+*
+*******************************************************************************/
+void analog_backend_time_init(void)
+{
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_time_us
+********************************************************************************
+* Summary:
+* Returns the simulated clock in microseconds.
+*
+*******************************************************************************/
+uint32_t analog_backend_time_us(void)
+{
+    return (uint32_t)sim_time_us;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_cpu_ticks
+********************************************************************************
+* Summary:
+* Returns the host monotonic clock in nanoseconds, so that CPU cost measured on
+* the host is real host time rather than simulated analog time.
+*
+*******************************************************************************/
+uint32_t analog_backend_cpu_ticks(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)(((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_cpu_ticks_per_us
+********************************************************************************
+* Summary:
+* Returns the rate of analog_backend_cpu_ticks on the host.
+*
+*******************************************************************************/
+uint32_t analog_backend_cpu_ticks_per_us(void)
+{
+    return 1000u;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_delay_us
+********************************************************************************
+* Summary:
+* Host model of a busy wait: advances the simulated clock.
+*
+*******************************************************************************/
+void analog_backend_delay_us(uint32_t us)
+{
+    analog_sim_advance_us(us);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_deep_sleep
+********************************************************************************
+* Summary:
+* Host model of deep sleep. While the comparator is supervised, a comparator
+* output that is already across the threshold wakes the core at once, and a
+* modelled threshold crossing every comp_wake_period_us ends the sleep early.
+* Otherwise the simulated clock advances by the whole duration.
+*
+*******************************************************************************/
+analog_wake_t analog_backend_deep_sleep(uint32_t duration_us)
+{
+    uint64_t start_us = sim_time_us;
+    uint64_t wake_us = sim_time_us + duration_us;
+    analog_wake_t reason = ANALOG_WAKE_TIMER;
+
+    if (sim_comp_supervising)
+    {
+        uint32_t period = sim_config.comp_wake_period_us;
+
+        if (ANALOG_COMP_RESULT2 != analog_sim_comp_output())
+        {
+            return ANALOG_WAKE_COMPARATOR;
+        }
+        if ((0u != period) && ((((sim_time_us / period) + 1u) * period) <= wake_us))
+        {
+            wake_us = ((sim_time_us / period) + 1u) * period;
+            reason = ANALOG_WAKE_COMPARATOR;
+        }
+    }
+
+    analog_sim_advance_us((uint32_t)(wake_us - start_us));
+    sim_asleep_us += wake_us - start_us;
+    return reason;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_selftest
+********************************************************************************
+* Summary:
+* Host model of the Safety Test Library ADC test: sets up a scan, converts
+* the channel and checks the result against expected_res +/- accuracy.
+*
+*******************************************************************************/
+uint8_t analog_backend_adc_selftest(uint32_t channel, int16_t expected_res,
+        int16_t accuracy, uint32_t vbg_channel)
+{
+    int32_t mv;
+
+    analog_sim_advance_us(sim_scan_setup());
+    if (vbg_channel != channel)
+    {
+        (void)analog_sim_sar_convert(vbg_channel);
+    }
+    mv = analog_sim_sar_counts_to_mv(analog_sim_sar_convert(channel));
+
+    if ((mv < ((int32_t)expected_res - accuracy)) ||
+        (mv > ((int32_t)expected_res + accuracy)))
+    {
+        return ERROR_STATUS;
+    }
+
+    return OK_STATUS;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_start
+********************************************************************************
+* Summary:
+* Host model of a single shot conversion start. The result is sampled now and
+* becomes readable once the scan setup and the conversion time have elapsed
+* on the simulated clock.
+*
+*******************************************************************************/
+void analog_backend_adc_start(uint32_t channel)
+{
+    CY_ASSERT(NULL == sim_async_done_cb);
+    /* A conversion that timed out must have been stopped */
+    CY_ASSERT(sim_time_us >= sim_adc_done_us);
+    if (channel < ANALOG_SIM_SAR_CHANNELS)
+    {
+        sim_adc_result[channel] = sim_sar_sample(channel);
+    }
+    sim_adc_done_us = sim_time_us + sim_scan_setup() + sim_conv_time_us();
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_is_done
+********************************************************************************
+* Summary:
+* Host model of the end of conversion status. Polling a conversion that is
+* still running advances the simulated clock by 1 us.
+*
+*******************************************************************************/
+bool analog_backend_adc_is_done(void)
+{
+    if (sim_time_us >= sim_adc_done_us)
+    {
+        return true;
+    }
+
+    /* Each poll of a busy SAR costs simulated time, so polling loops end */
+    analog_sim_advance_us(1u);
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_stop
+********************************************************************************
+* Summary:
+* Host model of abandoning a single shot conversion: the SAR is idle at once.
+*
+*******************************************************************************/
+void analog_backend_adc_stop(void)
+{
+    sim_adc_done_us = sim_time_us;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_read_mv
+********************************************************************************
+* Summary:
+* Host model of the SAR result register, in millivolts.
+*
+*******************************************************************************/
+int32_t analog_backend_adc_read_mv(uint32_t channel)
+{
+    if (channel >= ANALOG_SIM_SAR_CHANNELS)
+    {
+        return 0;
+    }
+
+    return analog_sim_sar_counts_to_mv(sim_adc_result[channel]);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_scan
+********************************************************************************
+* Summary:
+* Host model of a blocking scan of a set of channels.
+*
+*******************************************************************************/
+void analog_backend_adc_scan(const uint32_t *channels, uint32_t count,
+        int16_t *counts)
+{
+    uint32_t i;
+
+    for (i = 0u; i < count; i++)
+    {
+        counts[i] = (int16_t)sim_sar_sample(channels[i]);
+    }
+    analog_sim_advance_us(sim_scan_setup() + (sim_conv_time_us() * count));
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_async_start
+********************************************************************************
+* Summary:
+* Host model of an interrupt driven conversion of a set of channels. The
+* results are sampled and the callback invoked once the simulated clock has
+* advanced past the conversion time of all channels.
+*
+*******************************************************************************/
+void analog_backend_adc_async_start(const uint32_t *channels, uint32_t count,
+        int16_t *counts, analog_adc_done_cb_t done_cb)
+{
+    CY_ASSERT(NULL == sim_async_done_cb);
+    sim_async_channels = channels;
+    sim_async_count = count;
+    sim_async_counts = counts;
+    sim_async_done_us = sim_time_us + sim_scan_setup() +
+            ((uint64_t)sim_conv_time_us() * count);
+    sim_async_done_cb = done_cb;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_async_cancel
+********************************************************************************
+* Summary:
+* Host model of abandoning an asynchronous conversion.
+*
+*******************************************************************************/
+void analog_backend_adc_async_cancel(void)
+{
+    sim_async_done_cb = NULL;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_adc_counts_to_mv
+********************************************************************************
+* Summary:
+* Host model of the SAR counts to millivolts conversion.
+*
+*******************************************************************************/
+int32_t analog_backend_adc_counts_to_mv(uint32_t channel, int16_t counts)
+{
+    (void)channel;
+
+    return analog_sim_sar_counts_to_mv((uint16_t)counts);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_setup
+********************************************************************************
+* Summary:
+* Host model of the one-time LPCOMP and input pin setup.
+*
+*******************************************************************************/
+void analog_backend_comp_setup(void)
+{
+    sim_comp_enabled = true;
+    sim_comp_route = ANALOG_COMP_ROUTE_VPLUS_AMUXB;
+    (void)memset(sim_comp_inputs, 0, sizeof(sim_comp_inputs));
+    analog_sim_advance_us(sim_config.init_time_us);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_route
+********************************************************************************
+* Summary:
+* Host model of the comparator input routing.
+*
+*******************************************************************************/
+void analog_backend_comp_route(analog_comp_route_t route)
+{
+    sim_comp_route = route;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_selftest
+********************************************************************************
+* Summary:
+* Host model of the Safety Test Library comparator test.
+*
+*******************************************************************************/
+uint8_t analog_backend_comp_selftest(uint32_t expected_res)
+{
+    return (uint8_t)((analog_sim_comp_output() == expected_res) ? OK_STATUS : ERROR_STATUS);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_read
+********************************************************************************
+* Summary:
+* Host model of the comparator output register.
+*
+*******************************************************************************/
+uint32_t analog_backend_comp_read(void)
+{
+    return analog_sim_comp_output();
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_connect
+********************************************************************************
+* Summary:
+* Host model of the comparator input switches.
+*
+*******************************************************************************/
+void analog_backend_comp_connect(uint32_t channel_mask, analog_comp_input_t vplus,
+        analog_comp_input_t vminus)
+{
+    uint32_t ch;
+
+    for (ch = 0u; ch < ANALOG_COMP_CHANNELS; ch++)
+    {
+        if (0u != (channel_mask & (1uL << ch)))
+        {
+            sim_comp_inputs[ch][0] = vplus;
+            sim_comp_inputs[ch][1] = vminus;
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_read_channel
+********************************************************************************
+* Summary:
+* Host model of the output register of a comparator channel.
+*
+*******************************************************************************/
+uint32_t analog_backend_comp_read_channel(uint32_t channel)
+{
+    return analog_sim_comp_channel_output(channel);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_comp_supervise
+********************************************************************************
+* Summary:
+* Host model of the comparator supervisor, see analog_backend_deep_sleep.
+*
+*******************************************************************************/
+void analog_backend_comp_supervise(bool enable)
+{
+    if (enable)
+    {
+        sim_comp_route = ANALOG_COMP_ROUTE_VPLUS_AMUXB;
+    }
+    sim_comp_supervising = enable;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_opamp_setup
+********************************************************************************
+* Summary:
+* Host model of the one-time CTB setup. The output starts from 0 V.
+*
+*******************************************************************************/
+void analog_backend_opamp_setup(void)
+{
+    sim_opamp_enabled = true;
+    sim_opamp_input = ANALOG_OPAMP_INPUT_PIN;
+    sim_opamp_step_us = sim_time_us;
+    sim_opamp_from_mv = 0;
+    analog_sim_advance_us(sim_config.init_time_us);
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_opamp_selftest
+********************************************************************************
+* Summary:
+* Host model of the Safety Test Library opamp test: sets up a scan and
+* converts the opamp output.
+*
+*******************************************************************************/
+uint8_t analog_backend_opamp_selftest(int16_t expected_res, int16_t accuracy,
+        uint32_t sar_channel)
+{
+    int32_t mv;
+
+    analog_sim_advance_us(sim_scan_setup());
+    mv = analog_sim_sar_counts_to_mv(analog_sim_sar_convert(sar_channel));
+
+    if ((mv < ((int32_t)expected_res - accuracy)) ||
+        (mv > ((int32_t)expected_res + accuracy)))
+    {
+        return ERROR_STATUS;
+    }
+
+    return OK_STATUS;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_opamp_input
+********************************************************************************
+* Summary:
+* Host model of the Vplus input switches. The output moves from its current
+* level towards the new input, see sim_opamp_output_mv.
+*
+*******************************************************************************/
+void analog_backend_opamp_input(analog_opamp_input_t input)
+{
+    sim_opamp_from_mv = sim_opamp_output_mv();
+    sim_opamp_input = input;
+    sim_opamp_step_us = sim_time_us;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,196 @@
+/******************************************************************************
+* File Name:   analog_sim.h
+*
+* Description: This file is the public interface of analog_sim.c. It models
+*              the SAR ADC, LPCOMP and opamp used by the self tests so that
+*              self_test.c can be built and run as a native host executable.
+*              It also provides the Safety Test Library definitions that the
+*              self tests depend on.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef ANALOG_SIM_H_
+#define ANALOG_SIM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* The host model behaves like a PSoC 6 device with comparator and opamp,
+ * unless the build selects a device family explicitly.
+ */
+#if !defined(COMPONENT_CAT1A) && !defined(COMPONENT_CAT1C)
+    #define COMPONENT_CAT1A                (1)
+    #define CY_DEVICE_PSOC6ABLE2
+#endif
+
+#define CY_ASSERT(x)                       assert(x)
+
+/* Variables keep their values over a modelled reset, see wdt_sim.c */
+#define CY_NOINIT
+
+/* Safety Test Library status codes */
+#ifndef OK_STATUS
+    #define OK_STATUS                      (0u)
+#endif
+#ifndef ERROR_STATUS
+    #define ERROR_STATUS                   (1u)
+#endif
+
+/* Safety Test Library analog thresholds, in millivolts for VDDA = 3.3 V */
+#ifndef ANALOG_ADC_SAR_RESULT1
+    #define ANALOG_ADC_SAR_RESULT1         (1100)
+#endif
+#ifndef ANALOG_ADC_SAR_RESULT2
+    #define ANALOG_ADC_SAR_RESULT2         (2200)
+#endif
+#ifndef ANALOG_ADC_ACURACCY
+    #define ANALOG_ADC_ACURACCY            (100)
+#endif
+#ifndef ANALOG_OPAMP_SAR_RESULT1
+    #define ANALOG_OPAMP_SAR_RESULT1       (1100)
+#endif
+#ifndef ANALOG_OPAMP_SAR_RESULT2
+    #define ANALOG_OPAMP_SAR_RESULT2       (2200)
+#endif
+#ifndef ANALOG_OPAMP_ACURACCY
+    #define ANALOG_OPAMP_ACURACCY          (100)
+#endif
+#ifndef ANALOG_COMP_RESULT1
+    #define ANALOG_COMP_RESULT1            (1u)
+#endif
+#ifndef ANALOG_COMP_RESULT2
+    #define ANALOG_COMP_RESULT2            (0u)
+#endif
+
+/* Number of modelled SAR channels */
+#define ANALOG_SIM_SAR_CHANNELS            (16u)
+
+/* Resolution of the modelled SAR */
+#define ANALOG_SIM_SAR_RESOLUTION_BITS     (12u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Faults that can be injected into the model */
+typedef enum
+{
+    ANALOG_SIM_FAULT_NONE = 0,
+    /* Every conversion returns fault_param as the raw code */
+    ANALOG_SIM_FAULT_ADC_STUCK,
+    /* Every SAR input is shifted by fault_param millivolts */
+    ANALOG_SIM_FAULT_REF_DRIFT,
+    /* Comparator output is stuck at 1 */
+    ANALOG_SIM_FAULT_COMP_STUCK_HIGH,
+    /* Comparator output is stuck at 0 */
+    ANALOG_SIM_FAULT_COMP_STUCK_LOW,
+    /* Opamp output is shifted by fault_param millivolts */
+    ANALOG_SIM_FAULT_OPAMP_OFFSET,
+    /* Output of comparator channel 1 is stuck at fault_param */
+    ANALOG_SIM_FAULT_COMP_AUX_STUCK,
+    /* AMUXBUS A input switch of comparator channel 0 is open, the input
+     * reads 0 mV
+     */
+    ANALOG_SIM_FAULT_COMP_SWITCH_OPEN,
+    /* Every SAR conversion takes fault_param microseconds longer */
+    ANALOG_SIM_FAULT_SAR_STALL,
+    /* Opamp slew rate divided and settling time constant multiplied by
+     * fault_param, as in a CTB losing bias current
+     */
+    ANALOG_SIM_FAULT_OPAMP_SLOW,
+    /* Analog reference settles fault_param times slower than
+     * ANALOG_BACKEND_REF_SETTLE_US after analog_backend_init
+     */
+    ANALOG_SIM_FAULT_REF_SLOW,
+    ANALOG_SIM_FAULT_COUNT
+} analog_sim_fault_t;
+
+/* Model configuration */
+typedef struct
+{
+    uint32_t vdda_mv;                  /* Analog supply and SAR reference */
+    uint32_t channel_mv[ANALOG_SIM_SAR_CHANNELS]; /* Voltage on each input */
+    uint32_t amuxa_mv;                 /* Voltage driven onto AMUXBUS A */
+    uint32_t amuxb_mv;                 /* Voltage driven onto AMUXBUS B */
+    uint32_t comp_vref_mv;             /* Local reference of the comparator */
+    uint32_t opamp_in_mv;              /* Voltage on the opamp Vplus input */
+    uint32_t opamp_channel;            /* SAR channel of the opamp output */
+    uint32_t opamp_slew_mv_per_us;     /* Slew rate of the opamp output */
+    uint32_t opamp_settle_ns;          /* Half-life of the opamp output error
+                                        * once it is below the slew limit */
+    int32_t offset_mv;                 /* Static SAR offset error */
+    uint32_t noise_mv;                 /* Peak uniform noise per conversion */
+    uint32_t conv_time_us;             /* Duration of one conversion */
+    uint32_t scan_setup_us;            /* Channel setup and start of a scan,
+                                        * paid once per scan */
+    uint32_t init_time_us;             /* Duration of a LPCOMP or CTB init */
+    uint32_t comp_wake_period_us;      /* Interval of threshold crossings seen
+                                        * by the comparator supervisor, 0 for
+                                        * none */
+    analog_sim_fault_t fault;          /* Injected fault */
+    int32_t fault_param;               /* Fault magnitude, see fault */
+    uint32_t seed;                     /* Noise generator seed */
+} analog_sim_config_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void analog_sim_default_config(analog_sim_config_t *config);
+void analog_sim_init(const analog_sim_config_t *config);
+analog_sim_config_t *analog_sim_config(void);
+void analog_sim_reseed(uint32_t seed);
+
+uint16_t analog_sim_sar_convert(uint32_t channel);
+int32_t analog_sim_sar_counts_to_mv(uint16_t counts);
+uint32_t analog_sim_comp_output(void);
+uint32_t analog_sim_comp_channel_output(uint32_t channel);
+
+uint64_t analog_sim_time_us(void);
+void analog_sim_advance_us(uint32_t us);
+uint32_t analog_sim_conversions(void);
+uint32_t analog_sim_scans(void);
+uint64_t analog_sim_asleep_us(void);
+
+#endif /* ANALOG_SIM_H_ */
+
+/* [] END OF FILE */
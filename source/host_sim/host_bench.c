@@ -0,0 +1,741 @@
+/******************************************************************************
+* File Name:   host_bench.c
+*
+* Description: This file implements the benchmarks of the host build. The
+*              fault sweep injects each modelled fault into a running
+*              self-test scheduler and reports how reliably and how fast it
+*              is detected. The throughput benchmark reports how many runs
+*              per second each self test achieves.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "host_bench.h"
+#include "self_test_sched.h"
+#include "self_test_trace.h"
+#include "self_test_log.h"
+#include "self_test_monitor.h"
+#include "self_test_wdt.h"
+
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* One row of the fault sweep */
+typedef struct
+{
+    analog_sim_fault_t fault;
+    int32_t param;
+} bench_fault_t;
+
+/* State of the trial in progress */
+typedef struct
+{
+    bool injected;                 /* Fault active */
+    bool detected;                 /* A test failed after the injection */
+    uint64_t inject_us;            /* Simulated time of the injection */
+    uint64_t detect_us;            /* Simulated time of the first failure */
+    uint32_t completions;          /* Test completions before the injection */
+    uint32_t failures;             /* Failed completions before the injection */
+} bench_trial_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static void bench_result_cb(self_test_id_t id, uint8_t status, int32_t value);
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Test output suppressed with -q */
+static bool host_quiet;
+
+static const char * const bench_fault_names[ANALOG_SIM_FAULT_COUNT] =
+{
+    [ANALOG_SIM_FAULT_NONE] = "none",
+    [ANALOG_SIM_FAULT_ADC_STUCK] = "ADC stuck code",
+    [ANALOG_SIM_FAULT_REF_DRIFT] = "reference drift",
+    [ANALOG_SIM_FAULT_COMP_STUCK_HIGH] = "comp stuck high",
+    [ANALOG_SIM_FAULT_COMP_STUCK_LOW] = "comp stuck low",
+    [ANALOG_SIM_FAULT_OPAMP_OFFSET] = "opamp offset",
+    [ANALOG_SIM_FAULT_COMP_AUX_STUCK] = "comp 1 stuck",
+    [ANALOG_SIM_FAULT_COMP_SWITCH_OPEN] = "comp bus open",
+    [ANALOG_SIM_FAULT_SAR_STALL] = "SAR stall",
+    [ANALOG_SIM_FAULT_OPAMP_SLOW] = "opamp slow",
+    [ANALOG_SIM_FAULT_REF_SLOW] = "reference slow",
+};
+
+/* Faults swept by host_bench_faults. The rows within the test accuracy (the
+ * stuck code near VDDA/3 and the small drift and offset) and the comparator
+ * faults only the sweep checks for are expected to go undetected by the
+ * periodic tests and document the coverage limits.
+ */
+static const bench_fault_t bench_faults[] =
+{
+    { ANALOG_SIM_FAULT_NONE,            0 },
+    { ANALOG_SIM_FAULT_ADC_STUCK,       0x000 },
+    { ANALOG_SIM_FAULT_ADC_STUCK,       0xFFF },
+    { ANALOG_SIM_FAULT_ADC_STUCK,       0x555 },
+    { ANALOG_SIM_FAULT_REF_DRIFT,       ANALOG_ADC_ACURACCY / 2 },
+    { ANALOG_SIM_FAULT_REF_DRIFT,       ANALOG_ADC_ACURACCY + 50 },
+    { ANALOG_SIM_FAULT_REF_DRIFT,       -(ANALOG_ADC_ACURACCY + 50) },
+    { ANALOG_SIM_FAULT_REF_DRIFT,       ANALOG_ADC_ACURACCY * 3 },
+    { ANALOG_SIM_FAULT_COMP_STUCK_HIGH, 0 },
+    { ANALOG_SIM_FAULT_COMP_STUCK_LOW,  0 },
+    { ANALOG_SIM_FAULT_OPAMP_OFFSET,    ANALOG_OPAMP_ACURACCY / 2 },
+    { ANALOG_SIM_FAULT_OPAMP_OFFSET,    ANALOG_OPAMP_ACURACCY + 50 },
+    { ANALOG_SIM_FAULT_OPAMP_OFFSET,    -(ANALOG_OPAMP_ACURACCY + 50) },
+    { ANALOG_SIM_FAULT_COMP_AUX_STUCK,  0 },
+    { ANALOG_SIM_FAULT_COMP_SWITCH_OPEN, 0 },
+};
+
+#if SELF_TEST_HAS_COMPARATOR
+/* Faults run by host_bench_comp_sweep */
+static const bench_fault_t bench_comp_faults[] =
+{
+    { ANALOG_SIM_FAULT_NONE,            0 },
+    { ANALOG_SIM_FAULT_COMP_STUCK_HIGH, 0 },
+    { ANALOG_SIM_FAULT_COMP_STUCK_LOW,  0 },
+    { ANALOG_SIM_FAULT_COMP_AUX_STUCK,  0 },
+    { ANALOG_SIM_FAULT_COMP_AUX_STUCK,  1 },
+    { ANALOG_SIM_FAULT_COMP_SWITCH_OPEN, 0 },
+};
+#endif
+
+#if SELF_TEST_HAS_OPAMP
+/* Faults run by host_bench_opamp_step */
+static const bench_fault_t bench_opamp_faults[] =
+{
+    { ANALOG_SIM_FAULT_NONE,            0 },
+    { ANALOG_SIM_FAULT_OPAMP_OFFSET,    ANALOG_OPAMP_ACURACCY / 2 },
+    { ANALOG_SIM_FAULT_OPAMP_OFFSET,    ANALOG_OPAMP_ACURACCY + 50 },
+    { ANALOG_SIM_FAULT_OPAMP_SLOW,      2 },
+    { ANALOG_SIM_FAULT_OPAMP_SLOW,      3 },
+    { ANALOG_SIM_FAULT_OPAMP_SLOW,      4 },
+};
+#endif
+
+static const self_test_sched_config_t bench_sched_config =
+{
+    .tick_budget_us = SELF_TEST_SCHED_TICK_BUDGET_US,
+    .period_us = SELF_TEST_SCHED_PERIOD_US,
+    .coverage_us = SELF_TEST_SCHED_COVERAGE_US,
+    .max_period_us = SELF_TEST_SCHED_MAX_PERIOD_US,
+    .result_cb = bench_result_cb,
+};
+
+static bench_trial_t bench_trial;
+
+/*******************************************************************************
+* Function Name: host_time_ns
+********************************************************************************
+* Summary:
+* Returns the host monotonic clock in nanoseconds.
+*
+*******************************************************************************/
+uint64_t host_time_ns(void)
+{
+    struct timespec ts;
+
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ((uint64_t)ts.tv_sec * 1000000000u) + (uint64_t)ts.tv_nsec;
+}
+
+/*******************************************************************************
+* Function Name: host_set_quiet
+********************************************************************************
+* Summary:
+* Suppresses the test output printed by host_log_drain. The benchmark reports
+* are still printed.
+*
+*******************************************************************************/
+void host_set_quiet(bool quiet)
+{
+    host_quiet = quiet;
+}
+
+/*******************************************************************************
+* Function Name: host_log_drain
+********************************************************************************
+* Summary:
+* Prints the pending test output as the main loop does, or discards it when
+* the test output is suppressed.
+*
+*******************************************************************************/
+uint32_t host_log_drain(uint32_t max_events)
+{
+    return host_quiet ? self_test_log_discard(max_events) : self_test_log_drain(max_events);
+}
+
+/*******************************************************************************
+* Function Name: host_bench_fault_name
+********************************************************************************
+* Summary:
+* Returns the name of an injected fault for the benchmark output.
+*
+*******************************************************************************/
+const char *host_bench_fault_name(analog_sim_fault_t fault)
+{
+    return bench_fault_names[fault];
+}
+
+/*******************************************************************************
+* Function Name: bench_result_cb
+********************************************************************************
+* Summary:
+* Scheduler completion callback. Failures before the injection are false
+* positives; the first failure after it is the detection.
+*
+*******************************************************************************/
+static void bench_result_cb(self_test_id_t id, uint8_t status, int32_t value)
+{
+    (void)id;
+    (void)value;
+
+    if (!bench_trial.injected)
+    {
+        bench_trial.completions++;
+        if (OK_STATUS != status)
+        {
+            bench_trial.failures++;
+        }
+    }
+    else if ((!bench_trial.detected) && (OK_STATUS != status))
+    {
+        bench_trial.detected = true;
+        bench_trial.detect_us = analog_sim_time_us();
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_run_until
+********************************************************************************
+* Summary:
+* Runs the scheduler interleaved with simulated application work until the
+* given simulated time, or until a detection if stop_on_detect is set.
+*
+*******************************************************************************/
+static void bench_run_until(uint64_t end_us, bool stop_on_detect)
+{
+    while ((analog_sim_time_us() < end_us) && !(stop_on_detect && bench_trial.detected))
+    {
+        self_test_sched_tick();
+        self_test_trace_collect();
+        analog_sim_advance_us(HOST_APP_SLICE_US);
+    }
+}
+
+/*******************************************************************************
+* Function Name: bench_next_seed
+********************************************************************************
+* Summary:
+* Returns the next value of a xorshift32 sequence.
+*
+*******************************************************************************/
+static uint32_t bench_next_seed(uint32_t *state)
+{
+    uint32_t x = *state;
+
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+
+    return x;
+}
+
+/*******************************************************************************
+* Function Name: bench_reset
+********************************************************************************
+* Summary:
+* Clears the state the tests leave behind, so that a trial does not inherit
+* the monitor windows, trace statistics or learned budgets of a fault injected
+* before it.
+*
+*******************************************************************************/
+static void bench_reset(void)
+{
+    self_test_sched_abort();
+    self_test_monitor_init(NULL);
+    self_test_trace_reset();
+    self_test_wdt_reset();
+}
+
+/*******************************************************************************
+* Function Name: host_bench_faults
+********************************************************************************
+* Summary:
+* Runs every row of bench_faults for the given number of trials. A trial
+* restarts the scheduler, the plausibility monitor, the phase trace and the
+* watchdog supervisor on a healthy model with a new noise seed and runs it
+* long enough for the periods to adapt to the healthy margins, plus a random
+* part of the longest period, so that the injection falls at a different point
+* of the test sequence. It then injects the fault and runs for one diagnostic
+* coverage interval. For each row it prints the detection rate within that
+* interval, the false-positive rate before the injection and the mean and
+* maximum time from injection to the first failed test.
+*
+* Parameters:
+*  trials : Trials per fault
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void host_bench_faults(uint32_t trials)
+{
+    analog_sim_config_t *config = analog_sim_config();
+    uint32_t seed = config->seed;
+    size_t row;
+
+    printf("Fault sweep: %u trials per fault, detection window %u us, "
+            "noise %u mV\r\n", (unsigned)trials,
+            (unsigned)bench_sched_config.coverage_us, (unsigned)config->noise_mv);
+    printf("%-16s %6s %9s %9s %12s %12s\r\n", "fault", "param",
+            "detected", "false pos", "ttd mean us", "ttd max us");
+
+    for (row = 0u; row < (sizeof(bench_faults) / sizeof(bench_faults[0])); row++)
+    {
+        uint32_t detected = 0u;
+        uint32_t completions = 0u;
+        uint32_t failures = 0u;
+        uint64_t ttd_sum = 0u;
+        uint64_t ttd_max = 0u;
+        uint32_t trial;
+
+        for (trial = 0u; trial < trials; trial++)
+        {
+            uint32_t warmup_us = (3u * bench_sched_config.coverage_us) +
+                    (bench_next_seed(&seed) % bench_sched_config.max_period_us);
+
+            config->fault = ANALOG_SIM_FAULT_NONE;
+            analog_sim_reseed(bench_next_seed(&seed));
+            (void)memset(&bench_trial, 0, sizeof(bench_trial));
+            bench_reset();
+            self_test_sched_init(&bench_sched_config);
+
+            bench_run_until(analog_sim_time_us() + warmup_us, false);
+
+            config->fault = bench_faults[row].fault;
+            config->fault_param = bench_faults[row].param;
+            bench_trial.injected = true;
+            bench_trial.inject_us = analog_sim_time_us();
+
+            bench_run_until(bench_trial.inject_us + bench_sched_config.coverage_us, true);
+
+            completions += bench_trial.completions;
+            failures += bench_trial.failures;
+            if (bench_trial.detected)
+            {
+                uint64_t ttd = bench_trial.detect_us - bench_trial.inject_us;
+
+                detected++;
+                ttd_sum += ttd;
+                if (ttd > ttd_max)
+                {
+                    ttd_max = ttd;
+                }
+            }
+        }
+
+        printf("%-16s %6ld %8.1f%% %8.2f%% ",
+                bench_fault_names[bench_faults[row].fault], (long)bench_faults[row].param,
+                (100.0 * detected) / trials,
+                (0u != completions) ? ((100.0 * failures) / completions) : 0.0);
+        if (0u != detected)
+        {
+            printf("%12.0f %12lu\r\n", (double)ttd_sum / detected,
+                    (unsigned long)ttd_max);
+        }
+        else
+        {
+            printf("%12s %12s\r\n", "-", "-");
+        }
+    }
+
+    /* Leave a healthy, idle model for the following benchmarks */
+    self_test_sched_abort();
+    config->fault = ANALOG_SIM_FAULT_NONE;
+    analog_sim_reseed(seed);
+    bench_reset();
+    (void)self_test_log_discard(SELF_TEST_LOG_DEPTH);
+}
+
+/*******************************************************************************
+* Function Name: host_bench_throughput
+********************************************************************************
+* Summary:
+* Runs every test the given number of times and prints the host time and the
+* simulated analog time per run, and the resulting tests per second. The host
+* rate is the cost of the test code; the simulated rate is the limit set by
+* the modelled conversion and settling times. Draining the log and the phase
+* trace is not part of the measured time.
+*
+* Parameters:
+*  tests : Tests to run
+*  count : Number of tests
+*  runs  : Runs of each test
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void host_bench_throughput(const host_test_t *tests, size_t count, uint32_t runs)
+{
+    size_t i;
+
+    for (i = 0u; i < count; i++)
+    {
+        uint64_t sim_start = analog_sim_time_us();
+        uint64_t host_ns = 0u;
+        uint64_t host_start;
+        double sim_us;
+        uint32_t run;
+
+        for (run = 0u; run < runs; run++)
+        {
+            host_start = host_time_ns();
+            tests[i].run();
+            host_ns += host_time_ns() - host_start;
+
+            /* Output is not part of the measured test time */
+            self_test_trace_collect();
+            (void)host_log_drain(SELF_TEST_LOG_DEPTH);
+        }
+
+        sim_us = (double)(analog_sim_time_us() - sim_start) / runs;
+        printf("%-10s runs %u  host %8.1f ns/run %10.0f tests/s  sim %6.1f us/run ",
+                tests[i].name, (unsigned)runs, (double)host_ns / runs,
+                (0u != host_ns) ? ((1e9 * runs) / (double)host_ns) : 0.0, sim_us);
+        if (sim_us > 0.0)
+        {
+            printf("%8.0f tests/s\r\n", 1e6 / sim_us);
+        }
+        else
+        {
+            printf("%8s tests/s\r\n", "-");
+        }
+    }
+}
+
+#if SELF_TEST_HAS_OPAMP
+/*******************************************************************************
+* Function Name: host_bench_all
+********************************************************************************
+* Summary:
+* Runs adc_test and opamp_test back to back, then analog_all_test, the given
+* number of times each and prints the simulated time and the SAR scans per
+* run of both, and the time the single scan saves.
+*
+* Parameters:
+*  runs : Runs of each
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void host_bench_all(uint32_t runs)
+{
+    uint64_t sim_us[2] = { 0u, 0u };
+    uint32_t scans[2] = { 0u, 0u };
+    uint64_t sim_start;
+    uint32_t scan_start;
+    uint32_t run;
+    uint32_t i;
+
+    for (i = 0u; i < 2u; i++)
+    {
+        sim_start = analog_sim_time_us();
+        scan_start = analog_sim_scans();
+        for (run = 0u; run < runs; run++)
+        {
+            if (0u == i)
+            {
+                adc_test();
+                opamp_test();
+            }
+            else
+            {
+                analog_all_test();
+            }
+            self_test_trace_collect();
+            (void)host_log_drain(SELF_TEST_LOG_DEPTH);
+        }
+        sim_us[i] = analog_sim_time_us() - sim_start;
+        scans[i] = analog_sim_scans() - scan_start;
+    }
+
+    printf("all vs adc + opamp: sim %6.1f us/run, %lu scans vs %6.1f us/run, %lu scans, "
+            "%.1f us (%.0f%%) saved\r\n", (double)sim_us[1] / runs,
+            (unsigned long)(scans[1] / runs), (double)sim_us[0] / runs,
+            (unsigned long)(scans[0] / runs), (double)(sim_us[0] - sim_us[1]) / runs,
+            (0u != sim_us[0]) ? ((100.0 * (double)(sim_us[0] - sim_us[1])) /
+            (double)sim_us[0]) : 0.0);
+}
+#endif
+
+#if SELF_TEST_HAS_COMPARATOR
+/*******************************************************************************
+* Function Name: host_bench_comp_sweep
+********************************************************************************
+* Summary:
+* Runs the two-step comparator test and the comparator sweep the given number
+* of times under each comparator fault and prints, for both, the share of runs
+* that detected the fault, the host and simulated time per run, and the
+* checks per simulated microsecond.
+*
+* Parameters:
+*  runs : Runs of each test per fault
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void host_bench_comp_sweep(uint32_t runs)
+{
+    analog_sim_config_t *config = analog_sim_config();
+    uint32_t checks = 0u;
+    size_t row;
+
+    printf("%-16s %5s  %-33s  %-33s\r\n", "", "",
+            "two-step test", "sweep");
+    printf("%-16s %5s  %7s %9s %7s %7s  %7s %9s %7s %7s\r\n", "fault", "param",
+            "detect", "host ns", "sim us", "chk/us", "detect", "host ns", "sim us", "chk/us");
+
+    for (row = 0u; row < (sizeof(bench_comp_faults) / sizeof(bench_comp_faults[0])); row++)
+    {
+        uint64_t host_ns[2] = { 0u, 0u };
+        uint64_t sim_us[2] = { 0u, 0u };
+        uint32_t detected[2] = { 0u, 0u };
+        uint32_t run;
+        uint32_t i;
+
+        config->fault = bench_comp_faults[row].fault;
+        config->fault_param = bench_comp_faults[row].param;
+
+        for (run = 0u; run < runs; run++)
+        {
+            for (i = 0u; i < 2u; i++)
+            {
+                uint64_t sim_start = analog_sim_time_us();
+                uint64_t host_start = host_time_ns();
+                uint32_t failed = (0u == i) ? comparator_run() : comparator_sweep_run(&checks);
+
+                host_ns[i] += host_time_ns() - host_start;
+                sim_us[i] += analog_sim_time_us() - sim_start;
+                if (0u != failed)
+                {
+                    detected[i]++;
+                }
+            }
+            self_test_trace_collect();
+        }
+
+        printf("%-16s %5ld", bench_fault_names[bench_comp_faults[row].fault],
+                (long)bench_comp_faults[row].param);
+        for (i = 0u; i < 2u; i++)
+        {
+            double us = (double)sim_us[i] / runs;
+
+            printf("  %6.1f%% %9.1f %7.1f ", (100.0 * detected[i]) / runs,
+                    (double)host_ns[i] / runs, us);
+            if (us > 0.0)
+            {
+                printf("%7.3f", (double)((0u == i) ? 2u : checks) / us);
+            }
+            else
+            {
+                printf("%7s", "-");
+            }
+        }
+        printf("\r\n");
+    }
+    printf("Sweep: %lu checks in %u routing groups, %u us settling per group; "
+           "one settling wait per check would take %lu us\r\n",
+            (unsigned long)checks, (unsigned)self_test_comp_sweep.count,
+            (unsigned)COMP_SETTLE_US, (unsigned long)(checks * COMP_SETTLE_US));
+
+    config->fault = ANALOG_SIM_FAULT_NONE;
+}
+#endif
+
+#if SELF_TEST_HAS_OPAMP
+/*******************************************************************************
+* Function Name: host_bench_opamp_step
+********************************************************************************
+* Summary:
+* Runs the DC opamp check and the opamp step response test the given number of
+* times under each opamp fault and prints, for both, the share of runs that
+* detected the fault and the host and simulated time per run. For the step
+* test, it also prints the host cost per sample of the capture and of the
+* evaluation, and the settling time, slew rate and offset of the last run.
+*
+* Parameters:
+*  runs : Runs of each test per fault
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void host_bench_opamp_step(uint32_t runs)
+{
+    analog_sim_config_t *config = analog_sim_config();
+    opamp_step_result_t result = { 0 };
+    size_t row;
+
+    self_test_setup();
+
+    printf("%-12s %5s  %-25s  %-43s  %-23s\r\n", "", "", "DC check",
+            "step response, cost per sample", "last step");
+    printf("%-12s %5s  %7s %9s %7s  %7s %9s %7s %8s %8s  %7s %7s %7s\r\n", "fault", "param",
+            "detect", "host ns", "sim us", "detect", "host ns", "sim us", "capture",
+            "eval", "settle", "mV/us", "offset");
+
+    for (row = 0u; row < (sizeof(bench_opamp_faults) / sizeof(bench_opamp_faults[0])); row++)
+    {
+        uint64_t host_ns[2] = { 0u, 0u };
+        uint64_t sim_us[2] = { 0u, 0u };
+        uint32_t detected[2] = { 0u, 0u };
+        uint64_t capture_ns = 0u;
+        uint64_t eval_ns = 0u;
+        uint32_t run;
+        uint32_t i;
+
+        config->fault = bench_opamp_faults[row].fault;
+        config->fault_param = bench_opamp_faults[row].param;
+
+        for (run = 0u; run < runs; run++)
+        {
+            for (i = 0u; i < 2u; i++)
+            {
+                uint64_t sim_start = analog_sim_time_us();
+                uint64_t host_start = host_time_ns();
+                uint32_t failed;
+
+                if (0u == i)
+                {
+                    failed = (OK_STATUS != analog_backend_opamp_selftest(OPAMP_REF_EXPECTED,
+                            ANALOG_OPAMP_ACURACCY, OPAMP_SAR_CHANNEL)) ? 1u : 0u;
+                }
+                else
+                {
+                    failed = opamp_step_run(&result);
+                    capture_ns += result.capture_ticks;
+                    eval_ns += result.eval_ticks;
+                }
+
+                host_ns[i] += host_time_ns() - host_start;
+                sim_us[i] += analog_sim_time_us() - sim_start;
+                if (0u != failed)
+                {
+                    detected[i]++;
+                }
+            }
+            self_test_trace_collect();
+        }
+
+        printf("%-12s %5ld", bench_fault_names[bench_opamp_faults[row].fault],
+                (long)bench_opamp_faults[row].param);
+        for (i = 0u; i < 2u; i++)
+        {
+            printf("  %6.1f%% %9.1f %7.1f", (100.0 * detected[i]) / runs,
+                    (double)host_ns[i] / runs, (double)sim_us[i] / runs);
+        }
+        printf(" %8.1f %8.1f  %7.1f %7lu %7ld\r\n",
+                (double)capture_ns / ((double)runs * OPAMP_STEP_SAMPLES),
+                (double)eval_ns / ((double)runs * OPAMP_STEP_SAMPLES),
+                (double)result.settle_ns / 1000.0, (unsigned long)result.slew_mv_per_us,
+                (long)result.offset_mv);
+    }
+    printf("Step: %u samples, %u before the step, %lu ns apart; limits: settle %u us, "
+           "slew %u mV/us, step %d mV\r\n", (unsigned)OPAMP_STEP_SAMPLES,
+            (unsigned)OPAMP_STEP_PRE_SAMPLES, (unsigned long)result.sample_ns,
+            (unsigned)OPAMP_STEP_MAX_SETTLE_US, (unsigned)OPAMP_STEP_MIN_SLEW_MV_PER_US,
+            (int)OPAMP_STEP_MIN_STEP_MV);
+
+    config->fault = ANALOG_SIM_FAULT_NONE;
+}
+#endif
+
+/*******************************************************************************
+* Function Name: host_bench_monitor
+********************************************************************************
+* Summary:
+* Models an application that scans the reference and bandgap channels and
+* feeds every scan to the plausibility monitor. Prints the monitor state and
+* the host cost of feeding one sample.
+*
+* Parameters:
+*  scans : Number of application scans
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void host_bench_monitor(uint32_t scans)
+{
+#if (VBG_CHANNEL != ADC_REF_CHANNEL)
+    static const uint32_t channels[] = { ADC_REF_CHANNEL, VBG_CHANNEL };
+#else
+    static const uint32_t channels[] = { ADC_REF_CHANNEL };
+#endif
+    const uint32_t count = sizeof(channels) / sizeof(channels[0]);
+    int16_t counts[sizeof(channels) / sizeof(channels[0])];
+    uint64_t host_ns = 0u;
+    uint32_t scan;
+
+    self_test_monitor_init(NULL);
+    for (scan = 0u; scan < scans; scan++)
+    {
+        uint64_t host_start;
+
+        analog_backend_adc_scan(channels, count, counts);
+        host_start = host_time_ns();
+        self_test_monitor_feed_scan(channels, counts, count);
+        host_ns += host_time_ns() - host_start;
+
+        (void)host_log_drain(SELF_TEST_LOG_DEPTH);
+    }
+
+    self_test_monitor_print_stats();
+    printf("monitor    scans %u  host %8.1f ns/sample\r\n", (unsigned)scans,
+            (0u != scans) ? ((double)host_ns / ((double)scans * count)) : 0.0);
+}
+
+/* [] END OF FILE */
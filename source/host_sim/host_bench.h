@@ -0,0 +1,93 @@
+/******************************************************************************
+* File Name:   host_bench.h
+*
+* Description: This file is the public interface of host_bench.c, the fault
+*              injection and throughput benchmarks of the host build.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef HOST_BENCH_H_
+#define HOST_BENCH_H_
+
+#include <stddef.h>
+#include "self_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Simulated application work between two scheduler ticks */
+#define HOST_APP_SLICE_US          (100u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Self test run by the throughput benchmark */
+typedef struct
+{
+    const char *name;
+    void (*run)(void);
+} host_test_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint64_t host_time_ns(void);
+void host_set_quiet(bool quiet);
+uint32_t host_log_drain(uint32_t max_events);
+const char *host_bench_fault_name(analog_sim_fault_t fault);
+void host_bench_throughput(const host_test_t *tests, size_t count, uint32_t runs);
+void host_bench_faults(uint32_t trials);
+bool host_mailbox_bench(uint32_t duration_ms);
+void host_bench_monitor(uint32_t scans);
+bool host_proto_bench(uint32_t batches);
+bool host_bench_nvlog(uint32_t records);
+bool host_bench_wdt(const host_test_t *tests, size_t count, uint32_t runs);
+bool host_bench_post(void);
+#if SELF_TEST_HAS_COMPARATOR
+void host_bench_comp_sweep(uint32_t runs);
+#endif
+#if SELF_TEST_HAS_OPAMP
+void host_bench_opamp_step(uint32_t runs);
+void host_bench_all(uint32_t runs);
+#endif
+
+#endif /* HOST_BENCH_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,233 @@
+/******************************************************************************
+* File Name:   host_mailbox.c
+*
+* Description: This file models the dual-core build on the host. A producer
+*              thread plays the CM0+: it runs the self-test scheduler against
+*              the analog model and posts every result to the mailbox of
+*              self_test_mailbox.c. The main thread plays the CM4 and
+*              receives the results concurrently, so the lock-free mailbox is
+*              exercised by two truly concurrent cores. The IPC hand-off of
+*              the mailbox address is modelled by a shared pointer.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include "host_bench.h"
+#include "self_test_sched.h"
+#include "self_test_trace.h"
+#include "self_test_mailbox.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Mailbox "published" through the modelled IPC channel */
+static self_test_mailbox_t *host_ipc_mailbox;
+
+/* State shared by the two modelled cores */
+static self_test_mailbox_t host_mailbox;
+static uint64_t host_cm0p_end_us;
+static uint32_t host_cm0p_posted;
+static bool host_cm0p_done;
+
+/* Results checked by the modelled CM4 */
+static uint32_t host_cm4_received[SELF_TEST_ID_COUNT];
+static uint32_t host_cm4_invalid;
+
+/*******************************************************************************
+* Function Name: self_test_mailbox_publish
+********************************************************************************
+* Summary:
+* Host model of the IPC hand-off of the mailbox address.
+*
+*******************************************************************************/
+void self_test_mailbox_publish(self_test_mailbox_t *mailbox)
+{
+    self_test_mailbox_init(mailbox);
+    __atomic_store_n(&host_ipc_mailbox, mailbox, __ATOMIC_RELEASE);
+}
+
+/*******************************************************************************
+* Function Name: self_test_mailbox_attach
+********************************************************************************
+* Summary:
+* Host model of reading the mailbox address from the IPC channel.
+*
+*******************************************************************************/
+self_test_mailbox_t *self_test_mailbox_attach(void)
+{
+    return __atomic_load_n(&host_ipc_mailbox, __ATOMIC_ACQUIRE);
+}
+
+/*******************************************************************************
+* Function Name: host_cm0p_result_cb
+********************************************************************************
+* Summary:
+* Scheduler result callback of the modelled CM0+, as in main_cm0p.c.
+*
+*******************************************************************************/
+static void host_cm0p_result_cb(self_test_id_t id, uint8_t status, int32_t value)
+{
+    const self_test_mailbox_msg_t msg =
+    {
+        .time_us = analog_backend_time_us(),
+        .value = value,
+        .id = (uint8_t)id,
+        .status = status,
+    };
+
+    host_cm0p_posted++;
+    (void)self_test_mailbox_post(self_test_mailbox_attach(), &msg);
+}
+
+/*******************************************************************************
+* Function Name: host_cm0p_main
+********************************************************************************
+* Summary:
+* Thread of the modelled CM0+: waits for the mailbox, then runs the scheduler
+* until the simulated end time.
+*
+*******************************************************************************/
+static void *host_cm0p_main(void *arg)
+{
+    const self_test_sched_config_t config =
+    {
+        .tick_budget_us = SELF_TEST_SCHED_TICK_BUDGET_US,
+        .period_us = SELF_TEST_SCHED_PERIOD_US,
+        .coverage_us = SELF_TEST_SCHED_COVERAGE_US,
+        .max_period_us = SELF_TEST_SCHED_MAX_PERIOD_US,
+        .result_cb = host_cm0p_result_cb,
+    };
+
+    (void)arg;
+    while (NULL == self_test_mailbox_attach())
+    {
+    }
+
+    self_test_sched_init(&config);
+    while (analog_sim_time_us() < host_cm0p_end_us)
+    {
+        self_test_sched_tick();
+        self_test_trace_collect();
+        analog_sim_advance_us(HOST_APP_SLICE_US);
+
+        /* Simulated time runs much faster than real time; let the CM4
+         * thread run even when both share one host CPU.
+         */
+        (void)sched_yield();
+    }
+
+    __atomic_store_n(&host_cm0p_done, true, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/*******************************************************************************
+* Function Name: host_cm4_result_cb
+********************************************************************************
+* Summary:
+* Result handler of the modelled CM4: counts the results per test and checks
+* that they are well formed.
+*
+*******************************************************************************/
+static void host_cm4_result_cb(const self_test_mailbox_msg_t *msg)
+{
+    if ((msg->id >= (uint8_t)SELF_TEST_ID_COUNT) ||
+            ((OK_STATUS != msg->status) && (ERROR_STATUS != msg->status)))
+    {
+        host_cm4_invalid++;
+        return;
+    }
+    host_cm4_received[msg->id]++;
+}
+
+/*******************************************************************************
+* Function Name: host_mailbox_bench
+********************************************************************************
+* Summary:
+* Runs the modelled CM0+ for the given simulated time while the main thread
+* receives its results, then prints the mailbox statistics and checks that
+* every posted result was received or counted as dropped.
+*
+* Parameters:
+*  duration_ms : Simulated run time of the CM0+
+*
+* Return :
+*  true if no result was lost unaccounted or corrupted
+*
+*******************************************************************************/
+bool host_mailbox_bench(uint32_t duration_ms)
+{
+    const self_test_mailbox_stats_t *stats = self_test_mailbox_get_stats();
+    pthread_t cm0p;
+    uint32_t i;
+    bool ok;
+
+    host_cm0p_end_us = analog_sim_time_us() + ((uint64_t)duration_ms * 1000u);
+    if (0 != pthread_create(&cm0p, NULL, host_cm0p_main, NULL))
+    {
+        return false;
+    }
+
+    self_test_mailbox_publish(&host_mailbox);
+    for (;;)
+    {
+        bool done = __atomic_load_n(&host_cm0p_done, __ATOMIC_ACQUIRE);
+
+        if ((0u == self_test_mailbox_process(&host_mailbox, host_cm4_result_cb,
+                SELF_TEST_MAILBOX_DEPTH)) && done)
+        {
+            break;
+        }
+    }
+    (void)pthread_join(cm0p, NULL);
+
+    self_test_mailbox_print_stats(&host_mailbox);
+    for (i = 0u; i < (uint32_t)SELF_TEST_ID_COUNT; i++)
+    {
+        printf("  test %lu: %lu results\r\n", (unsigned long)i,
+                (unsigned long)host_cm4_received[i]);
+    }
+
+    ok = ((stats->received + host_mailbox.dropped) == host_cm0p_posted) &&
+            (stats->seq_gaps <= host_mailbox.dropped) && (0u == host_cm4_invalid);
+    printf("Mailbox model: %lu posted, %lu invalid, %s\r\n", (unsigned long)host_cm0p_posted,
+            (unsigned long)host_cm4_invalid, ok ? "consistent" : "INCONSISTENT");
+    return ok;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,348 @@
+/******************************************************************************
+* File Name:   host_main.c
+*
+* Description: This is the entry point of the host build. It runs the self
+*              tests from self_test.c against the analog model in
+*              analog_sim.c and reports how long each test took.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "self_test.h"
+#include "self_test_sched.h"
+#include "self_test_trace.h"
+#include "self_test_lp.h"
+#include "self_test_monitor.h"
+#include "host_bench.h"
+#include "nv_sim.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const host_test_t host_tests[] =
+{
+    { "adc",        adc_test },
+    { "adc_batch",  adc_batch_test },
+#if SELF_TEST_HAS_COMPARATOR
+    { "comparator", comparator_test },
+    { "comp_sweep", comparator_sweep_test },
+#endif
+#if SELF_TEST_HAS_OPAMP
+    { "opamp",      opamp_test },
+    { "opamp_step", opamp_step_test },
+#endif
+    { "all",        analog_all_test },
+};
+
+/*******************************************************************************
+* Function Name: host_usage
+********************************************************************************
+* Summary:
+* Prints the command line options.
+*
+*******************************************************************************/
+static void host_usage(const char *prog)
+{
+    fprintf(stderr,
+            "Usage: %s [options]\n"
+            "  -n <mV>    peak noise per conversion\n"
+            "  -o <mV>    static SAR offset\n"
+            "  -c <us>    conversion time\n"
+            "  -u <us>    setup time of a SAR scan\n"
+            "  -i <us>    LPCOMP and CTB initialization time\n"
+            "  -f <id>    injected fault (0 none, 1 ADC stuck, 2 reference drift,\n"
+            "             3 comparator stuck high, 4 comparator stuck low,\n"
+            "             5 opamp offset, 6 comparator channel 1 stuck at the\n"
+            "             parameter, 7 comparator AMUXBUS A switch open,\n"
+            "             8 SAR conversions stalled by the parameter in us,\n"
+            "             9 opamp slowed down by the parameter,\n"
+            "             10 reference settling slowed down by the parameter)\n"
+            "  -p <val>   fault parameter (stuck code or offset in mV)\n"
+            "  -r <n>     number of runs of each test\n"
+            "  -s <seed>  noise seed\n"
+            "  -S <ms>    run the periodic scheduler for the given simulated time\n"
+            "  -F         run the scheduler at the base period, without adapting\n"
+            "             it to the test margins\n"
+            "  -L <ms>    run the low-power mode for the given simulated time\n"
+            "  -A <n>     feed n application scans to the ADC plausibility monitor\n"
+            "  -P <n>     run n batches through the binary protocol loopback\n"
+            "  -N <n>     write n records to the result store, measure the page\n"
+            "             wear of an hour of periodic results, then cut the power\n"
+            "             during writes and check the recovery\n"
+            "  -M <ms>    run the dual-core mailbox model for the given simulated\n"
+            "             time\n"
+            "  -W <ms>    interval of comparator threshold crossings in\n"
+            "             low-power mode\n"
+            "  -B <n>     run the fault sweep with n trials per fault, then the\n"
+            "             throughput benchmark\n"
+            "  -C <n>     run the two-step comparator test and the comparator\n"
+            "             sweep n times under each comparator fault\n"
+            "  -O <n>     run the DC opamp check and the opamp step response test\n"
+            "             n times under each opamp fault\n"
+            "  -D <n>     run every test n times under the watchdog supervisor,\n"
+            "             then check its deadline handling with stalled and hung\n"
+            "             conversions\n"
+            "  -T         model the start-up in each order, with and without\n"
+            "             faults, and print the time from main to the verdict of\n"
+            "             the power-on self test\n"
+            "  -q         suppress the test output, but not the reports\n", prog);
+}
+
+/*******************************************************************************
+* Function Name: host_run_sched
+********************************************************************************
+* Summary:
+* Runs the self-test scheduler interleaved with simulated application work and
+* prints its statistics. With fixed set, every test runs at the base period
+* instead of the period adapted to its margin.
+*
+*******************************************************************************/
+static void host_run_sched(uint32_t duration_ms, bool fixed)
+{
+    uint64_t end_us = analog_sim_time_us() + ((uint64_t)duration_ms * 1000u);
+    const self_test_sched_config_t config =
+    {
+        .tick_budget_us = SELF_TEST_SCHED_TICK_BUDGET_US,
+        .period_us = SELF_TEST_SCHED_PERIOD_US,
+        .coverage_us = SELF_TEST_SCHED_COVERAGE_US,
+        .max_period_us = fixed ? 0u : SELF_TEST_SCHED_MAX_PERIOD_US,
+        .result_cb = NULL,
+    };
+
+    self_test_sched_init(&config);
+    while (analog_sim_time_us() < end_us)
+    {
+        self_test_sched_tick();
+        self_test_trace_collect();
+        (void)host_log_drain(1u);
+        analog_sim_advance_us(HOST_APP_SLICE_US);
+    }
+    self_test_sched_print_stats();
+    self_test_trace_print();
+}
+
+/*******************************************************************************
+* Function Name: host_run_lp
+********************************************************************************
+* Summary:
+* Runs the low-power mode and prints its statistics. The simulated clock only
+* advances in the tests and in deep sleep, so the duty cycle reflects the
+* modelled analog timing, not host CPU time.
+*
+*******************************************************************************/
+static void host_run_lp(uint32_t duration_ms)
+{
+    uint64_t end_us = analog_sim_time_us() + ((uint64_t)duration_ms * 1000u);
+
+    self_test_sched_init(NULL);
+    self_test_lp_init();
+    while (analog_sim_time_us() < end_us)
+    {
+        self_test_lp_step();
+    }
+    self_test_sched_print_stats();
+    self_test_lp_print_stats();
+}
+
+/*******************************************************************************
+* Function Name: main
+********************************************************************************
+* Summary:
+* Configures the analog model from the command line, optionally runs the fault
+* sweep, then runs every self test the given number of times and prints the
+* host and simulated time and the tests per second.
+*
+*******************************************************************************/
+int main(int argc, char *argv[])
+{
+    analog_sim_config_t config;
+    uint32_t runs = 1u;
+    uint32_t sched_ms = 0u;
+    uint32_t lp_ms = 0u;
+    uint32_t mailbox_ms = 0u;
+    uint32_t monitor_scans = 0u;
+    uint32_t proto_batches = 0u;
+    uint32_t nvlog_records = 0u;
+    uint32_t comp_runs = 0u;
+    uint32_t wdt_runs = 0u;
+    uint32_t step_runs = 0u;
+    uint32_t bench_trials = 0u;
+    bool fixed = false;
+    bool post = false;
+    bool quiet = false;
+    int opt;
+
+    analog_sim_default_config(&config);
+
+    while ((opt = getopt(argc, argv, "n:o:c:u:i:f:p:r:s:S:FL:M:W:A:P:N:C:O:D:B:Tqh")) != -1)
+    {
+        switch (opt)
+        {
+            case 'n': config.noise_mv = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'o': config.offset_mv = (int32_t)strtol(optarg, NULL, 0); break;
+            case 'c': config.conv_time_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'u': config.scan_setup_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'i': config.init_time_us = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'f': config.fault = (analog_sim_fault_t)strtoul(optarg, NULL, 0); break;
+            case 'p': config.fault_param = (int32_t)strtol(optarg, NULL, 0); break;
+            case 'r': runs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 's': config.seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'S': sched_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'F': fixed = true; break;
+            case 'T': post = true; break;
+            case 'L': lp_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'A': monitor_scans = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'P': proto_batches = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'C': comp_runs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'O': step_runs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'D': wdt_runs = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'N': nvlog_records = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'M': mailbox_ms = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'W': config.comp_wake_period_us = (uint32_t)strtoul(optarg, NULL, 0) * 1000u; break;
+            case 'B': bench_trials = (uint32_t)strtoul(optarg, NULL, 0); break;
+            case 'q': quiet = true; break;
+            default:
+                host_usage(argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if ((config.fault >= ANALOG_SIM_FAULT_COUNT) || (0u == runs))
+    {
+        host_usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    host_set_quiet(quiet);
+    analog_sim_init(&config);
+    nv_sim_erase_all();
+
+    if (post)
+    {
+        /* Every start-up runs in a fresh child process, before the setup */
+        return host_bench_post() ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    {
+        uint64_t sim_start = analog_sim_time_us();
+        uint64_t host_start = host_time_ns();
+
+        self_test_setup();
+        printf("%-10s once    host %8.1f ns      sim %6.1f us\r\n", "setup",
+                (double)(host_time_ns() - host_start),
+                (double)(analog_sim_time_us() - sim_start));
+    }
+    self_test_monitor_init(NULL);
+
+    if (0u != sched_ms)
+    {
+        host_run_sched(sched_ms, fixed);
+        return EXIT_SUCCESS;
+    }
+
+    if (0u != monitor_scans)
+    {
+        host_bench_monitor(monitor_scans);
+        return EXIT_SUCCESS;
+    }
+
+    if (0u != proto_batches)
+    {
+        return host_proto_bench(proto_batches) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+#if SELF_TEST_HAS_COMPARATOR
+    if (0u != comp_runs)
+    {
+        host_bench_comp_sweep(comp_runs);
+        return EXIT_SUCCESS;
+    }
+#else
+    (void)comp_runs;
+#endif
+
+#if SELF_TEST_HAS_OPAMP
+    if (0u != step_runs)
+    {
+        host_bench_opamp_step(step_runs);
+        return EXIT_SUCCESS;
+    }
+#else
+    (void)step_runs;
+#endif
+
+    if (0u != nvlog_records)
+    {
+        return host_bench_nvlog(nvlog_records) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (0u != wdt_runs)
+    {
+        return host_bench_wdt(host_tests, sizeof(host_tests) / sizeof(host_tests[0]),
+                wdt_runs) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (0u != mailbox_ms)
+    {
+        return host_mailbox_bench(mailbox_ms) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+    if (0u != lp_ms)
+    {
+        host_run_lp(lp_ms);
+        return EXIT_SUCCESS;
+    }
+
+    if (0u != bench_trials)
+    {
+        host_bench_faults(bench_trials);
+    }
+
+    host_bench_throughput(host_tests, sizeof(host_tests) / sizeof(host_tests[0]), runs);
+#if SELF_TEST_HAS_OPAMP
+    host_bench_all(runs);
+#endif
+
+    self_test_trace_print();
+
+    return EXIT_SUCCESS;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,386 @@
+/******************************************************************************
+* File Name:   host_nvlog.c
+*
+* Description: This file benchmarks the result store in self_test_nvlog.c on
+*              the flash model in nv_sim.c: the cost of an append, the record
+*              throughput and page wear of the background writes, the page
+*              erases per hour of the periodic results at main loop rates,
+*              and the mount time and record loss after power cuts at random
+*              points.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "host_bench.h"
+#include "nv_sim.h"
+#include "self_test_nvlog.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Power cuts injected by the recovery benchmark */
+#define HOST_NVLOG_CUTS            (200u)
+
+/* Records read back by the consistency check */
+#define HOST_NVLOG_READBACK        (64u)
+
+/* Simulated time of each wear run: one hour */
+#define HOST_NVLOG_WEAR_MS         (3600000u)
+
+/* Rated erase cycles of a flash row, for the lifetime estimate */
+#define HOST_NVLOG_ENDURANCE       (100000u)
+
+/* Ways the periodic results reach the store in the wear runs */
+#define HOST_NVLOG_WEAR_ALL        (0u)    /* Every result, written at once */
+#define HOST_NVLOG_WEAR_PASS       (1u)    /* self_test_nvlog_periodic, all pass */
+#define HOST_NVLOG_WEAR_FLAP       (2u)    /* Pass and fail alternate */
+#define HOST_NVLOG_WEAR_FAIL       (3u)    /* All fail */
+#define HOST_NVLOG_WEAR_MODES      (4u)
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static self_test_nvlog_record_t host_nvlog_buf[HOST_NVLOG_READBACK];
+
+/* Period of each periodic test in the wear runs, in milliseconds */
+static const uint32_t host_nvlog_wear_period_ms[SELF_TEST_ID_COUNT] = { 100u, 200u, 800u };
+
+static const char *const host_nvlog_wear_names[HOST_NVLOG_WEAR_MODES] =
+{
+    "every result", "passing", "flapping", "failing"
+};
+
+/*******************************************************************************
+* Function Name: host_nvlog_consistent
+********************************************************************************
+* Summary:
+* Reads back the latest records and checks that they come newest first with
+* consecutive sequence numbers, up to the first gap left by a power cut.
+*
+*******************************************************************************/
+static bool host_nvlog_consistent(void)
+{
+    uint32_t count = self_test_nvlog_latest(host_nvlog_buf, HOST_NVLOG_READBACK);
+    uint32_t i;
+
+    for (i = 1u; i < count; i++)
+    {
+        if (host_nvlog_buf[i].seq >= host_nvlog_buf[i - 1u].seq)
+        {
+            return false;
+        }
+    }
+    return (0u != count);
+}
+
+/*******************************************************************************
+* Function Name: host_nvlog_run
+********************************************************************************
+* Summary:
+* Appends records at the given interval of simulated time, calling
+* self_test_nvlog_process every application slice as the main loop does,
+* and returns the host time spent in the appends.
+*
+*******************************************************************************/
+static uint64_t host_nvlog_run(uint32_t records, uint32_t interval_us)
+{
+    uint64_t append_ns = 0u;
+    uint32_t elapsed = 0u;
+    uint32_t i = 0u;
+
+    while (i < records)
+    {
+        if (elapsed >= interval_us)
+        {
+            uint64_t start = host_time_ns();
+
+            (void)self_test_nvlog_append((uint8_t)(i % SELF_TEST_ID_COUNT), OK_STATUS,
+                    (int32_t)i);
+            append_ns += host_time_ns() - start;
+            elapsed = 0u;
+            i++;
+        }
+        self_test_nvlog_process();
+        analog_sim_advance_us(HOST_APP_SLICE_US);
+        elapsed += HOST_APP_SLICE_US;
+    }
+    return append_ns;
+}
+
+/*******************************************************************************
+* Function Name: host_nvlog_drain
+********************************************************************************
+* Summary:
+* Runs self_test_nvlog_process until every appended record is in the store.
+*
+*******************************************************************************/
+static void host_nvlog_drain(void)
+{
+    const self_test_nvlog_stats_t *stats = self_test_nvlog_get_stats();
+
+    self_test_nvlog_flush();
+    while (stats->committed_seq != (stats->appended - stats->dropped))
+    {
+        self_test_nvlog_process();
+        analog_sim_advance_us(HOST_APP_SLICE_US);
+    }
+}
+
+/*******************************************************************************
+* Function Name: host_nvlog_wear
+********************************************************************************
+* Summary:
+* Runs the periodic tests for HOST_NVLOG_WEAR_MS of simulated time on an
+* erased store, calling self_test_nvlog_process every application slice as
+* the main loop does, and prints the records stored and the page erases per
+* hour: the most of one page in the run, and the average over the ring that
+* a page sees in the long run, from which the lifetime follows. Returns false
+* if records were dropped, the store did not read back consistently, or the
+* passing results were written more often than the commit interval allows.
+*
+*******************************************************************************/
+static bool host_nvlog_wear(uint32_t mode)
+{
+    const self_test_nvlog_stats_t *stats = self_test_nvlog_get_stats();
+    uint32_t wear_start[ANALOG_BACKEND_NV_PAGES];
+    uint32_t runs[SELF_TEST_ID_COUNT] = { 0u };
+    uint32_t wear_max = 0u;
+    uint32_t writes;
+    uint32_t page;
+    uint32_t id;
+    uint32_t us;
+    bool ok;
+
+    nv_sim_erase_all();
+    self_test_nvlog_init();
+    host_nvlog_drain();
+    writes = stats->page_writes;
+    for (page = 0u; page < ANALOG_BACKEND_NV_PAGES; page++)
+    {
+        wear_start[page] = nv_sim_wear(page);
+    }
+
+    for (us = 0u; us < (HOST_NVLOG_WEAR_MS * 1000u); us += HOST_APP_SLICE_US)
+    {
+        for (id = 0u; id < (uint32_t)SELF_TEST_ID_COUNT; id++)
+        {
+            uint8_t status;
+
+            if ((us / 1000u) < (runs[id] * host_nvlog_wear_period_ms[id]))
+            {
+                continue;
+            }
+            status = (uint8_t)(((HOST_NVLOG_WEAR_FAIL == mode) ||
+                    ((HOST_NVLOG_WEAR_FLAP == mode) && (0u != (runs[id] & 1u)))) ?
+                    ERROR_STATUS : OK_STATUS);
+            runs[id]++;
+
+            if (HOST_NVLOG_WEAR_ALL == mode)
+            {
+                (void)self_test_nvlog_append((uint8_t)id | SELF_TEST_NVLOG_PERIODIC, status,
+                        (int32_t)runs[id]);
+                self_test_nvlog_flush();
+            }
+            else
+            {
+                self_test_nvlog_periodic((uint8_t)id, status, (int32_t)runs[id]);
+            }
+        }
+        self_test_nvlog_process();
+        analog_sim_advance_us(HOST_APP_SLICE_US);
+    }
+    host_nvlog_drain();
+    writes = stats->page_writes - writes;
+
+    for (page = 0u; page < ANALOG_BACKEND_NV_PAGES; page++)
+    {
+        uint32_t wear = nv_sim_wear(page) - wear_start[page];
+
+        wear_max = (wear > wear_max) ? wear : wear_max;
+    }
+
+    ok = (0u == stats->dropped) && host_nvlog_consistent();
+    if (HOST_NVLOG_WEAR_PASS == mode)
+    {
+        ok = ok && (writes <= (HOST_NVLOG_WEAR_MS / SELF_TEST_NVLOG_COMMIT_MS));
+    }
+
+    printf("  %-12s %6lu records, %6lu page writes, erases per page per hour %5lu most, "
+            "%8.2f average, ", host_nvlog_wear_names[mode],
+            (unsigned long)stats->committed_seq, (unsigned long)writes,
+            (unsigned long)wear_max, (double)writes / (double)ANALOG_BACKEND_NV_PAGES);
+    if (0u != writes)
+    {
+        printf("%.3g years to %lu cycles\r\n",
+                (double)HOST_NVLOG_ENDURANCE * (double)ANALOG_BACKEND_NV_PAGES /
+                (double)writes / (24.0 * 365.0), (unsigned long)HOST_NVLOG_ENDURANCE);
+    }
+    else
+    {
+        printf("no wear\r\n");
+    }
+    return ok;
+}
+
+/*******************************************************************************
+* Function Name: host_bench_nvlog
+********************************************************************************
+* Summary:
+* Fills an erased store with the given number of records, appended faster
+* than single-record page writes could keep up with, and prints the append
+* cost, record throughput and page wear. Then runs the periodic tests at
+* main loop rates for an hour, storing every result as well as through
+* self_test_nvlog_periodic with passing, flapping and failing tests, and
+* prints the page erases per hour. Then cuts the power at random points of a
+* slower record stream, remounts after each cut and prints the mount time and
+* the records lost.
+*
+* Parameters:
+*  records : Number of records of the throughput run
+*
+* Return :
+*  true if no committed record beyond the torn page was lost, the store read
+*  back consistently after every mount and the passing periodic results kept
+*  to the commit interval
+*
+*******************************************************************************/
+bool host_bench_nvlog(uint32_t records)
+{
+    const self_test_nvlog_stats_t *stats = self_test_nvlog_get_stats();
+    uint64_t sim_start;
+    uint64_t append_ns;
+    uint64_t mount_ns = 0u;
+    uint64_t max_mount_ns = 0u;
+    uint32_t wear_min = UINT32_MAX;
+    uint32_t wear_max = 0u;
+    uint32_t max_lost = 0u;
+    uint32_t lossless = 0u;
+    uint32_t results = 0u;
+    uint32_t page;
+    uint32_t i;
+    double sim_s;
+    bool ok;
+
+    nv_sim_erase_all();
+    self_test_nvlog_init();
+    host_nvlog_drain();
+
+    /* Throughput: one record every millisecond */
+    sim_start = analog_sim_time_us();
+    append_ns = host_nvlog_run(records, 1000u);
+    host_nvlog_drain();
+    sim_s = (double)(analog_sim_time_us() - sim_start) / 1e6;
+    ok = (0u == stats->dropped) && host_nvlog_consistent();
+
+    for (page = 0u; page < ANALOG_BACKEND_NV_PAGES; page++)
+    {
+        uint32_t wear = nv_sim_wear(page);
+
+        wear_min = (wear < wear_min) ? wear : wear_min;
+        wear_max = (wear > wear_max) ? wear : wear_max;
+    }
+
+    printf("Result store: %lu records of %lu bytes, %lu pages of %lu records\r\n",
+            (unsigned long)records, (unsigned long)sizeof(self_test_nvlog_record_t),
+            (unsigned long)ANALOG_BACKEND_NV_PAGES, (unsigned long)SELF_TEST_NVLOG_SLOTS);
+    printf("  append: %8.1f ns host, %lu dropped\r\n",
+            (double)append_ns / (double)((0u != records) ? records : 1u),
+            (unsigned long)stats->dropped);
+    printf("  writes: %lu pages, %.1f records per write, longest %lu us, "
+            "%.0f records/s sustained\r\n", (unsigned long)stats->page_writes,
+            (double)stats->committed_seq / (double)((0u != stats->page_writes) ?
+            stats->page_writes : 1u), (unsigned long)stats->max_write_us,
+            (double)records / sim_s);
+    printf("  wear:   %lu to %lu writes per page\r\n", (unsigned long)wear_min,
+            (unsigned long)wear_max);
+
+    /* Wear: an hour of periodic results at main loop rates */
+    for (i = 0u; i < (uint32_t)SELF_TEST_ID_COUNT; i++)
+    {
+        results += HOST_NVLOG_WEAR_MS / host_nvlog_wear_period_ms[i];
+    }
+    printf("  periodic: %lu results in %lu s, tests every %lu, %lu and %lu ms\r\n",
+            (unsigned long)results,
+            (unsigned long)(HOST_NVLOG_WEAR_MS / 1000u),
+            (unsigned long)host_nvlog_wear_period_ms[0],
+            (unsigned long)host_nvlog_wear_period_ms[1],
+            (unsigned long)host_nvlog_wear_period_ms[2]);
+    for (i = 0u; ok && (i < HOST_NVLOG_WEAR_MODES); i++)
+    {
+        ok = host_nvlog_wear(i);
+    }
+
+    /* Recovery: a record every 5 ms, power cut after a random time */
+    for (i = 0u; ok && (i < HOST_NVLOG_CUTS); i++)
+    {
+        uint32_t committed;
+        uint32_t lost;
+        uint64_t start;
+        uint64_t ns;
+
+        (void)host_nvlog_run(1u + ((uint32_t)rand() % (2u * SELF_TEST_NVLOG_SLOTS)), 5000u);
+        analog_sim_advance_us((uint32_t)rand() % (NV_SIM_ERASE_US + NV_SIM_PROGRAM_US));
+        committed = stats->committed_seq;
+        nv_sim_power_cut();
+
+        start = host_time_ns();
+        self_test_nvlog_init();
+        ns = host_time_ns() - start;
+        mount_ns += ns;
+        max_mount_ns = (ns > max_mount_ns) ? ns : max_mount_ns;
+
+        /* The boot record is queued, the rest is what was recovered */
+        lost = (committed > stats->committed_seq) ? (committed - stats->committed_seq) : 0u;
+        max_lost = (lost > max_lost) ? lost : max_lost;
+        if (0u == lost)
+        {
+            lossless++;
+        }
+        ok = (lost <= SELF_TEST_NVLOG_SLOTS) && host_nvlog_consistent();
+    }
+
+    printf("  power cuts: %lu, %lu without loss, at most %lu committed records lost\r\n",
+            (unsigned long)i, (unsigned long)lossless, (unsigned long)max_lost);
+    printf("  mount:  %8.1f ns host average, %8.1f ns worst, %lu pages scanned, %s\r\n",
+            (double)mount_ns / (double)((0u != i) ? i : 1u), (double)max_mount_ns,
+            (unsigned long)stats->mount_pages, ok ? "consistent" : "INCONSISTENT");
+
+    return ok;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,253 @@
+/******************************************************************************
+* File Name:   host_post.c
+*
+* Description: This file contains the host benchmark of the power-on self
+*              test. Every start-up runs in a child process, so that it starts
+*              from fresh state as after a reset, with the board
+*              initialization and the console modelled as fixed delays.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "host_bench.h"
+#include "nv_sim.h"
+#include "self_test_log.h"
+#include "self_test_nvlog.h"
+#include "self_test_post.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Modelled cybsp_init, dominated by the clock setup and the PLL lock */
+#define HOST_POST_BOARD_US         (500u)
+
+/* Modelled retarget-io initialization and start-up banner: about 110
+ * characters at 115200 baud
+ */
+#define HOST_POST_CONSOLE_US       (9500u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Order of the start-up */
+typedef enum
+{
+    HOST_POST_CONSOLE_FIRST = 0u,  /* Console, then the analog bring-up, as
+                                    * main.c without SELF_TEST_FAST_POST */
+    HOST_POST_SERIAL,              /* Analog bring-up first, but the reference
+                                    * settling is waited out before the init
+                                    * work */
+    HOST_POST_FAST                 /* Analog bring-up first, the init work
+                                    * overlaps the reference settling */
+} host_post_order_t;
+
+/* One start-up of the benchmark */
+typedef struct
+{
+    host_post_order_t order;
+    analog_sim_fault_t fault;
+    int32_t param;
+} host_post_row_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char * const host_post_order_names[] =
+{
+    [HOST_POST_CONSOLE_FIRST] = "console 1st",
+    [HOST_POST_SERIAL] = "serial",
+    [HOST_POST_FAST] = "fast",
+};
+
+/* Start-ups run by host_bench_post. A faulty device must fail the power-on
+ * self test, a healthy one must pass it.
+ */
+static const host_post_row_t host_post_rows[] =
+{
+    { HOST_POST_CONSOLE_FIRST, ANALOG_SIM_FAULT_NONE,            0 },
+    { HOST_POST_SERIAL,        ANALOG_SIM_FAULT_NONE,            0 },
+    { HOST_POST_FAST,          ANALOG_SIM_FAULT_NONE,            0 },
+    { HOST_POST_FAST,          ANALOG_SIM_FAULT_REF_SLOW,        2 },
+    { HOST_POST_FAST,          ANALOG_SIM_FAULT_ADC_STUCK,       0xFFF },
+#if SELF_TEST_HAS_COMPARATOR
+    { HOST_POST_FAST,          ANALOG_SIM_FAULT_COMP_STUCK_HIGH, 0 },
+#endif
+};
+
+/*******************************************************************************
+* Function Name: host_post_boot
+********************************************************************************
+* Summary:
+* Models one start-up in the given order and prints its breakdown. Runs in
+* the child process.
+*
+*******************************************************************************/
+static uint8_t host_post_boot(const host_post_row_t *row)
+{
+    const self_test_post_result_t *result = self_test_post_get_result();
+    uint64_t host_start;
+    uint64_t check_ns;
+    uint32_t stage;
+
+    self_test_post_start();
+    analog_backend_delay_us(HOST_POST_BOARD_US);
+    self_test_post_mark(SELF_TEST_POST_STAGE_BOARD);
+
+    if (HOST_POST_CONSOLE_FIRST == row->order)
+    {
+        analog_backend_delay_us(HOST_POST_CONSOLE_US);
+        self_test_post_mark(SELF_TEST_POST_STAGE_CONSOLE);
+    }
+
+    (void)self_test_post_analog_start();
+    if (HOST_POST_SERIAL == row->order)
+    {
+        analog_backend_delay_us(analog_backend_ref_settle_us());
+        self_test_post_mark(SELF_TEST_POST_STAGE_SETTLE);
+    }
+    self_test_setup();
+    self_test_nvlog_init();
+    self_test_post_mark(SELF_TEST_POST_STAGE_INIT);
+
+    host_start = host_time_ns();
+    (void)self_test_post_check();
+    check_ns = host_time_ns() - host_start;
+
+    if (HOST_POST_CONSOLE_FIRST != row->order)
+    {
+        analog_backend_delay_us(HOST_POST_CONSOLE_US);
+        self_test_post_mark(SELF_TEST_POST_STAGE_CONSOLE);
+    }
+
+    printf("%-11s %-15s %5ld", host_post_order_names[row->order],
+            host_bench_fault_name(row->fault),
+            (long)row->param);
+    for (stage = 0u; stage < (uint32_t)SELF_TEST_POST_STAGE_COUNT; stage++)
+    {
+        if (0u != (result->stage_mask & (1uL << stage)))
+        {
+            printf(" %7lu", (unsigned long)result->stage_us[stage]);
+        }
+        else
+        {
+            printf(" %7s", "-");
+        }
+    }
+    printf(" %8lu %8lu  0x%02lX %8.0f\r\n", (unsigned long)result->verdict_us,
+            (unsigned long)result->end_us[SELF_TEST_POST_STAGE_CONSOLE],
+            (unsigned long)result->failed, (double)check_ns);
+
+    self_test_post_report();
+    (void)host_log_drain(SELF_TEST_LOG_DEPTH);
+    (void)fflush(stdout);
+
+    return result->status;
+}
+
+/*******************************************************************************
+* Function Name: host_bench_post
+********************************************************************************
+* Summary:
+* Runs every start-up of host_post_rows in a child process and prints the
+* duration of each stage in simulated microseconds, the time from main to the
+* verdict and to the console being up, the failure mask, and the host time of
+* the checks.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  true if every healthy start-up passed and every faulty one failed
+*
+*******************************************************************************/
+bool host_bench_post(void)
+{
+    analog_sim_config_t config = *analog_sim_config();
+    bool ok = true;
+    size_t row;
+    uint32_t stage;
+
+    printf("Power-on SelfTest: reference settles in %u us, board %u us, "
+            "console %u us modelled\r\n", (unsigned)ANALOG_BACKEND_REF_SETTLE_US,
+            (unsigned)HOST_POST_BOARD_US, (unsigned)HOST_POST_CONSOLE_US);
+    printf("%-11s %-15s %5s", "order", "fault", "param");
+    for (stage = 0u; stage < (uint32_t)SELF_TEST_POST_STAGE_COUNT; stage++)
+    {
+        printf(" %7s", self_test_post_stage_name((self_test_post_stage_t)stage));
+    }
+    printf(" %8s %8s  %4s %8s\r\n", "verdict", "up", "mask", "host ns");
+
+    for (row = 0u; row < (sizeof(host_post_rows) / sizeof(host_post_rows[0])); row++)
+    {
+        int child_status = 0;
+        pid_t pid;
+
+        (void)fflush(stdout);
+        (void)fflush(stderr);
+        pid = fork();
+        if (pid < 0)
+        {
+            return false;
+        }
+        if (0 == pid)
+        {
+            config.fault = host_post_rows[row].fault;
+            config.fault_param = host_post_rows[row].param;
+            analog_sim_init(&config);
+            nv_sim_erase_all();
+            _exit(host_post_boot(&host_post_rows[row]));
+        }
+        if ((waitpid(pid, &child_status, 0) != pid) || !WIFEXITED(child_status))
+        {
+            return false;
+        }
+        if ((OK_STATUS == WEXITSTATUS(child_status)) !=
+            (ANALOG_SIM_FAULT_NONE == host_post_rows[row].fault))
+        {
+            ok = false;
+        }
+    }
+
+    printf("%s\r\n", ok ? "PASS: every fault failed the power-on SelfTest" :
+            "FAIL: unexpected power-on SelfTest verdict");
+
+    return ok;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,419 @@
+/******************************************************************************
+* File Name:   host_proto.c
+*
+* Description: This file is the host reference client of the binary command
+*              protocol in self_test_proto.c and a loopback harness for it.
+*              The client frames requests and feeds them byte by byte to the
+*              device side; the device responses go to a link buffer that the
+*              client parses, resynchronizing on the start byte and CRC as it
+*              must on the real UART, where text log output may sit between
+*              frames.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "host_bench.h"
+#include "self_test_proto.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Size of the device to client link buffer */
+#define HOST_LINK_SIZE             (1024u)
+
+/* UART baud rate the wire time is modelled for, 10 bits per byte */
+#define HOST_PROTO_BAUD            (115200u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Response received by the client */
+typedef struct
+{
+    uint8_t payload[SELF_TEST_PROTO_MAX_PAYLOAD];
+    uint32_t length;
+} host_frame_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Bytes sent by the device, not yet parsed by the client */
+static uint8_t host_link[HOST_LINK_SIZE];
+static uint32_t host_link_length;
+static uint32_t host_link_pos;
+
+/* Link statistics */
+static uint64_t host_link_bytes;           /* Bytes in both directions */
+static uint32_t host_link_skipped;         /* Bytes dropped by resynchronization */
+
+/*******************************************************************************
+* Function Name: host_device_tx
+********************************************************************************
+* Summary:
+* Transmit function of the device side: appends to the link buffer.
+*
+*******************************************************************************/
+static void host_device_tx(const uint8_t *data, uint32_t length)
+{
+    assert((host_link_length + length) <= HOST_LINK_SIZE);
+    memcpy(&host_link[host_link_length], data, length);
+    host_link_length += length;
+    host_link_bytes += length;
+}
+
+/*******************************************************************************
+* Function Name: host_client_send
+********************************************************************************
+* Summary:
+* Frames a request and feeds it to the device receiver.
+*
+*******************************************************************************/
+static void host_client_send(const uint8_t *payload, uint32_t length, bool corrupt)
+{
+    uint8_t frame[SELF_TEST_PROTO_MAX_PAYLOAD + SELF_TEST_PROTO_OVERHEAD];
+    uint32_t frame_length = self_test_proto_frame(frame, payload, length);
+    uint32_t i;
+
+    if (corrupt)
+    {
+        frame[frame_length - 1u] ^= 0x5Au;
+    }
+    for (i = 0u; i < frame_length; i++)
+    {
+        bool taken = self_test_proto_rx_byte(frame[i]);
+
+        assert(taken);
+        (void)taken;
+    }
+    host_link_bytes += frame_length;
+}
+
+/*******************************************************************************
+* Function Name: host_client_next
+********************************************************************************
+* Summary:
+* Returns the next valid response on the link. Bytes that do not start a
+* frame with a valid length and CRC are skipped one at a time.
+*
+*******************************************************************************/
+static bool host_client_next(host_frame_t *frame)
+{
+    while (host_link_pos < host_link_length)
+    {
+        const uint8_t *src = &host_link[host_link_pos];
+        uint32_t avail = host_link_length - host_link_pos;
+        uint32_t length;
+        uint16_t crc;
+
+        if ((SELF_TEST_PROTO_SOF != src[0]) || (avail < 2u) ||
+                (0u == src[1]) || (src[1] > SELF_TEST_PROTO_MAX_PAYLOAD))
+        {
+            host_link_pos++;
+            host_link_skipped++;
+            continue;
+        }
+        length = src[1];
+        if (avail < (length + SELF_TEST_PROTO_OVERHEAD))
+        {
+            return false;
+        }
+        crc = self_test_proto_crc(0xFFFFu, &src[1], length + 1u);
+        if (crc != (uint16_t)(src[2u + length] | ((uint16_t)src[3u + length] << 8)))
+        {
+            host_link_pos++;
+            host_link_skipped++;
+            continue;
+        }
+
+        memcpy(frame->payload, &src[2], length);
+        frame->length = length;
+        host_link_pos += length + SELF_TEST_PROTO_OVERHEAD;
+        return true;
+    }
+
+    host_link_length = 0u;
+    host_link_pos = 0u;
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: host_client_expect
+********************************************************************************
+* Summary:
+* Reads the next response and checks its type and sequence number.
+*
+*******************************************************************************/
+static bool host_client_expect(host_frame_t *frame, uint8_t type, uint8_t seq)
+{
+    if (!host_client_next(frame) || (frame->length < 2u) ||
+            (type != frame->payload[0]) || (seq != frame->payload[1]))
+    {
+        printf("Protocol: expected response 0x%02X seq %u\r\n", type, seq);
+        return false;
+    }
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: host_client_expect_nak
+********************************************************************************
+* Summary:
+* Sends a request that must be rejected and checks the error code.
+*
+*******************************************************************************/
+static bool host_client_expect_nak(const uint8_t *payload, uint32_t length, bool corrupt,
+        uint8_t error)
+{
+    host_frame_t frame;
+
+    host_client_send(payload, length, corrupt);
+    return host_client_expect(&frame, SELF_TEST_PROTO_RSP_NAK, payload[1]) &&
+            (3u == frame.length) && (error == frame.payload[2]);
+}
+
+/*******************************************************************************
+* Function Name: host_client_run
+********************************************************************************
+* Summary:
+* Runs one batch end to end: sends the request, lets the device process it
+* and checks that every result arrives in order and that the end of batch
+* counts match. Returns the number of results, 0 on a protocol error.
+*
+*******************************************************************************/
+static uint32_t host_client_run(const uint8_t *request, uint32_t length)
+{
+    const uint8_t seq = request[1];
+    host_frame_t frame;
+    uint32_t results = 0u;
+    uint32_t failures = 0u;
+    uint32_t entry = 0u;
+    uint32_t repeat = 0u;
+
+    host_client_send(request, length, false);
+    if (!host_client_expect(&frame, SELF_TEST_PROTO_RSP_ACK, seq))
+    {
+        return 0u;
+    }
+
+    /* Log output the device prints between frames */
+    host_device_tx((const uint8_t *)"log line\r\n", 10u);
+
+    while (self_test_proto_busy())
+    {
+        self_test_proto_process();
+        while (host_client_next(&frame))
+        {
+            const uint8_t *p = frame.payload;
+
+            if (SELF_TEST_PROTO_RSP_DONE == p[0])
+            {
+                return ((seq == p[1]) && ((p[2] | (p[3] << 8)) == (int)results) &&
+                        ((p[4] | (p[5] << 8)) == (int)failures)) ? results : 0u;
+            }
+            if ((SELF_TEST_PROTO_RSP_RESULT != p[0]) ||
+                    (SELF_TEST_PROTO_RESULT_SIZE != frame.length) || (seq != p[1]))
+            {
+                return 0u;
+            }
+
+            /* Results arrive in request order */
+            if ((p[2] != entry) || (p[3] != repeat))
+            {
+                if ((p[2] != (entry + 1u)) || (0u != p[3]))
+                {
+                    return 0u;
+                }
+                entry++;
+            }
+            repeat = p[3] + 1u;
+            results++;
+            if (OK_STATUS != p[5])
+            {
+                failures++;
+            }
+        }
+    }
+
+    return (host_client_expect(&frame, SELF_TEST_PROTO_RSP_DONE, seq) &&
+            ((frame.payload[2] | (frame.payload[3] << 8)) == (int)results)) ? results : 0u;
+}
+
+/*******************************************************************************
+* Function Name: host_proto_bench
+********************************************************************************
+* Summary:
+* Checks the protocol error paths, then runs the given number of batches
+* through the loopback and prints the end-to-end command and result rates:
+* on the host, and as modelled for the device, from the simulated analog time
+* and the UART wire time of the frames.
+*
+* Parameters:
+*  batches : Number of run requests
+*
+* Return :
+*  true if every response was as expected
+*
+*******************************************************************************/
+bool host_proto_bench(uint32_t batches)
+{
+    /* Test, repeat, param (LE) */
+    uint8_t request[3u + (SELF_TEST_PROTO_MAX_ENTRIES * SELF_TEST_PROTO_ENTRY_SIZE)] =
+    {
+        SELF_TEST_PROTO_REQ_RUN, 0u, 0u,
+    };
+    const uint8_t entries[][SELF_TEST_PROTO_ENTRY_SIZE] =
+    {
+        { SELF_TEST_PROTO_TEST_ADC,       2u, 0u, 0u },
+#if ADC_REF_VOLTAGE2
+        { SELF_TEST_PROTO_TEST_ADC,       1u, 1u, 0u },
+#endif
+#if SELF_TEST_HAS_COMPARATOR
+        { SELF_TEST_PROTO_TEST_COMPARATOR, 2u, 0u, 0u },
+#endif
+#if SELF_TEST_HAS_OPAMP
+        { SELF_TEST_PROTO_TEST_OPAMP,     1u, 0u, 0u },
+#endif
+        { SELF_TEST_PROTO_TEST_ADC_BATCH, 1u, 16u, 0u },
+    };
+    const uint32_t count = sizeof(entries) / sizeof(entries[0]);
+    const uint32_t length = 3u + (count * SELF_TEST_PROTO_ENTRY_SIZE);
+    host_frame_t frame;
+    uint64_t host_start;
+    uint64_t sim_start;
+    double host_s;
+    double device_s;
+    uint32_t results = 0u;
+    uint32_t i;
+    bool ok;
+
+    self_test_proto_init(host_device_tx);
+
+    request[2] = (uint8_t)count;
+    memcpy(&request[3], entries, count * SELF_TEST_PROTO_ENTRY_SIZE);
+
+    /* Version handshake */
+    {
+        const uint8_t ping[] = { SELF_TEST_PROTO_REQ_PING, 0x10u };
+
+        host_client_send(ping, sizeof(ping), false);
+        ok = host_client_expect(&frame, SELF_TEST_PROTO_RSP_PONG, 0x10u) &&
+                (SELF_TEST_PROTO_VERSION == frame.payload[2]);
+    }
+
+    /* Error paths: corrupted CRC, unknown type, unknown test, busy */
+    {
+        const uint8_t unknown[] = { 0x7Fu, 0x11u };
+        const uint8_t bad_test[] = { SELF_TEST_PROTO_REQ_RUN, 0x12u, 1u, 0x7Fu, 1u, 0u, 0u };
+        uint8_t busy[sizeof(request)];
+
+        ok = ok && host_client_expect_nak(request, length, true, SELF_TEST_PROTO_ERR_CRC);
+        ok = ok && host_client_expect_nak(unknown, sizeof(unknown), false,
+                SELF_TEST_PROTO_ERR_TYPE);
+        ok = ok && host_client_expect_nak(bad_test, sizeof(bad_test), false,
+                SELF_TEST_PROTO_ERR_TEST);
+
+        memcpy(busy, request, length);
+        busy[1] = 0x13u;
+        host_client_send(request, length, false);
+        ok = ok && host_client_expect(&frame, SELF_TEST_PROTO_RSP_ACK, 0u);
+        ok = ok && host_client_expect_nak(busy, length, false, SELF_TEST_PROTO_ERR_BUSY);
+
+        /* Abort ends the batch at once */
+        busy[0] = SELF_TEST_PROTO_REQ_ABORT;
+        host_client_send(busy, 2u, false);
+        ok = ok && host_client_expect(&frame, SELF_TEST_PROTO_RSP_DONE, 0u) &&
+                !self_test_proto_busy();
+    }
+
+    /* Stalled frame: dropped after the timeout, the next byte starts anew */
+    {
+        const uint8_t ping[] = { SELF_TEST_PROTO_REQ_PING, 0x14u };
+        const uint8_t partial[] = { SELF_TEST_PROTO_SOF, 2u, SELF_TEST_PROTO_REQ_PING };
+        uint32_t i;
+
+        for (i = 0u; i < sizeof(partial); i++)
+        {
+            (void)self_test_proto_rx_byte(partial[i]);
+        }
+        analog_sim_advance_us(SELF_TEST_PROTO_RX_TIMEOUT_US + 1u);
+        ok = ok && !self_test_proto_rx_byte((uint8_t)'8');
+
+        for (i = 0u; i < sizeof(partial); i++)
+        {
+            (void)self_test_proto_rx_byte(partial[i]);
+        }
+        analog_sim_advance_us(SELF_TEST_PROTO_RX_TIMEOUT_US + 1u);
+        host_client_send(ping, sizeof(ping), false);
+        ok = ok && host_client_expect(&frame, SELF_TEST_PROTO_RSP_PONG, 0x14u);
+    }
+    printf("Protocol error paths: %s\r\n", ok ? "as expected" : "FAILED");
+
+    host_link_bytes = 0u;
+    host_link_skipped = 0u;
+    host_start = host_time_ns();
+    sim_start = analog_sim_time_us();
+    for (i = 0u; ok && (i < batches); i++)
+    {
+        uint32_t n;
+
+        request[1] = (uint8_t)i;
+        n = host_client_run(request, length);
+        ok = (0u != n);
+        results += n;
+    }
+    host_s = (double)(host_time_ns() - host_start) / 1e9;
+    device_s = ((double)(analog_sim_time_us() - sim_start) / 1e6) +
+            (((double)host_link_bytes * 10.0) / (double)HOST_PROTO_BAUD);
+
+    printf("Protocol loopback: %lu batches, %lu results, %llu link bytes, "
+            "%lu bytes skipped, %s\r\n", (unsigned long)i, (unsigned long)results,
+            (unsigned long long)host_link_bytes, (unsigned long)host_link_skipped,
+            ok ? "consistent" : "INCONSISTENT");
+    if ((0u != i) && (host_s > 0.0) && (device_s > 0.0))
+    {
+        printf("  host:   %10.0f commands/s %10.0f results/s\r\n",
+                (double)i / host_s, (double)results / host_s);
+        printf("  device: %10.1f commands/s %10.1f results/s (analog time + %lu baud)\r\n",
+                (double)i / device_s, (double)results / device_s,
+                (unsigned long)HOST_PROTO_BAUD);
+    }
+
+    return ok;
+}
+
+/* [] END OF FILE */
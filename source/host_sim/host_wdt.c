@@ -0,0 +1,326 @@
+/******************************************************************************
+* File Name:   host_wdt.c
+*
+* Description: This file benchmarks the watchdog supervisor of
+*              self_test_wdt.c on the host: false alarms of the learned
+*              budgets, the cost of a phase check, and the detection of a
+*              delayed conversion, of a conversion that hangs a blocking test
+*              until the modelled watchdog resets the device, and of one that
+*              never completes in a scheduled test.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "host_bench.h"
+#include "wdt_sim.h"
+#include "nv_sim.h"
+#include "self_test_sched.h"
+#include "self_test_trace.h"
+#include "self_test_log.h"
+#include "self_test_nvlog.h"
+#include "self_test_wdt.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Simulated time the scheduler runs for, healthy and with a hung conversion */
+#define HOST_WDT_SCHED_MS          (2000u)
+
+/* Phase checks timed by the overhead measurement */
+#define HOST_WDT_CALLS             (100000u)
+
+/* Extra time of every conversion in the delay test; more than the learned
+ * budget of a conversion phase, far less than the watchdog timeout
+ */
+#define HOST_WDT_STALL_US          (200)
+
+/* Extra time of every conversion in the hang tests, far more than the
+ * watchdog timeout
+ */
+#define HOST_WDT_HANG_US           (10000000)
+
+/* Records read back to find the reported watchdog reset */
+#define HOST_WDT_READBACK          (4u)
+
+/* Time given to the store to write the records queued at start-up */
+#define HOST_WDT_DRAIN_US          (4u * (NV_SIM_ERASE_US + NV_SIM_PROGRAM_US))
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static jmp_buf host_wdt_reset;
+static self_test_nvlog_record_t host_wdt_records[HOST_WDT_READBACK];
+
+/*******************************************************************************
+* Function Name: host_wdt_idle
+********************************************************************************
+* Summary:
+* Does the work of one pass of the main loop outside the tests.
+*
+*******************************************************************************/
+static void host_wdt_idle(void)
+{
+    self_test_wdt_service();
+    self_test_nvlog_process();
+    self_test_trace_collect();
+    (void)host_log_drain(SELF_TEST_LOG_DEPTH);
+}
+
+/*******************************************************************************
+* Function Name: host_wdt_sched
+********************************************************************************
+* Summary:
+* Runs the scheduler interleaved with simulated application work, kicking the
+* watchdog from the loop as main.c does.
+*
+*******************************************************************************/
+static void host_wdt_sched(uint32_t duration_ms)
+{
+    uint64_t end_us = analog_sim_time_us() + ((uint64_t)duration_ms * 1000u);
+
+    while (analog_sim_time_us() < end_us)
+    {
+        self_test_sched_tick();
+        host_wdt_idle();
+        analog_sim_advance_us(HOST_APP_SLICE_US);
+    }
+}
+
+/*******************************************************************************
+* Function Name: host_wdt_reported
+********************************************************************************
+* Summary:
+* Writes the queued records to the store and checks that the latest ones
+* include the watchdog reset of the ADC test.
+*
+*******************************************************************************/
+static bool host_wdt_reported(void)
+{
+    uint32_t count;
+    uint32_t i;
+
+    for (i = 0u; i < (HOST_WDT_DRAIN_US / HOST_APP_SLICE_US); i++)
+    {
+        self_test_nvlog_process();
+        self_test_wdt_service();
+        analog_sim_advance_us(HOST_APP_SLICE_US);
+    }
+
+    count = self_test_nvlog_latest(host_wdt_records, HOST_WDT_READBACK);
+    for (i = 0u; i < count; i++)
+    {
+        if ((((uint8_t)SELF_TEST_ID_ADC | SELF_TEST_NVLOG_OVERRUN) == host_wdt_records[i].id) &&
+            (SELF_TEST_NVLOG_OVERRUN_RESET ==
+                ((uint32_t)host_wdt_records[i].value & SELF_TEST_NVLOG_OVERRUN_RESET)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*******************************************************************************
+* Function Name: host_bench_wdt
+********************************************************************************
+* Summary:
+* Runs every test the given number of times and the scheduler with the
+* supervisor and the modelled watchdog started, and prints the false alarms
+* and the cost of a phase check. Then injects a SAR stall: a short one must
+* be reported as a phase overrun without a reset, a long one in a bounded
+* conversion wait must fail the test and be reported without a reset, a long
+* one in a blocking test must end in a watchdog reset that is reported at the
+* next start-up, and a long one in the scheduler must be reported as a run
+* overrun before the watchdog expires.
+*
+* Parameters:
+*  tests : Tests to run
+*  count : Number of tests
+*  runs  : Runs of each test, at least SELF_TEST_WDT_LEARN_RUNS
+*
+* Return :
+*  true if there was no false alarm and every injected stall was detected as
+*  expected
+*
+*******************************************************************************/
+bool host_bench_wdt(const host_test_t *tests, size_t count, uint32_t runs)
+{
+    analog_sim_config_t *config = analog_sim_config();
+    const self_test_wdt_stats_t *stats = self_test_wdt_get_stats();
+    volatile uint64_t hang_us = 0u;
+    volatile bool hung = false;
+    uint64_t start;
+    uint64_t check_ns;
+    uint64_t idle_ns;
+    uint32_t false_alarms;
+    uint32_t overruns;
+    uint32_t resets;
+    uint32_t sched_failures;
+    uint32_t run;
+    uint32_t i;
+    adc_batch_result_t batch;
+    bool bounded;
+    bool reported;
+    bool ok;
+
+    if (runs < SELF_TEST_WDT_LEARN_RUNS)
+    {
+        runs = SELF_TEST_WDT_LEARN_RUNS;
+    }
+
+    wdt_sim_set_reset(&host_wdt_reset);
+    self_test_nvlog_init();
+    self_test_wdt_init();
+
+    /* Healthy device: the budgets are learned, no overrun may follow */
+    for (run = 0u; run < runs; run++)
+    {
+        for (i = 0u; i < count; i++)
+        {
+            tests[i].run();
+            host_wdt_idle();
+        }
+    }
+    self_test_sched_init(NULL);
+    host_wdt_sched(HOST_WDT_SCHED_MS);
+    false_alarms = stats->overruns;
+    resets = wdt_sim_resets();
+    printf("wdt        learn: %lu runs, %lu phases checked, %lu kicks, "
+            "%lu false alarms, %lu resets\r\n", (unsigned long)stats->runs,
+            (unsigned long)stats->phases, (unsigned long)stats->kicks,
+            (unsigned long)false_alarms, (unsigned long)resets);
+
+    /* Cost of a check, in and outside a supervised run */
+    self_test_wdt_begin(SELF_TEST_ID_ADC, false);
+    start = host_time_ns();
+    for (i = 0u; i < HOST_WDT_CALLS; i++)
+    {
+        self_test_wdt_phase(SELF_TEST_ID_ADC, SELF_TEST_PHASE_CONVERT);
+    }
+    check_ns = host_time_ns() - start;
+    self_test_wdt_end(SELF_TEST_ID_ADC, true);
+    start = host_time_ns();
+    for (i = 0u; i < HOST_WDT_CALLS; i++)
+    {
+        self_test_wdt_phase(SELF_TEST_ID_ADC, SELF_TEST_PHASE_CONVERT);
+    }
+    idle_ns = host_time_ns() - start;
+    printf("wdt        check: %6.1f ns host per phase, %6.1f ns outside a run, "
+            "longest %lu ns\r\n", (double)check_ns / HOST_WDT_CALLS,
+            (double)idle_ns / HOST_WDT_CALLS, (unsigned long)stats->max_check_ticks);
+
+    /* Delayed conversions: reported, no reset */
+    config->fault = ANALOG_SIM_FAULT_SAR_STALL;
+    config->fault_param = HOST_WDT_STALL_US;
+    overruns = stats->overruns;
+    adc_test();
+    host_wdt_idle();
+    overruns = stats->overruns - overruns;
+    printf("wdt        delay: conversions +%ld us, %lu phase overruns, last %lu us "
+            "for a budget of %lu us, %lu resets\r\n", (long)config->fault_param,
+            (unsigned long)overruns, (unsigned long)stats->last_overrun_us,
+            (unsigned long)self_test_wdt_budget_us(SELF_TEST_ID_ADC, SELF_TEST_PHASE_CONVERT),
+            (unsigned long)(wdt_sim_resets() - resets));
+    ok = (0u == false_alarms) && (0u != overruns) && (resets == wdt_sim_resets());
+
+    /* Hung conversion in a bounded wait: the test fails, no reset */
+    config->fault_param = HOST_WDT_HANG_US;
+    overruns = stats->overruns;
+    start = analog_sim_time_us();
+    bounded = (OK_STATUS != adc_batch_run(ADC_BATCH_SAMPLES, &batch));
+    start = analog_sim_time_us() - start;
+    host_wdt_idle();
+    overruns = stats->overruns - overruns;
+    printf("wdt        bound: batch %s after %lu us, %lu overruns, %lu resets\r\n",
+            bounded ? "failed" : "PASSED", (unsigned long)start, (unsigned long)overruns,
+            (unsigned long)(wdt_sim_resets() - resets));
+    ok = ok && bounded && (0u != overruns) && (resets == wdt_sim_resets());
+
+    /* Hung conversion in a blocking test: only the watchdog ends it */
+    config->fault_param = HOST_WDT_HANG_US;
+    if (0 == setjmp(host_wdt_reset))
+    {
+        hang_us = analog_sim_time_us();
+        adc_test();
+    }
+    else
+    {
+        hung = true;
+    }
+    config->fault = ANALOG_SIM_FAULT_NONE;
+
+    /* Start-up after the reset */
+    self_test_nvlog_init();
+    self_test_wdt_init();
+    reported = (1u == stats->resets) && host_wdt_reported();
+    printf("wdt        hang:  %s %lu us after the conversion started, %s\r\n",
+            hung ? "watchdog reset" : "NO RESET", hung ?
+            (unsigned long)(wdt_sim_reset_us() - hang_us) : 0uL,
+            reported ? "reported at start-up" : "NOT REPORTED");
+    ok = ok && hung && reported;
+
+    /* Hung conversion in the scheduler: the run deadline ends it */
+    self_test_sched_init(NULL);
+    host_wdt_sched(HOST_WDT_SCHED_MS);
+    resets = wdt_sim_resets();
+    overruns = stats->overruns;
+    config->fault = ANALOG_SIM_FAULT_SAR_STALL;
+    if (0 == setjmp(host_wdt_reset))
+    {
+        host_wdt_sched(HOST_WDT_SCHED_MS);
+    }
+    config->fault = ANALOG_SIM_FAULT_NONE;
+    overruns = stats->overruns - overruns;
+    sched_failures = self_test_sched_get_stats()->test[SELF_TEST_ID_ADC].failures;
+    printf("wdt        sched: %lu run overruns, last %lu us for a budget of %lu us, "
+            "%lu ADC runs failed, %lu resets\r\n", (unsigned long)overruns,
+            (unsigned long)stats->last_overrun_us,
+            (unsigned long)self_test_wdt_budget_us(SELF_TEST_ID_ADC, SELF_TEST_WDT_PHASE_RUN),
+            (unsigned long)sched_failures, (unsigned long)(wdt_sim_resets() - resets));
+    ok = ok && (0u != overruns) && (0u != sched_failures) && (resets == wdt_sim_resets());
+
+    wdt_sim_stop();
+    wdt_sim_set_reset(NULL);
+
+    /* The modelled reset cleared the statistics, as a device reset would */
+    printf("wdt        since the modelled reset, the scheduled stage only:\r\n");
+    self_test_wdt_print_stats();
+    self_test_nvlog_print(SELF_TEST_NVLOG_PRINT_MAX);
+
+    return ok;
+}
+
+/* [] END OF FILE */
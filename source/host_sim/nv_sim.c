@@ -0,0 +1,190 @@
+/******************************************************************************
+* File Name:   nv_sim.c
+*
+* Description: This file is the host implementation of the non-volatile
+*              memory functions of analog_backend.h. The store pages are kept
+*              in RAM and a page write takes simulated time, so that the
+*              result store sees the same background completion as on the
+*              flash. A power cut can be injected in the middle of a write,
+*              which leaves the page erased and partly programmed.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <string.h>
+#include "nv_sim.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static uint8_t nv_sim_pages[ANALOG_BACKEND_NV_PAGES][ANALOG_BACKEND_NV_PAGE_SIZE];
+static uint32_t nv_sim_writes[ANALOG_BACKEND_NV_PAGES];
+
+/* Page write in progress */
+static const uint8_t *nv_sim_data;
+static uint32_t nv_sim_page;
+static uint64_t nv_sim_start_us;
+
+/*******************************************************************************
+* Function Name: nv_sim_erase_all
+********************************************************************************
+* Summary:
+* Erases every page and clears the wear counts, as on a new device.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void nv_sim_erase_all(void)
+{
+    (void)memset(nv_sim_pages, 0xFF, sizeof(nv_sim_pages));
+    (void)memset(nv_sim_writes, 0, sizeof(nv_sim_writes));
+    nv_sim_data = NULL;
+}
+
+/*******************************************************************************
+* Function Name: nv_sim_power_cut
+********************************************************************************
+* Summary:
+* Models a power loss at the current simulated time. A page write in progress
+* is torn: the page is left erased, and the bytes programmed before the cut
+* hold the new data.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void nv_sim_power_cut(void)
+{
+    uint64_t elapsed;
+    uint32_t programmed = 0u;
+
+    if (NULL == nv_sim_data)
+    {
+        return;
+    }
+
+    elapsed = analog_sim_time_us() - nv_sim_start_us;
+    if (elapsed > NV_SIM_ERASE_US)
+    {
+        programmed = (uint32_t)(((elapsed - NV_SIM_ERASE_US) * ANALOG_BACKEND_NV_PAGE_SIZE) /
+                NV_SIM_PROGRAM_US);
+    }
+    (void)memset(nv_sim_pages[nv_sim_page], 0xFF, ANALOG_BACKEND_NV_PAGE_SIZE);
+    (void)memcpy(nv_sim_pages[nv_sim_page], nv_sim_data, programmed);
+    nv_sim_data = NULL;
+}
+
+/*******************************************************************************
+* Function Name: nv_sim_wear
+********************************************************************************
+* Summary:
+* Returns the number of completed writes of a page.
+*
+* Parameters:
+*  page : Page, below ANALOG_BACKEND_NV_PAGES
+*
+* Return :
+*  Write count
+*
+*******************************************************************************/
+uint32_t nv_sim_wear(uint32_t page)
+{
+    return nv_sim_writes[page];
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_nv_page
+********************************************************************************
+* Summary:
+* Returns a page of the model.
+*
+*******************************************************************************/
+const uint8_t *analog_backend_nv_page(uint32_t page)
+{
+    return nv_sim_pages[page];
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_nv_write
+********************************************************************************
+* Summary:
+* Starts a page write, which completes NV_SIM_ERASE_US + NV_SIM_PROGRAM_US of
+* simulated time later.
+*
+*******************************************************************************/
+bool analog_backend_nv_write(uint32_t page, const uint8_t *data)
+{
+    if (NULL != nv_sim_data)
+    {
+        return false;
+    }
+    nv_sim_data = data;
+    nv_sim_page = page;
+    nv_sim_start_us = analog_sim_time_us();
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_nv_busy
+********************************************************************************
+* Summary:
+* Completes the page write in progress once its time has passed.
+*
+*******************************************************************************/
+bool analog_backend_nv_busy(void)
+{
+    if (NULL == nv_sim_data)
+    {
+        return false;
+    }
+    if ((analog_sim_time_us() - nv_sim_start_us) < (NV_SIM_ERASE_US + NV_SIM_PROGRAM_US))
+    {
+        return true;
+    }
+    (void)memcpy(nv_sim_pages[nv_sim_page], nv_sim_data, ANALOG_BACKEND_NV_PAGE_SIZE);
+    nv_sim_writes[nv_sim_page]++;
+    nv_sim_data = NULL;
+    return false;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,68 @@
+/******************************************************************************
+* File Name:   nv_sim.h
+*
+* Description: This file is the public interface of nv_sim.c, the RAM model
+*              of the flash pages that hold the self-test result store.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef NV_SIM_H_
+#define NV_SIM_H_
+
+#include "analog_backend.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Duration of the erase and of the program phase of a page write, modelled
+ * on a 512-byte PSoC 6 flash row write.
+ */
+#define NV_SIM_ERASE_US            (4000u)
+#define NV_SIM_PROGRAM_US          (12000u)
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void nv_sim_erase_all(void);
+void nv_sim_power_cut(void);
+uint32_t nv_sim_wear(uint32_t page);
+
+#endif /* NV_SIM_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,218 @@
+/******************************************************************************
+* File Name:   wdt_sim.c
+*
+* Description: This file implements the watchdog functions of the analog
+*              backend on the host. The watchdog counts simulated time; when
+*              it expires, the reset is modelled by a jump to the point the
+*              benchmark registered with wdt_sim_set_reset, from where it
+*              starts the firmware again. Variables keep their values over
+*              the reset, as a no-init section does; a flash write still in
+*              progress is torn.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "wdt_sim.h"
+#include "nv_sim.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static jmp_buf *wdt_sim_env;
+static bool wdt_sim_running;
+static bool wdt_sim_reset_flag;
+static uint64_t wdt_sim_timeout_us;
+static uint64_t wdt_sim_kick_us;
+static uint64_t wdt_sim_last_reset_us;
+static uint32_t wdt_sim_kick_count;
+static uint32_t wdt_sim_reset_count;
+
+/*******************************************************************************
+* Function Name: wdt_sim_set_reset
+********************************************************************************
+* Summary:
+* Registers the point a watchdog reset jumps to. Without one, a watchdog
+* reset ends the program.
+*
+* Parameters:
+*  env : Context saved by setjmp, or NULL
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void wdt_sim_set_reset(jmp_buf *env)
+{
+    wdt_sim_env = env;
+}
+
+/*******************************************************************************
+* Function Name: wdt_sim_poll
+********************************************************************************
+* Summary:
+* Resets the modelled device if the watchdog has not been kicked within its
+* timeout. Called by analog_sim_advance_us whenever simulated time passes.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void wdt_sim_poll(void)
+{
+    uint64_t now = analog_sim_time_us();
+
+    if (!wdt_sim_running || ((now - wdt_sim_kick_us) < wdt_sim_timeout_us))
+    {
+        return;
+    }
+
+    wdt_sim_running = false;
+    wdt_sim_reset_flag = true;
+    wdt_sim_reset_count++;
+    wdt_sim_last_reset_us = wdt_sim_kick_us + wdt_sim_timeout_us;
+    (void)analog_backend_nv_busy();
+    nv_sim_power_cut();
+
+    if (NULL == wdt_sim_env)
+    {
+        fprintf(stderr, "watchdog reset at %llu us\n", (unsigned long long)now);
+        exit(EXIT_FAILURE);
+    }
+    longjmp(*wdt_sim_env, 1);
+}
+
+/*******************************************************************************
+* Function Name: wdt_sim_stop
+********************************************************************************
+* Summary:
+* Stops the watchdog, e.g. at the end of a benchmark.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void wdt_sim_stop(void)
+{
+    wdt_sim_running = false;
+}
+
+/*******************************************************************************
+* Function Name: wdt_sim_kicks
+********************************************************************************
+* Summary:
+* Returns the number of watchdog kicks.
+*
+*******************************************************************************/
+uint32_t wdt_sim_kicks(void)
+{
+    return wdt_sim_kick_count;
+}
+
+/*******************************************************************************
+* Function Name: wdt_sim_resets
+********************************************************************************
+* Summary:
+* Returns the number of watchdog resets.
+*
+*******************************************************************************/
+uint32_t wdt_sim_resets(void)
+{
+    return wdt_sim_reset_count;
+}
+
+/*******************************************************************************
+* Function Name: wdt_sim_reset_us
+********************************************************************************
+* Summary:
+* Returns the simulated time the watchdog expired at, for the last reset. A
+* long modelled delay can pass it by before the reset is seen.
+*
+*******************************************************************************/
+uint64_t wdt_sim_reset_us(void)
+{
+    return wdt_sim_last_reset_us;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_wdt_start
+********************************************************************************
+* Summary:
+* Starts the modelled watchdog with the given timeout.
+*
+*******************************************************************************/
+void analog_backend_wdt_start(uint32_t timeout_ms)
+{
+    wdt_sim_timeout_us = (uint64_t)timeout_ms * 1000u;
+    wdt_sim_kick_us = analog_sim_time_us();
+    wdt_sim_running = true;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_wdt_kick
+********************************************************************************
+* Summary:
+* Restarts the timeout of the modelled watchdog.
+*
+*******************************************************************************/
+void analog_backend_wdt_kick(void)
+{
+    wdt_sim_kick_us = analog_sim_time_us();
+    wdt_sim_kick_count++;
+}
+
+/*******************************************************************************
+* Function Name: analog_backend_wdt_caused_reset
+********************************************************************************
+* Summary:
+* Returns whether the modelled watchdog caused the last reset, once.
+*
+*******************************************************************************/
+bool analog_backend_wdt_caused_reset(void)
+{
+    bool reset = wdt_sim_reset_flag;
+
+    wdt_sim_reset_flag = false;
+    return reset;
+}
+
+/* [] END OF FILE */
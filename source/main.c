@@ -45,6 +45,17 @@
 #include "cybsp.h"
 #include "cy_retarget_io.h"
 #include "self_test.h"
+#include "self_test_sched.h"
+#include "self_test_adc_async.h"
+#include "self_test_trace.h"
+#include "self_test_log.h"
+#include "self_test_lp.h"
+#include "self_test_mailbox.h"
+#include "self_test_monitor.h"
+#include "self_test_proto.h"
+#include "self_test_nvlog.h"
+#include "self_test_post.h"
+#include "self_test_wdt.h"
 
 
 /*******************************************************************************
@@ -54,18 +65,213 @@
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
+#if SELF_TEST_DUAL_CORE
+/* Mailbox the CM0+ posts the self-test results to */
+CY_SECTION_SHAREDMEM static self_test_mailbox_t cm4_mailbox;
+#endif
 
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
+static void sched_result_cb(self_test_id_t id, uint8_t status, int32_t value);
+static void adc_async_result_cb(uint8_t status, int32_t ref_mv, int32_t vbg_mv);
+static void proto_tx(const uint8_t *data, uint32_t length);
+static bool cmd_is_test(uint8_t cmd);
+#if SELF_TEST_DUAL_CORE
+static void mailbox_result_cb(const self_test_mailbox_msg_t *msg);
+static void dual_core_loop(void);
+#endif
+
+/*******************************************************************************
+* Function Name: sched_result_cb
+********************************************************************************
+* Summary:
+* Called by the self-test scheduler when a periodic test completes. Failures
+* are logged for the console. The result store keeps the verdict changes and
+* a periodic summary of the runs, which keeps the flash wear independent of
+* the test rate.
+*
+* Parameters:
+*  id     : Test that completed
+*  status : OK_STATUS if the test passed
+*  value  : Measured value
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void sched_result_cb(self_test_id_t id, uint8_t status, int32_t value)
+{
+    if (OK_STATUS != status)
+    {
+        self_test_log(SELF_TEST_LOG_SCHED, status, (uint8_t)id, value, 0);
+    }
+    self_test_nvlog_periodic((uint8_t)id, status, value);
+}
+
+/*******************************************************************************
+* Function Name: adc_async_result_cb
+********************************************************************************
+* Summary:
+* Deferred result callback of the interrupt driven ADC test.
+*
+* Parameters:
+*  status : OK_STATUS if the test passed
+*  ref_mv : Reference channel reading in millivolts
+*  vbg_mv : Bandgap reading in millivolts, 0 if not converted separately
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void adc_async_result_cb(uint8_t status, int32_t ref_mv, int32_t vbg_mv)
+{
+    self_test_log(SELF_TEST_LOG_ADC_ASYNC, status, 0u, ref_mv, vbg_mv);
+}
+
+/*******************************************************************************
+* Function Name: proto_tx
+********************************************************************************
+* Summary:
+* Writes a binary protocol frame to the debug UART. The frame is written in
+* one piece from the main loop, so it never interleaves with log output.
+*
+* Parameters:
+*  data   : Frame bytes
+*  length : Number of bytes
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void proto_tx(const uint8_t *data, uint32_t length)
+{
+    size_t tx_length = length;
+
+    (void)cyhal_uart_write(&cy_retarget_io_uart_obj, (void *)data, &tx_length);
+}
+
+/*******************************************************************************
+* Function Name: cmd_is_test
+********************************************************************************
+* Summary:
+* Checks whether a command byte runs an interactive test on this device.
+*
+* Parameters:
+*  cmd : Command byte received on the console
+*
+* Return:
+*  true for a test command, false for any other byte
+*
+*******************************************************************************/
+static bool cmd_is_test(uint8_t cmd)
+{
+    switch (cmd)
+    {
+        case SELFTEST_CMD_ADC:
+        case SELFTEST_CMD_ADC_ASYNC:
+        case SELFTEST_CMD_ADC_BATCH:
+        case SELFTEST_CMD_ALL:
+#if SELF_TEST_HAS_COMPARATOR
+        case SELFTEST_COMPARATOR:
+        case SELFTEST_CMD_COMP_SWEEP:
+#endif
+#if SELF_TEST_HAS_OPAMP
+        case SELFTEST_CMD_OPAMP:
+        case SELFTEST_CMD_OPAMP_STEP:
+#endif
+            return true;
+        default:
+            return false;
+    }
+}
+
+#if SELF_TEST_DUAL_CORE
+/*******************************************************************************
+* Function Name: mailbox_result_cb
+********************************************************************************
+* Summary:
+* Called for each result the CM0+ posted. Failures are logged for the console,
+* as for the tests scheduled on this core.
+*
+* Parameters:
+*  msg : Result of one self test
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void mailbox_result_cb(const self_test_mailbox_msg_t *msg)
+{
+    sched_result_cb((self_test_id_t)msg->id, msg->status, msg->value);
+}
+
+/*******************************************************************************
+* Function Name: dual_core_loop
+********************************************************************************
+* Summary:
+* Main loop of the CM4 in the dual-core build. Publishes the mailbox, which
+* lets the CM0+ start the self tests, then handles their results and the
+* statistics command. Never returns.
+*
+* Parameters:
+*  none
+*
+* Return:
+*  void
+*
+*******************************************************************************/
+static void dual_core_loop(void)
+{
+    cy_rslt_t result;
+    uint8_t cmd;
+
+    analog_backend_time_init();
+    self_test_nvlog_init();
+
+    self_test_mailbox_publish(&cm4_mailbox);
+    printf("Analog SelfTests run on the CM0+. Press '%c' for the result statistics, "
+           "'%c' for the stored results.\r\n\n", SELFTEST_CMD_SCHED_STATS,
+            SELFTEST_CMD_HISTORY);
+
+    for (;;)
+    {
+        /* Application work goes here; the self tests cost this core only
+         * the handling of their results.
+         */
+        (void)self_test_mailbox_process(&cm4_mailbox, mailbox_result_cb,
+                SELF_TEST_MAILBOX_DEPTH);
+        self_test_nvlog_process();
+        (void)self_test_log_drain(1u);
+
+        if (0u == cyhal_uart_readable(&cy_retarget_io_uart_obj))
+        {
+            continue;
+        }
+        result = cyhal_uart_getc(&cy_retarget_io_uart_obj, &cmd, 0u);
+        if ((CY_RSLT_SUCCESS == result) && (SELFTEST_CMD_SCHED_STATS == cmd))
+        {
+            (void)self_test_log_drain(SELF_TEST_LOG_DEPTH);
+            printf("\r\n[Command] : Show CM0+ SelfTest result statistics\r\n");
+            self_test_mailbox_print_stats(&cm4_mailbox);
+        }
+        else if ((CY_RSLT_SUCCESS == result) && (SELFTEST_CMD_HISTORY == cmd))
+        {
+            (void)self_test_log_drain(SELF_TEST_LOG_DEPTH);
+            printf("\r\n[Command] : Show stored SelfTest results\r\n");
+            self_test_nvlog_print(SELF_TEST_NVLOG_PRINT_MAX);
+        }
+    }
+}
+#endif
 
 /*******************************************************************************
 * Function Name: main
 ********************************************************************************
 * Summary:
 * This is the main function. It performs Class-B safety test for Analog block.
-* SelfTest is performed for ADC, LPCOMP and Comparator based on the user 
-* command.
+* The self-test scheduler runs the tests for ADC, LPCOMP and OP-AMP
+* periodically in short steps. A test can also be run on user command.
 *
 * Parameters:
 *  none
@@ -78,16 +284,31 @@ int main(void)
 {
     cy_rslt_t result;
     uint8_t cmd;
+    const self_test_sched_config_t sched_config =
+    {
+        .tick_budget_us = SELF_TEST_SCHED_TICK_BUDGET_US,
+        .period_us = SELF_TEST_SCHED_PERIOD_US,
+        .coverage_us = SELF_TEST_SCHED_COVERAGE_US,
+        .max_period_us = SELF_TEST_SCHED_MAX_PERIOD_US,
+        .result_cb = sched_result_cb,
+    };
 
 #if defined (CY_DEVICE_SECURE)
     cyhal_wdt_t wdt_obj;
 
-    /* Clear watchdog timer so that it doesn't trigger a reset */
+    /* Clear watchdog timer so that it doesn't trigger a reset before the
+     * self-test supervisor starts it with its own timeout
+     */
     result = cyhal_wdt_init(&wdt_obj, cyhal_wdt_get_max_timeout_ms());
     CY_ASSERT(CY_RSLT_SUCCESS == result);
     cyhal_wdt_free(&wdt_obj);
 #endif /* #if defined (CY_DEVICE_SECURE) */
 
+#if SELF_TEST_FAST_POST
+    /* Start timing the start-up */
+    self_test_post_start();
+#endif
+
     /* Initialize the device and board peripherals */
     result = cybsp_init();
 
@@ -100,6 +321,24 @@ int main(void)
     /* Enable global interrupts */
     __enable_irq();
 
+#if SELF_TEST_FAST_POST && !SELF_TEST_DUAL_CORE
+    self_test_post_mark(SELF_TEST_POST_STAGE_BOARD);
+
+    /* Enable the AREF and the SAR ADC first and do the init work that does not
+     * need them while the reference settles
+     */
+    if (OK_STATUS != self_test_post_analog_start())
+    {
+        CY_ASSERT(0);
+    }
+    self_test_setup();
+    self_test_nvlog_init();
+    self_test_post_mark(SELF_TEST_POST_STAGE_INIT);
+
+    /* Check the ADC and the comparator before the console comes up */
+    (void)self_test_post_check();
+#endif
+
     /* Initialize retarget-io to use the debug UART port */
     result = cy_retarget_io_init_fc(CYBSP_DEBUG_UART_TX, CYBSP_DEBUG_UART_RX,
             CYBSP_DEBUG_UART_CTS,CYBSP_DEBUG_UART_RTS,CY_RETARGET_IO_BAUDRATE);
@@ -109,72 +348,208 @@ int main(void)
     {
         CY_ASSERT(0);
     }
-#if COMPONENT_CAT1A
-    /* Init AREF */
-    result = Cy_SysAnalog_Init(&self_test_aref_0_config);
-    if (CY_SAR_SUCCESS != result)
-    {
-        CY_ASSERT(0);
-    }
-    Cy_SysAnalog_Enable();
 
-    /* Initialize SAR ADC */
-    result = Cy_SAR_Init(CYBSP_DUT_SAR_ADC_HW, &CYBSP_DUT_SAR_ADC_config);
-    if (CY_SAR_SUCCESS != result)
+    /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
+    printf("\x1b[2J\x1b[;H");
+
+    printf("****************** "
+           "Class-B: Analog IP SAFETY TEST "
+           "****************** \r\n\n");
+    printf("Target family: %s\r\n\n", SELF_TEST_TARGET_NAME);
+
+#if SELF_TEST_DUAL_CORE
+    /* The self tests run on the CM0+, this core only receives the results */
+    dual_core_loop();
+#endif
+
+#if SELF_TEST_FAST_POST
+    self_test_post_mark(SELF_TEST_POST_STAGE_CONSOLE);
+#else
+    /* Initialize the AREF and the SAR ADC */
+    if (OK_STATUS != analog_backend_init())
     {
         CY_ASSERT(0);
     }
-    Cy_SAR_Enable(CYBSP_DUT_SAR_ADC_HW);
 
-#elif COMPONENT_CAT1C
-    /* Initialize the SAR2 module */
-    Cy_SAR2_Init(CYBSP_DUT_SAR_ADC_HW, &CYBSP_DUT_SAR_ADC_config);
-    /* Set ePASS MMIO reference buffer mode for bangap voltage */
-    Cy_SAR2_SetReferenceBufferMode(PASS0_EPASS_MMIO, CY_SAR2_REF_BUF_MODE_ON);
+    /* One-time LPCOMP, input pin and CTB setup for all test runs */
+    self_test_setup();
 #endif
 
-    /* \x1b[2J\x1b[;H - ANSI ESC sequence for clear screen */
-    printf("\x1b[2J\x1b[;H");
+#if !SELF_TEST_LOW_POWER_MODE
+    /* Display available commands, printed from the main loop */
+    self_test_log(SELF_TEST_LOG_MENU, SELF_TEST_LOG_INFO, 0u, 0, 0);
+#endif
+    self_test_log(SELF_TEST_LOG_SETUP, SELF_TEST_LOG_INFO, 0u,
+            (int32_t)self_test_setup_us(), 0);
 
-    printf("****************** "
-           "Class-B: Analog IP SAFETY TEST "
-           "****************** \r\n\n");
+    self_test_sched_init(&sched_config);
+    self_test_monitor_init(NULL);
 
-    /* Display available commands */
-    printf("Available commands \r\n");
-    printf("1 : Run SelfTest for ADC\r\n");
-#if COMPONENT_CAT1A
-    printf("2 : Run SelfTest for Comparator\r\n");
+#if SELF_TEST_FAST_POST
+    /* Print the power-on verdict with the breakdown of the time from main to
+     * the verdict, and store it in the mounted result store
+     */
+    self_test_post_report();
+#else
+    /* Mount the result store after the time base has been started */
+    self_test_nvlog_init();
 #endif
-#if (defined(CY_DEVICE_PSOC6A256K) || defined(CY_DEVICE_PSOC6ABLE2))
-    printf("3 : Run SelfTest for OP-AMP\r\n\n");
+    self_test_proto_init(proto_tx);
+
+    /* Start the watchdog supervisor; it reports a test that hung in the last
+     * run to the log and the result store.
+     */
+    self_test_wdt_init();
+
+#if SELF_TEST_LOW_POWER_MODE
+    /* The console is not polled: the core deep-sleeps between the scheduled
+     * tests and the LPCOMP supervises its input meanwhile.
+     */
+    self_test_lp_init();
+    for (;;)
+    {
+        self_test_lp_step();
+    }
 #endif
+
     for (;;)
     {
-        /* Check for commands entered */
-        result = cyhal_uart_getc(&cy_retarget_io_uart_obj, &cmd, UART_TIMEOUT_MS);
-        if (result != CY_RSLT_ERR_CSP_UART_GETC_TIMEOUT)
+        /* Kick the watchdog, unless a periodic test is past its deadline */
+        self_test_wdt_service();
+
+        if (self_test_proto_busy())
+        {
+            /* A batch queued over the binary protocol owns the analog blocks,
+             * run its next test.
+             */
+            self_test_proto_process();
+        }
+        else
+        {
+            /* Run the periodic tests for at most one tick budget */
+            self_test_sched_tick();
+        }
+
+        /* Write the queued results to the result store, without waiting on
+         * the flash
+         */
+        self_test_nvlog_process();
+
+        /* Evaluate a completed interrupt driven ADC test */
+        self_test_adc_async_process();
+
+        /* Fold the recorded phase timings into their statistics */
+        self_test_trace_collect();
+
+        /* Print one pending log event per pass, so the tests never wait on
+         * the UART and a tick is delayed by at most one line of output.
+         */
+        (void)self_test_log_drain(1u);
+
+        /* Check for commands entered, without waiting */
+        if (0u == cyhal_uart_readable(&cy_retarget_io_uart_obj))
+        {
+            continue;
+        }
+        result = cyhal_uart_getc(&cy_retarget_io_uart_obj, &cmd, 0u);
+        if ((result == CY_RSLT_SUCCESS) && self_test_proto_rx_byte(cmd))
         {
-            if (SELFTEST_CMD_ADC == cmd)
+            /* Binary protocol frame byte. A queued batch takes over the analog
+             * blocks from the periodic tests.
+             */
+            if (self_test_proto_busy())
+            {
+                self_test_sched_abort();
+            }
+            continue;
+        }
+        if (result == CY_RSLT_SUCCESS)
+        {
+            /* Print the pending events before the command output */
+            (void)self_test_log_drain(SELF_TEST_LOG_DEPTH);
+
+            if (SELFTEST_CMD_SCHED_STATS == cmd)
+            {
+                printf("\r\n[Command] : Show periodic SelfTest statistics\r\n");
+                self_test_sched_print_stats();
+                continue;
+            }
+            if (SELFTEST_CMD_TRACE == cmd)
+            {
+                printf("\r\n[Command] : Show SelfTest phase timing and watchdog budgets\r\n");
+                self_test_trace_print();
+                self_test_wdt_print_stats();
+                continue;
+            }
+            if (SELFTEST_CMD_MONITOR == cmd)
+            {
+                printf("\r\n[Command] : Show ADC plausibility monitor\r\n");
+                self_test_monitor_print_stats();
+                continue;
+            }
+            if (SELFTEST_CMD_HISTORY == cmd)
+            {
+                printf("\r\n[Command] : Show stored SelfTest results\r\n");
+                self_test_nvlog_print(SELF_TEST_NVLOG_PRINT_MAX);
+                continue;
+            }
+
+            /* Any other byte, such as the CR/LF a terminal sends after a key,
+             * leaves the periodic run in progress alone.
+             */
+            if (!cmd_is_test(cmd))
+            {
+                continue;
+            }
+
+            /* The interactive tests take over the analog blocks */
+            self_test_sched_abort();
+
+            if (SELFTEST_CMD_ADC_ASYNC == cmd)
+            {
+                printf("\r\n[Command] : Run SelfTest for ADC (interrupt driven)\r\n");
+                (void)self_test_adc_async_start(adc_async_result_cb);
+            }
+            else if (SELFTEST_CMD_ADC_BATCH == cmd)
+            {
+                printf("\r\n[Command] : Run SelfTest for ADC (oversampled)\r\n");
+                adc_batch_test();
+            }
+            else if (SELFTEST_CMD_ALL == cmd)
+            {
+                printf("\r\n[Command] : Run combined SelfTest in one scan\r\n");
+                analog_all_test();
+            }
+            else if (SELFTEST_CMD_ADC == cmd)
             {
                 printf("\r\n[Command] : Run SelfTest for ADC\r\n");
                 adc_test();
 
             }
-#if COMPONENT_CAT1A
+#if SELF_TEST_HAS_COMPARATOR
             else if (SELFTEST_COMPARATOR == cmd)
             {
                 printf("\r\n[Command] : Run SelfTest for Comparator\r\n");
                 comparator_test();
             }
+            else if (SELFTEST_CMD_COMP_SWEEP == cmd)
+            {
+                printf("\r\n[Command] : Run SelfTest sweep for both Comparator channels\r\n");
+                comparator_sweep_test();
+            }
 #endif
-#if (defined(CY_DEVICE_PSOC6A256K) || defined(CY_DEVICE_PSOC6ABLE2))
+#if SELF_TEST_HAS_OPAMP
             else if (SELFTEST_CMD_OPAMP == cmd)
             {
-                printf("\r\n1[Command] : Run SelfTest for OP-AMP\r\n");
+                printf("\r\n[Command] : Run SelfTest for OP-AMP\r\n");
                 opamp_test();
 
             }
+            else if (SELFTEST_CMD_OPAMP_STEP == cmd)
+            {
+                printf("\r\n[Command] : Run SelfTest for OP-AMP step response\r\n");
+                opamp_step_test();
+            }
 #endif
         }
     }
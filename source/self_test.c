@@ -41,15 +41,191 @@
 * so agrees to indemnify Cypress against all liability.
 *******************************************************************************/
 
-#include "cyhal.h"
-#include "cybsp.h"
-#include "cy_retarget_io.h"
+#include <string.h>
 #include "self_test.h"
+#include "self_test_log.h"
+#include "self_test_trace.h"
+#include "self_test_monitor.h"
+#include "self_test_nvlog.h"
+#include "self_test_wdt.h"
 
 
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Bit of a reference point in the failure mask of ref_run */
+#define REF_POINT_BIT(index)               (1u << (index))
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Check of one reference point, returns OK_STATUS or ERROR_STATUS */
+typedef uint8_t (*ref_check_fn_t)(const self_test_ref_point_t *point);
+
+/* Position of each signal in the scan of the combined test */
+enum
+{
+    ALL_IDX_REF = 0u,
+#if (VBG_CHANNEL != ADC_REF_CHANNEL)
+    ALL_IDX_VBG,
+#endif
+#if SELF_TEST_HAS_OPAMP
+    ALL_IDX_OPAMP,
+#endif
+    ALL_IDX_COUNT
+};
+
 /*******************************************************************************
 * Global Variables
 *******************************************************************************/
+/* SAR channels converted by the single scan of the combined test */
+static const uint32_t all_channels[ALL_IDX_COUNT] =
+{
+    [ALL_IDX_REF] = ADC_REF_CHANNEL,
+#if (VBG_CHANNEL != ADC_REF_CHANNEL)
+    [ALL_IDX_VBG] = VBG_CHANNEL,
+#endif
+#if SELF_TEST_HAS_OPAMP
+    [ALL_IDX_OPAMP] = OPAMP_SAR_CHANNEL,
+#endif
+};
+
+/* One-time setup of the analog blocks, see self_test_setup */
+static bool setup_done;
+static uint32_t setup_ticks;
+
+#if SELF_TEST_HAS_OPAMP
+/* Opamp output captured by the step response test, in millivolts */
+static int16_t opamp_step_samples[OPAMP_STEP_SAMPLES];
+#endif
+
+/*******************************************************************************
+* Function Name: self_test_setup
+********************************************************************************
+* Summary:
+* Performs the one-time setup of the analog blocks under test: the LPCOMP is
+* initialized and enabled and its input pins are configured for analog
+* operation, and the CTB opamp is initialized and enabled. The blocks stay
+* enabled, so the test runs only apply the register changes they need, such as
+* the comparator input routing. The duration of the setup is recorded
+* separately from the test runs. Calling it again has no effect.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_setup(void)
+{
+    uint32_t start;
+    uint32_t t;
+
+    if (setup_done)
+    {
+        return;
+    }
+
+    analog_backend_time_init();
+    start = analog_backend_cpu_ticks();
+    t = start;
+#if SELF_TEST_HAS_COMPARATOR
+    analog_backend_comp_setup();
+    t = self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_SETUP, t);
+#endif
+#if SELF_TEST_HAS_OPAMP
+    analog_backend_opamp_setup();
+    t = self_test_trace_phase(SELF_TEST_ID_OPAMP, SELF_TEST_PHASE_SETUP, t);
+#endif
+    setup_ticks = t - start;
+    setup_done = true;
+}
+
+/*******************************************************************************
+* Function Name: self_test_setup_us
+********************************************************************************
+* Summary:
+* Returns the duration of the one-time setup done by self_test_setup.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  Setup time in microseconds
+*
+*******************************************************************************/
+uint32_t self_test_setup_us(void)
+{
+    return setup_ticks / analog_backend_cpu_ticks_per_us();
+}
+
+/*******************************************************************************
+* Function Name: ref_run
+********************************************************************************
+* Summary:
+* Checks every point of a reference set in one pass. Each point is logged with
+* its index, expected value and channel, and its duration is traced as a
+* conversion phase of the given test, which the watchdog supervisor checks
+* against its budget. The verdict is appended to the result store with the
+* failure mask as its value.
+*
+* Parameters:
+*  set     : Reference points
+*  check   : Check of one point
+*  id      : Test the points belong to
+*  prompt  : Log event asking for the reference signal
+*  result  : Log event of the result of a point
+*
+* Return :
+*  Mask of the failed points, bit n set if point n failed
+*
+*******************************************************************************/
+static uint32_t ref_run(const self_test_ref_set_t *set, ref_check_fn_t check,
+        self_test_id_t id, self_test_log_event_t prompt, self_test_log_event_t result)
+{
+    const self_test_ref_point_t *point;
+    uint32_t failed = 0u;
+    uint32_t t;
+    uint8_t status;
+    uint8_t i;
+
+    self_test_wdt_begin(id, false);
+    for (i = 0u; i < set->count; i++)
+    {
+        point = &set->points[i];
+        self_test_log(prompt, SELF_TEST_LOG_INFO, i, point->expected_mv, point->channel);
+
+        t = analog_backend_cpu_ticks();
+        status = check(point);
+        t = self_test_trace_phase(id, SELF_TEST_PHASE_CONVERT, t);
+
+        if (OK_STATUS != status)
+        {
+            failed |= REF_POINT_BIT(i);
+        }
+        self_test_log(result, status, i, point->expected_mv, point->channel);
+        (void)self_test_trace_phase(id, SELF_TEST_PHASE_REPORT, t);
+    }
+    self_test_wdt_end(id, true);
+    (void)self_test_nvlog_append((uint8_t)id,
+            (uint8_t)((0u == failed) ? OK_STATUS : ERROR_STATUS), (int32_t)failed);
+
+    return failed;
+}
+
+/*******************************************************************************
+* Function Name: adc_ref_check
+********************************************************************************
+* Summary:
+* Runs the Safety Test Library ADC test on one reference point.
+*
+*******************************************************************************/
+static uint8_t adc_ref_check(const self_test_ref_point_t *point)
+{
+    return analog_backend_adc_selftest(point->channel, point->expected_mv,
+            point->accuracy_mv, point->vbg_channel);
+}
 
 /*******************************************************************************
 * Function Name: adc_test
@@ -58,8 +234,9 @@
 * This function performs self test on the ADC block by  measuring the voltage on
 * a specific channel and comparing it against the expected result within a defined
 * accuracy range, this test validates the accuracy and functionality of the ADC in
-* converting analog signals to digital values. The test is performed on two reference
-* voltages VDD/3) and (2VDD/3), which is configured using the macro ADC_REF_VOLTAGE2.
+* converting analog signals to digital values. Every reference point of
+* self_test_adc_refs, (VDDA / 3) and with ADC_REF_VOLTAGE2 also (2VDDA / 3), is
+* checked in one pass.
 *
 * Parameters:
 *  none
@@ -70,36 +247,233 @@
 *******************************************************************************/
 void adc_test(void)
 {
-#if ADC_REF_VOLTAGE2
-    printf("Ensure that a (2VDDA / 3) signal is connected to ADC channel 0.\r\n");
-    if (OK_STATUS != SelfTests_ADC(CYBSP_DUT_SAR_ADC_HW, 0x00u, ANALOG_ADC_SAR_RESULT2,
-            ANALOG_ADC_ACURACCY, VBG_CHANNEL, 1))
+    (void)ref_run(&self_test_adc_refs, adc_ref_check, SELF_TEST_ID_ADC,
+            SELF_TEST_LOG_ADC_PROMPT, SELF_TEST_LOG_ADC);
+}
+
+/*******************************************************************************
+* Function Name: adc_batch_convert
+********************************************************************************
+* Summary:
+* Converts one channel and adds the result to a batch, accounting the CPU time
+* of the conversion and of the statistics update separately. Returns
+* ERROR_STATUS if the conversion timed out.
+*
+*******************************************************************************/
+static uint8_t adc_batch_convert(uint32_t channel, self_test_stats_t *stats,
+        adc_batch_result_t *result)
+{
+    uint32_t start = analog_backend_cpu_ticks();
+    uint32_t converted;
+    uint8_t status;
+    int32_t mv;
+
+    status = self_test_wdt_adc_convert(SELF_TEST_ID_ADC, channel, &mv);
+    converted = analog_backend_cpu_ticks();
+
+    self_test_stats_add(stats, mv);
+
+    result->stats_ticks += analog_backend_cpu_ticks() - converted;
+    result->conv_ticks += converted - start;
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: adc_batch_stable
+********************************************************************************
+* Summary:
+* Checks the spread and the variance of the samples of one channel of a batch.
+*
+*******************************************************************************/
+static bool adc_batch_stable(const self_test_stats_t *stats, uint32_t max_variance_q)
+{
+    return ((stats->max - stats->min) <= ADC_BATCH_MAX_SPREAD_MV) &&
+            (self_test_stats_variance_q(stats) <= max_variance_q);
+}
+
+/*******************************************************************************
+* Function Name: adc_batch_run
+********************************************************************************
+* Summary:
+* Oversampled ADC test. Takes a batch of samples of the reference channel and,
+* if the bandgap has its own channel, of the bandgap channel. The pass/fail
+* decision is made on the batch statistics: the mean of the reference channel
+* must be within ANALOG_ADC_ACURACCY of the expected result, and the spread of
+* each channel within ADC_BATCH_MAX_SPREAD_MV and its standard deviation within
+* ADC_BATCH_MAX_STDDEV_MV. The bandgap has no expected level of its own; a
+* noisy or drifting bandgap shows as a spread of its samples. A conversion
+* that times out ends the batch and fails the test.
+*
+* Parameters:
+*  samples : Number of samples per channel, 1 to SELF_TEST_STATS_MAX_SAMPLES
+*  result  : Returns the statistics and the cost of the batch
+*
+* Return :
+*  OK_STATUS if the test passed, ERROR_STATUS otherwise
+*
+*******************************************************************************/
+uint8_t adc_batch_run(uint32_t samples, adc_batch_result_t *result)
+{
+    const int32_t expected = ADC_REF_EXPECTED;
+    const int32_t min_mean_q = (expected - ANALOG_ADC_ACURACCY) * (1 << SELF_TEST_STATS_Q);
+    const int32_t max_mean_q = (expected + ANALOG_ADC_ACURACCY) * (1 << SELF_TEST_STATS_Q);
+    const uint32_t max_variance_q = ((uint32_t)ADC_BATCH_MAX_STDDEV_MV *
+            (uint32_t)ADC_BATCH_MAX_STDDEV_MV) << SELF_TEST_STATS_Q;
+    uint8_t status = OK_STATUS;
+    int32_t mean_q;
+    uint32_t i;
+
+    CY_ASSERT((0u < samples) && (samples <= SELF_TEST_STATS_MAX_SAMPLES));
+
+    self_test_stats_reset(&result->ref);
+    self_test_stats_reset(&result->vbg);
+    result->conv_ticks = 0u;
+    result->stats_ticks = 0u;
+
+    self_test_wdt_begin(SELF_TEST_ID_ADC, false);
+    for (i = 0u; (i < samples) && (OK_STATUS == status); i++)
     {
-        /* Process error */
-        printf("Error: ADC SelfTest failed for 2VDD/3 signal.\r\n");
+        status = adc_batch_convert(ADC_REF_CHANNEL, &result->ref, result);
+        if ((VBG_CHANNEL != ADC_REF_CHANNEL) && (OK_STATUS == status))
+        {
+            status = adc_batch_convert(VBG_CHANNEL, &result->vbg, result);
+        }
     }
-    else
+    self_test_wdt_end(SELF_TEST_ID_ADC, true);
+
+    mean_q = self_test_stats_mean_q(&result->ref);
+    if ((OK_STATUS != status) || (mean_q < min_mean_q) || (mean_q > max_mean_q) ||
+        !adc_batch_stable(&result->ref, max_variance_q) ||
+        ((0u != result->vbg.count) && !adc_batch_stable(&result->vbg, max_variance_q)))
     {
-        printf("SUCCESS: ADC SelfTest passed for 2VDD/3 signal.\r\n");
+        return ERROR_STATUS;
     }
 
-#else
-    printf("Ensure that a (VDDA / 3) signal is connected to ADC channel 0.\r\n");
+    return OK_STATUS;
+}
 
-    if (OK_STATUS != SelfTests_ADC(CYBSP_DUT_SAR_ADC_HW, 0x00u, ANALOG_ADC_SAR_RESULT1,
-            ANALOG_ADC_ACURACCY, VBG_CHANNEL, 1))
+/*******************************************************************************
+* Function Name: adc_batch_log_stats
+********************************************************************************
+* Summary:
+* Logs the statistics of one channel of an oversampled batch.
+*
+*******************************************************************************/
+static void adc_batch_log_stats(uint8_t channel, const self_test_stats_t *stats)
+{
+    self_test_log(SELF_TEST_LOG_ADC_BATCH_MEAN, SELF_TEST_LOG_INFO, channel,
+            self_test_stats_mean_q(stats), (int32_t)self_test_stats_variance_q(stats));
+    self_test_log(SELF_TEST_LOG_ADC_BATCH_RANGE, SELF_TEST_LOG_INFO, channel,
+            stats->min, stats->max);
+}
+
+/*******************************************************************************
+* Function Name: adc_batch_test
+********************************************************************************
+* Summary:
+* Runs the oversampled ADC test with ADC_BATCH_SAMPLES samples per channel and
+* logs the batch statistics and the cost per sample.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void adc_batch_test(void)
+{
+    adc_batch_result_t result;
+    uint32_t ticks_per_us = analog_backend_cpu_ticks_per_us();
+    uint32_t conversions = ADC_BATCH_SAMPLES;
+    uint8_t status;
+
+    if (VBG_CHANNEL != ADC_REF_CHANNEL)
     {
-        /* Process error */
-        printf("Error: ADC SelfTest failed for VDD/3 signal.\r\n");
+        conversions *= 2u;
     }
-    else
+
+    status = adc_batch_run(ADC_BATCH_SAMPLES, &result);
+
+    adc_batch_log_stats(SELF_TEST_LOG_CHANNEL_REF, &result.ref);
+    if (0u != result.vbg.count)
     {
-        printf("SUCCESS: ADC SelfTest passed for VDD/3 signal.\r\n");
+        adc_batch_log_stats(SELF_TEST_LOG_CHANNEL_VBG, &result.vbg);
     }
+    self_test_log(SELF_TEST_LOG_ADC_BATCH_COST, SELF_TEST_LOG_INFO, 0u,
+            (int32_t)(((uint64_t)result.conv_ticks * 1000u) /
+                    ((uint64_t)ticks_per_us * conversions)),
+            (int32_t)(((uint64_t)result.stats_ticks * 1000u) /
+                    ((uint64_t)ticks_per_us * conversions)));
+    self_test_log(SELF_TEST_LOG_ADC_BATCH, status, 0u, 0, 0);
+}
+
+/*******************************************************************************
+* Function Name: analog_all_test
+********************************************************************************
+* Summary:
+* Runs the ADC and opamp checks from a single SAR scan. The CTB is enabled by
+* self_test_setup. The scan converts the reference channel, the bandgap
+* channel (if it has its own channel) and the opamp output channel, and every
+* check is evaluated from that one scan, so the SAR is set up once instead of
+* once per test. The results are stored and traced like those of adc_test and
+* opamp_test, with the mask of the failed reference points as the value.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void analog_all_test(void)
+{
+    int16_t counts[ALL_IDX_COUNT];
+    uint32_t start = analog_backend_cpu_ticks();
+    uint32_t elapsed;
+    uint32_t t;
+    int32_t mv;
+    uint8_t adc_status;
+#if SELF_TEST_HAS_OPAMP
+    uint8_t opamp_status;
+#endif
+
+    self_test_wdt_begin(SELF_TEST_ID_ADC, false);
+    analog_backend_adc_scan(all_channels, ALL_IDX_COUNT, counts);
+    t = self_test_trace_phase(SELF_TEST_ID_ADC, SELF_TEST_PHASE_CONVERT, start);
+
+    mv = analog_backend_adc_counts_to_mv(ADC_REF_CHANNEL, counts[ALL_IDX_REF]);
+    adc_status = (uint8_t)(self_test_adc_ref_ok(mv) ? OK_STATUS : ERROR_STATUS);
+    t = self_test_trace_phase(SELF_TEST_ID_ADC, SELF_TEST_PHASE_EVALUATE, t);
+#if SELF_TEST_HAS_OPAMP
+    mv = analog_backend_adc_counts_to_mv(OPAMP_SAR_CHANNEL, counts[ALL_IDX_OPAMP]);
+    opamp_status = (uint8_t)(self_test_opamp_ok(mv) ? OK_STATUS : ERROR_STATUS);
+    t = self_test_trace_phase(SELF_TEST_ID_OPAMP, SELF_TEST_PHASE_EVALUATE, t);
+#endif
+    self_test_wdt_end(SELF_TEST_ID_ADC, true);
+
+    elapsed = t - start;
+
+    self_test_monitor_feed_scan(all_channels, counts, ALL_IDX_COUNT);
+    self_test_log(SELF_TEST_LOG_ALL_ADC, adc_status, 0u, 0, 0);
+    (void)self_test_nvlog_append((uint8_t)SELF_TEST_ID_ADC, adc_status,
+            (int32_t)((OK_STATUS == adc_status) ? 0u : REF_POINT_BIT(0u)));
+#if (VBG_CHANNEL != ADC_REF_CHANNEL)
+    self_test_log(SELF_TEST_LOG_ALL_VBG, SELF_TEST_LOG_INFO, 0u,
+            analog_backend_adc_counts_to_mv(VBG_CHANNEL, counts[ALL_IDX_VBG]), 0);
+#endif
+#if SELF_TEST_HAS_OPAMP
+    self_test_log(SELF_TEST_LOG_ALL_OPAMP, opamp_status, 0u, 0, 0);
+    (void)self_test_nvlog_append((uint8_t)SELF_TEST_ID_OPAMP, opamp_status,
+            (int32_t)((OK_STATUS == opamp_status) ? 0u : REF_POINT_BIT(0u)));
 #endif
+    self_test_log(SELF_TEST_LOG_ALL_TIME, SELF_TEST_LOG_INFO, 0u,
+            (int32_t)(elapsed / analog_backend_cpu_ticks_per_us()), 0);
+    (void)self_test_trace_phase(SELF_TEST_ID_ADC, SELF_TEST_PHASE_REPORT, t);
 }
 
-#if COMPONENT_CAT1A
+#if SELF_TEST_HAS_COMPARATOR
 /*******************************************************************************
 * Function Name: comparator_test
 ********************************************************************************
@@ -107,7 +481,8 @@ void adc_test(void)
 * This function performs self test on the comparator block by verifying if the
 * comparator output aligns with the expected result. The comparator is connected
 * to GPIO pins, thus allowing selection of two voltage references on AMUXBUS A
-* and AMUXBUS B.
+* and AMUXBUS B. The LPCOMP and the pins are configured by self_test_setup, so
+* a run only swaps the AMUXBUS selection of the two pins.
 *
 * Parameters:
 *  none
@@ -118,58 +493,210 @@ void adc_test(void)
 *******************************************************************************/
 void comparator_test(void)
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
+    uint32_t start;
+    uint32_t elapsed;
+    uint32_t failed;
+    uint8_t status;
 
-    /*Initialize the LPCOMP with device configurator generated structure*/
-    Cy_LPComp_Init(CYBSP_DUT_LPCOMP_HW, CYBSP_DUT_LPCOMP_CHANNEL ,
-            &CYBSP_DUT_LPCOMP_config);
-    if (result != CY_RSLT_SUCCESS)
-    {
-        CY_ASSERT(0);
-    }
-    Cy_LPComp_Enable(CYBSP_DUT_LPCOMP_HW, CYBSP_DUT_LPCOMP_CHANNEL);
+    self_test_setup();
 
     /* Apply lower voltage to positive input */
-    printf("Apply lower voltage to positive input (CYBSP_DUT_LPCOMP_VPLUS_PIN).\r\n");
+    self_test_log(SELF_TEST_LOG_COMP_PROMPT, SELF_TEST_LOG_INFO, 0u, 0, 0);
 
-    Cy_GPIO_Pin_FastInit(CYBSP_DUT_LPCOMP_VPLUS_PORT, CYBSP_DUT_LPCOMP_VPLUS_PIN,
-            CY_GPIO_DM_ANALOG, 0u, HSIOM_SEL_AMUXB);
-    Cy_GPIO_Pin_FastInit(CYBSP_DUT_LPCOMP_VMINUS_PORT, CYBSP_DUT_LPCOMP_VMINUS_PIN,
-            CY_GPIO_DM_ANALOG, 0u, HSIOM_SEL_AMUXA);
+    start = analog_backend_cpu_ticks();
+    failed = comparator_run();
+    elapsed = analog_backend_cpu_ticks() - start;
+
+    self_test_log(SELF_TEST_LOG_COMP_LOW,
+            (uint8_t)((0u != (failed & COMP_LOW_BIT)) ? ERROR_STATUS : OK_STATUS), 0u, 0, 0);
+    self_test_log(SELF_TEST_LOG_COMP_HIGH,
+            (uint8_t)((0u != (failed & COMP_HIGH_BIT)) ? ERROR_STATUS : OK_STATUS), 0u, 0, 0);
+    status = (uint8_t)((0u == failed) ? OK_STATUS : ERROR_STATUS);
+    (void)self_test_nvlog_append((uint8_t)SELF_TEST_ID_COMPARATOR, status, (int32_t)failed);
+    self_test_log(SELF_TEST_LOG_COMP_TIME, SELF_TEST_LOG_INFO, 0u,
+            (int32_t)(elapsed / analog_backend_cpu_ticks_per_us()),
+            (int32_t)self_test_setup_us());
+    (void)self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_REPORT,
+            start + elapsed);
+}
 
-    if(OK_STATUS != SelfTests_Comparator(CYBSP_DUT_LPCOMP_HW, CYBSP_DUT_LPCOMP_CHANNEL,
-            ANALOG_COMP_RESULT2))
+/*******************************************************************************
+* Function Name: comparator_run
+********************************************************************************
+* Summary:
+* Runs the two checks of the comparator test with the Safety Test Library:
+* the lower voltage on the positive input, then the higher one. Each check
+* swaps the AMUXBUS selection of the two input pins and waits COMP_SETTLE_US
+* for the output to settle, as the sweep groups and the scheduler do.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  Mask of the failed checks, COMP_LOW_BIT and COMP_HIGH_BIT
+*
+*******************************************************************************/
+uint32_t comparator_run(void)
+{
+    uint32_t failed = 0u;
+    uint32_t t;
+
+    self_test_setup();
+    self_test_wdt_begin(SELF_TEST_ID_COMPARATOR, false);
+
+    t = analog_backend_cpu_ticks();
+    analog_backend_comp_route(ANALOG_COMP_ROUTE_VPLUS_AMUXB);
+    t = self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_ROUTE, t);
+    analog_backend_delay_us(COMP_SETTLE_US);
+    t = self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_SETTLE, t);
+    if (OK_STATUS != analog_backend_comp_selftest(ANALOG_COMP_RESULT2))
     {
-        /* Process error */
-        printf("Error: LPCOMP lower voltage test fail\r\n");
+        failed |= COMP_LOW_BIT;
     }
-    else
+    t = self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_EVALUATE, t);
+
+    /* Apply higher voltage to positive input */
+    analog_backend_comp_route(ANALOG_COMP_ROUTE_VPLUS_AMUXA);
+    t = self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_ROUTE, t);
+    analog_backend_delay_us(COMP_SETTLE_US);
+    t = self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_SETTLE, t);
+    if (OK_STATUS != analog_backend_comp_selftest(ANALOG_COMP_RESULT1))
     {
-        printf("SUCCESS: LPCOMP lower voltage test\r\n");
+        failed |= COMP_HIGH_BIT;
     }
+    (void)self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_EVALUATE, t);
+    self_test_wdt_end(SELF_TEST_ID_COMPARATOR, true);
 
+    return failed;
+}
 
-    /* Apply higher voltage to positive input */
-    Cy_GPIO_Pin_FastInit(CYBSP_DUT_LPCOMP_VPLUS_PORT, CYBSP_DUT_LPCOMP_VPLUS_PIN,
-            CY_GPIO_DM_ANALOG, 0u, HSIOM_SEL_AMUXA);
-    Cy_GPIO_Pin_FastInit(CYBSP_DUT_LPCOMP_VMINUS_PORT, CYBSP_DUT_LPCOMP_VMINUS_PIN,
-            CY_GPIO_DM_ANALOG, 0u, HSIOM_SEL_AMUXB);
+/*******************************************************************************
+* Function Name: comparator_sweep_run
+********************************************************************************
+* Summary:
+* Runs the comparator sweep of self_test_comp_sweep over both LPCOMP channels.
+* The routing changes are batched per group: the input pins and the inputs of
+* all channels of the group are switched at once, followed by a single
+* COMP_SETTLE_US settling wait, then the output of every channel is checked.
+* The inputs and pins are then restored for normal operation.
+*
+* Parameters:
+*  checks : Number of checks made, at most 32
+*
+* Return :
+*  Mask of the failed checks, bit n set if check n failed
+*
+*******************************************************************************/
+uint32_t comparator_sweep_run(uint32_t *checks)
+{
+    const self_test_comp_group_t *group;
+    uint32_t failed = 0u;
+    uint32_t n = 0u;
+    uint32_t t;
+    uint32_t ch;
+    uint8_t i;
 
-    if(OK_STATUS != SelfTests_Comparator(CYBSP_DUT_LPCOMP_HW, CYBSP_DUT_LPCOMP_CHANNEL,
-            ANALOG_COMP_RESULT1))
-    {
-        /* Process error */
-        printf("Error: LPCOMP higher voltage test fail\r\n");
-    }
-    else
+    self_test_setup();
+    self_test_wdt_begin(SELF_TEST_ID_COMPARATOR, false);
+
+    t = analog_backend_cpu_ticks();
+    for (i = 0u; i < self_test_comp_sweep.count; i++)
     {
-        printf("SUCCESS: LPCOMP higher voltage test\r\n");
+        group = &self_test_comp_sweep.groups[i];
+
+        analog_backend_comp_route(group->route);
+        analog_backend_comp_connect(group->channel_mask, group->vplus, group->vminus);
+        t = self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_ROUTE, t);
+        analog_backend_delay_us(COMP_SETTLE_US);
+        t = self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_SETTLE, t);
+
+        for (ch = 0u; ch < ANALOG_COMP_CHANNELS; ch++)
+        {
+            if (0u == (group->channel_mask & (1uL << ch)))
+            {
+                continue;
+            }
+            if (group->expected != analog_backend_comp_read_channel(ch))
+            {
+                failed |= 1uL << n;
+            }
+            n++;
+        }
+        t = self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_EVALUATE, t);
     }
 
+    analog_backend_comp_connect((1uL << ANALOG_COMP_CHANNELS) - 1u, ANALOG_COMP_INPUT_PIN,
+            ANALOG_COMP_INPUT_PIN);
+    analog_backend_comp_route(ANALOG_COMP_ROUTE_VPLUS_AMUXB);
+    (void)self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_ROUTE, t);
+    self_test_wdt_end(SELF_TEST_ID_COMPARATOR, true);
+
+    *checks = n;
+    return failed;
+}
+
+/*******************************************************************************
+* Function Name: comparator_sweep_test
+********************************************************************************
+* Summary:
+* Runs the two-step comparator test and the comparator sweep back to back and
+* reports the result of the sweep and the time of both, in total and per
+* check, so that the coverage gained can be weighed against the time spent.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void comparator_sweep_test(void)
+{
+    uint32_t ticks_per_us = analog_backend_cpu_ticks_per_us();
+    uint32_t start;
+    uint32_t two_step;
+    uint32_t sweep;
+    uint32_t failed;
+    uint32_t checks;
+    uint8_t status;
+
+    self_test_setup();
+    self_test_log(SELF_TEST_LOG_COMP_PROMPT, SELF_TEST_LOG_INFO, 0u, 0, 0);
+
+    start = analog_backend_cpu_ticks();
+    (void)comparator_run();
+    two_step = analog_backend_cpu_ticks() - start;
+
+    start += two_step;
+    failed = comparator_sweep_run(&checks);
+    sweep = analog_backend_cpu_ticks() - start;
+
+    status = (uint8_t)((0u == failed) ? OK_STATUS : ERROR_STATUS);
+    self_test_log(SELF_TEST_LOG_COMP_SWEEP, status, (uint8_t)checks, (int32_t)failed,
+            (int32_t)self_test_comp_sweep.count);
+    self_test_log(SELF_TEST_LOG_COMP_SWEEP_TIME, SELF_TEST_LOG_INFO, (uint8_t)checks,
+            (int32_t)(((uint64_t)sweep * 1000u) / ticks_per_us),
+            (int32_t)(((uint64_t)two_step * 1000u) / ticks_per_us));
+    (void)self_test_nvlog_append((uint8_t)SELF_TEST_ID_COMPARATOR, status, (int32_t)failed);
+    (void)self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_REPORT,
+            start + sweep);
 }
 #endif
 
-#if (defined(CY_DEVICE_PSOC6A256K) || defined(CY_DEVICE_PSOC6ABLE2))
+#if SELF_TEST_HAS_OPAMP
+/*******************************************************************************
+* Function Name: opamp_ref_check
+********************************************************************************
+* Summary:
+* Runs the Safety Test Library opamp test on one reference point.
+*
+*******************************************************************************/
+static uint8_t opamp_ref_check(const self_test_ref_point_t *point)
+{
+    return analog_backend_opamp_selftest(point->expected_mv, point->accuracy_mv,
+            point->channel);
+}
+
 /*******************************************************************************
 * Function Name: opamp_test
 ********************************************************************************
@@ -179,9 +706,7 @@ void comparator_test(void)
 * test ensures that the opamp operates correctly and generates the expected output
 * voltage. The opamp is connected to the ADC and utilizes GPIO pins as a
 * multiplexer to choose various voltage references on AMUXBUS A and AMUXBUS B.
-* The test is performed on two reference voltages VDD/3) and (2VDD/3), which is
-* configured using the macro ADC_REF_VOLTAGE2.
-* .
+* Every reference point of self_test_opamp_refs is checked in one pass.
 *
 * Parameters:
 *  none
@@ -192,65 +717,162 @@ void comparator_test(void)
 *******************************************************************************/
 void opamp_test(void)
 {
-    cy_rslt_t result = CY_RSLT_SUCCESS;
-
-    cy_stc_ctb_config_t CYBSP_DUT_CTB_config = {
-
-        /* Opamp0 configuration */
-        .oa0Power = CYBSP_DUT_OPAMP_config.oaPower,
-        .oa0Mode  = CYBSP_DUT_OPAMP_config.oaMode,
-        .oa0Pump = CYBSP_DUT_OPAMP_config.oaPump,
-        .oa0CompEdge  = CYBSP_DUT_OPAMP_config.oaCompEdge,
-        .oa0CompLevel = CYBSP_DUT_OPAMP_config.oaCompLevel,
-        .oa0CompBypass  = CYBSP_DUT_OPAMP_config.oaCompBypass,
-        .oa0CompHyst = CYBSP_DUT_OPAMP_config.oaCompHyst,
-        .oa0CompIntrEn  = CYBSP_DUT_OPAMP_config.oaCompIntrEn,
-    };
-
-    /*Initialize the OPAMP0 with device configurator generated structure*/
-     result = Cy_CTB_Init(CYBSP_DUT_OPAMP_HW, &CYBSP_DUT_CTB_config);
-     if (result != CY_CTB_SUCCESS)
-     {
-         CY_ASSERT(0);
-     }
-      /*Enable Opamp0*/
-     Cy_CTB_Enable(CYBSP_DUT_OPAMP_HW);
-
-#if ADC_REF_VOLTAGE2
-     /* Connect the (2VDDA / 3) signal to opamp channel.
-      * Use the voltage divider to achieve the (2VDDA / 3) signal.
-      */
-     printf("Ensure that a (2VDDA / 3) signal is connected to ADC channel 0.\r\n");
-     if(OK_STATUS != SelfTests_Opamp(CYBSP_DUT_SAR_ADC_HW, ANALOG_OPAMP_SAR_RESULT2,
-             ANALOG_OPAMP_ACURACCY, 0x01, 1))
-     {
-         /* Process error */
-         printf("Error: OPAMP test failed for 2VDD/3 signal.\r\n");
-     }
-     else
-     {
-         printf("SUCCESS: OPAMP test passed for 2VDD/3 signal.\r\n");
-     }
-
-#else
-     /* Connect the (VDDA / 3) signal to OpAMP channel.
-      * Use the voltage divider to achieve the (VDDA / 3) signal.
-      */
-     printf("Ensure that a (VDDA / 3) signal is connected to ADC channel 0.\r\n");
-     if(OK_STATUS != SelfTests_Opamp(CYBSP_DUT_SAR_ADC_HW, ANALOG_OPAMP_SAR_RESULT1,
-             ANALOG_OPAMP_ACURACCY, 0x01, 1))
-     {
-         /* Process error */
-         printf("Error: OPAMP test failed for VDD/3 signal.\r\n");
-     }
-     else
-     {
-         printf("SUCCESS: OPAMP test passed for VDD/3 signal.\r\n");
-     }
+    uint32_t start;
+    uint32_t elapsed;
 
-#endif
+    /* OPAMP0 is initialized and enabled once by self_test_setup */
+    self_test_setup();
+
+    start = analog_backend_cpu_ticks();
+    (void)ref_run(&self_test_opamp_refs, opamp_ref_check, SELF_TEST_ID_OPAMP,
+            SELF_TEST_LOG_OPAMP_PROMPT, SELF_TEST_LOG_OPAMP);
+    elapsed = analog_backend_cpu_ticks() - start;
+
+    self_test_log(SELF_TEST_LOG_OPAMP_TIME, SELF_TEST_LOG_INFO, 0u,
+            (int32_t)(elapsed / analog_backend_cpu_ticks_per_us()),
+            (int32_t)self_test_setup_us());
+}
+
+/*******************************************************************************
+* Function Name: opamp_step_run
+********************************************************************************
+* Summary:
+* Opamp step response test. The opamp input is held on AMUXBUS A for
+* OPAMP_STEP_HOLD_US, then OPAMP_STEP_SAMPLES conversions of the opamp output
+* are taken back to back; before the conversion after OPAMP_STEP_PRE_SAMPLES,
+* the input is switched back to the reference pin. The captured buffer is
+* evaluated in one pass by self_test_stats_step. The test fails if the final
+* level is outside ANALOG_OPAMP_ACURACCY of the expected result, if the output
+* takes longer than OPAMP_STEP_MAX_SETTLE_US to settle within
+* OPAMP_STEP_SETTLE_BAND_MV, if its steepest edge is below
+* OPAMP_STEP_MIN_SLEW_MV_PER_US, or if the step is below
+* OPAMP_STEP_MIN_STEP_MV. A conversion that times out ends the capture and
+* fails the test with OPAMP_STEP_TIMEOUT_BIT.
+*
+* Parameters:
+*  result : Returns the measured response and the cost of the run
+*
+* Return :
+*  Mask of the failed checks, OPAMP_STEP_OFFSET_BIT to OPAMP_STEP_TIMEOUT_BIT
+*
+*******************************************************************************/
+uint32_t opamp_step_run(opamp_step_result_t *result)
+{
+    uint32_t failed = 0u;
+    uint32_t start_us;
+    uint32_t start;
+    uint32_t t;
+    uint32_t i;
+    int32_t step_mv;
+    int32_t mv;
+
+    self_test_setup();
+    self_test_wdt_begin(SELF_TEST_ID_OPAMP, false);
+
+    t = analog_backend_cpu_ticks();
+    analog_backend_opamp_input(ANALOG_OPAMP_INPUT_AMUXA);
+    t = self_test_trace_phase(SELF_TEST_ID_OPAMP, SELF_TEST_PHASE_ROUTE, t);
+    analog_backend_delay_us(OPAMP_STEP_HOLD_US);
+    t = self_test_trace_phase(SELF_TEST_ID_OPAMP, SELF_TEST_PHASE_SETTLE, t);
+
+    start = t;
+    start_us = analog_backend_time_us();
+    for (i = 0u; i < OPAMP_STEP_SAMPLES; i++)
+    {
+        if (OPAMP_STEP_PRE_SAMPLES == i)
+        {
+            analog_backend_opamp_input(ANALOG_OPAMP_INPUT_PIN);
+        }
+        if (OK_STATUS != self_test_wdt_adc_convert(SELF_TEST_ID_OPAMP, OPAMP_SAR_CHANNEL,
+                &mv))
+        {
+            /* The SAR stalled; the rest of the buffer reads 0 */
+            failed |= OPAMP_STEP_TIMEOUT_BIT;
+            (void)memset(&opamp_step_samples[i], 0,
+                    (OPAMP_STEP_SAMPLES - i) * sizeof(opamp_step_samples[0]));
+            break;
+        }
+        opamp_step_samples[i] = (int16_t)mv;
+    }
+    result->sample_ns = ((analog_backend_time_us() - start_us) * 1000u) / OPAMP_STEP_SAMPLES;
+    t = self_test_trace_phase(SELF_TEST_ID_OPAMP, SELF_TEST_PHASE_CAPTURE, t);
+    result->capture_ticks = t - start;
+
+    start = t;
+    self_test_stats_step(opamp_step_samples, OPAMP_STEP_SAMPLES, OPAMP_STEP_PRE_SAMPLES,
+            (uint32_t)OPAMP_STEP_SETTLE_BAND_MV, &result->step);
+    result->settle_ns = result->step.settle_samples * result->sample_ns;
+    result->slew_mv_per_us = 0u;
+    if ((0u != result->sample_ns) && (result->step.max_delta > 0))
+    {
+        result->slew_mv_per_us = ((uint32_t)result->step.max_delta * 1000u) / result->sample_ns;
+    }
+    result->offset_mv = result->step.final - OPAMP_REF_EXPECTED;
+    step_mv = result->step.final - result->step.base;
+
+    if (!self_test_opamp_ok(result->step.final))
+    {
+        failed |= OPAMP_STEP_OFFSET_BIT;
+    }
+    if (result->settle_ns > (OPAMP_STEP_MAX_SETTLE_US * 1000u))
+    {
+        failed |= OPAMP_STEP_SETTLE_BIT;
+    }
+    if (result->slew_mv_per_us < OPAMP_STEP_MIN_SLEW_MV_PER_US)
+    {
+        failed |= OPAMP_STEP_SLEW_BIT;
+    }
+    if ((step_mv < OPAMP_STEP_MIN_STEP_MV) && (step_mv > -OPAMP_STEP_MIN_STEP_MV))
+    {
+        failed |= OPAMP_STEP_NO_STEP_BIT;
+    }
+    t = self_test_trace_phase(SELF_TEST_ID_OPAMP, SELF_TEST_PHASE_EVALUATE, t);
+    result->eval_ticks = t - start;
+    self_test_wdt_end(SELF_TEST_ID_OPAMP, true);
+
+    return failed;
+}
+
+/*******************************************************************************
+* Function Name: opamp_step_test
+********************************************************************************
+* Summary:
+* Runs the opamp step response test and reports the levels, the settling time,
+* the slew rate and the CPU cost per sample of the capture and of the
+* evaluation, so that the capture length can be traded against the run time.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void opamp_step_test(void)
+{
+    opamp_step_result_t result;
+    uint32_t ticks_per_us = analog_backend_cpu_ticks_per_us();
+    uint32_t failed;
+    uint8_t status;
+
+    self_test_log(SELF_TEST_LOG_OPAMP_PROMPT, SELF_TEST_LOG_INFO, 0u, OPAMP_REF_EXPECTED,
+            OPAMP_SAR_CHANNEL);
 
+    failed = opamp_step_run(&result);
+    status = (uint8_t)((0u == failed) ? OK_STATUS : ERROR_STATUS);
 
+    self_test_log(SELF_TEST_LOG_OPAMP_STEP_LEVELS, SELF_TEST_LOG_INFO, 0u,
+            result.step.base, result.step.final);
+    self_test_log(SELF_TEST_LOG_OPAMP_STEP_EDGE, SELF_TEST_LOG_INFO, 0u,
+            (int32_t)result.settle_ns, (int32_t)result.slew_mv_per_us);
+    self_test_log(SELF_TEST_LOG_OPAMP_STEP_COST, SELF_TEST_LOG_INFO, (uint8_t)OPAMP_STEP_SAMPLES,
+            (int32_t)(((uint64_t)result.capture_ticks * 1000u) /
+                    ((uint64_t)ticks_per_us * OPAMP_STEP_SAMPLES)),
+            (int32_t)(((uint64_t)result.eval_ticks * 1000u) /
+                    ((uint64_t)ticks_per_us * OPAMP_STEP_SAMPLES)));
+    self_test_log(SELF_TEST_LOG_OPAMP_STEP, status, 0u, (int32_t)failed,
+            (int32_t)result.sample_ns);
+    (void)self_test_nvlog_append((uint8_t)SELF_TEST_ID_OPAMP, status, (int32_t)failed);
 }
 #endif
 
@@ -46,11 +46,8 @@
 #ifndef SELF_TEST_H_
 #define SELF_TEST_H_
 
-#include "SelfTest.h"
-
-/*******************************************************************************
-* Global Variables
-*******************************************************************************/
+#include "analog_backend.h"
+#include "self_test_stats.h"
 
 /*******************************************************************************
 * Macros
@@ -59,30 +56,167 @@
 #define SELFTEST_CMD_ADC ('1')
 #define SELFTEST_COMPARATOR ('2')
 #define SELFTEST_CMD_OPAMP ('3')
+#define SELFTEST_CMD_SCHED_STATS ('4')
+#define SELFTEST_CMD_ADC_ASYNC ('5')
+#define SELFTEST_CMD_ADC_BATCH ('6')
+#define SELFTEST_CMD_ALL ('7')
+#define SELFTEST_CMD_TRACE ('8')
+#define SELFTEST_CMD_MONITOR ('9')
+#define SELFTEST_CMD_HISTORY ('0')
+#define SELFTEST_CMD_COMP_SWEEP ('c')
+#define SELFTEST_CMD_OPAMP_STEP ('o')
+
+/* Number of samples per channel taken by the oversampled ADC test */
+#define ADC_BATCH_SAMPLES                  (32u)
+
+/* Largest allowed spread (max - min) of an oversampled batch, in millivolts */
+#define ADC_BATCH_MAX_SPREAD_MV            (ANALOG_ADC_ACURACCY)
+
+/* Largest allowed standard deviation of an oversampled batch, in millivolts */
+#define ADC_BATCH_MAX_STDDEV_MV            (ANALOG_ADC_ACURACCY / 4)
 
-/* in milliseconds */
-#define ADC_REF_VOLTAGE2                   0
+/* Comparator output settling time after an input routing change */
+#define COMP_SETTLE_US                     (10u)
 
-#define UART_TIMEOUT_MS (10u)      /* in milliseconds */
+/* Bits of the two checks of the comparator test in its failure mask */
+#define COMP_LOW_BIT                       (1u << 0)
+#define COMP_HIGH_BIT                      (1u << 1)
 
-/* Channel no. where the VBG voltage is connected.*/
-#if COMPONENT_CAT1A
-    #define VBG_CHANNEL    (0u)
-#elif COMPONENT_CAT1C
-    #define VBG_CHANNEL    (1u)
+/* Samples captured by the opamp step response test, of which
+ * OPAMP_STEP_PRE_SAMPLES are taken before the input step
+ */
+#define OPAMP_STEP_SAMPLES                 (64u)
+#define OPAMP_STEP_PRE_SAMPLES             (4u)
+
+/* Time the opamp input is held on AMUXBUS A before the capture */
+#define OPAMP_STEP_HOLD_US                 (100u)
+
+/* Half width of the band the opamp output must settle into, in millivolts */
+#define OPAMP_STEP_SETTLE_BAND_MV          (ANALOG_OPAMP_ACURACCY / 4)
+
+/* Limits of a healthy opamp: the smallest step between the two input levels,
+ * the longest settling time and the lowest slew rate. The measured slew rate
+ * is at most the step divided by the sample interval, so
+ * OPAMP_STEP_MIN_SLEW_MV_PER_US must stay below that.
+ */
+#define OPAMP_STEP_MIN_STEP_MV             (200)
+#define OPAMP_STEP_MAX_SETTLE_US           (40u)
+#define OPAMP_STEP_MIN_SLEW_MV_PER_US      (50u)
+
+/* Bits of the checks of the opamp step response test in its failure mask */
+#define OPAMP_STEP_OFFSET_BIT              (1u << 0)
+#define OPAMP_STEP_SETTLE_BIT              (1u << 1)
+#define OPAMP_STEP_SLEW_BIT                (1u << 2)
+#define OPAMP_STEP_NO_STEP_BIT             (1u << 3)
+#define OPAMP_STEP_TIMEOUT_BIT             (1u << 4)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Identifiers of the analog self tests */
+typedef enum
+{
+    SELF_TEST_ID_ADC = 0u,
+    SELF_TEST_ID_COMPARATOR,
+    SELF_TEST_ID_OPAMP,
+    SELF_TEST_ID_COUNT
+} self_test_id_t;
+
+/* Statistics and cost of an oversampled ADC test */
+typedef struct
+{
+    self_test_stats_t ref;         /* Reference channel samples, millivolts */
+    self_test_stats_t vbg;         /* Bandgap samples, empty if the bandgap
+                                    * shares the reference channel */
+    uint32_t conv_ticks;           /* CPU ticks spent on the conversions */
+    uint32_t stats_ticks;          /* CPU ticks spent in the statistics kernels */
+} adc_batch_result_t;
+
+/* One reference point checked by the ADC or opamp test */
+typedef struct
+{
+    int16_t expected_mv;           /* Expected result */
+    int16_t accuracy_mv;           /* Allowed deviation from expected_mv */
+    uint8_t channel;               /* SAR channel the signal is converted on */
+    uint8_t vbg_channel;           /* SAR channel of the bandgap reference */
+} self_test_ref_point_t;
+
+/* Reference points checked in one pass */
+typedef struct
+{
+    const self_test_ref_point_t *points;
+    uint8_t count;
+} self_test_ref_set_t;
+
+#if SELF_TEST_HAS_OPAMP
+/* Result and cost of an opamp step response test */
+typedef struct
+{
+    self_test_step_t step;         /* Levels and edge of the response, in mV */
+    uint32_t sample_ns;            /* Time between two samples */
+    uint32_t settle_ns;            /* Settling time after the step */
+    uint32_t slew_mv_per_us;       /* Steepest edge, a lower bound of the slew
+                                    * rate */
+    int32_t offset_mv;             /* Final level minus OPAMP_REF_EXPECTED */
+    uint32_t capture_ticks;        /* CPU ticks spent on the capture */
+    uint32_t eval_ticks;           /* CPU ticks spent on the evaluation */
+} opamp_step_result_t;
+#endif
+
+#if SELF_TEST_HAS_COMPARATOR
+/* One routing group of the comparator sweep: the input pins and the channel
+ * inputs are switched and settle once, then every channel of channel_mask is
+ * checked.
+ */
+typedef struct
+{
+    analog_comp_route_t route;     /* Bus assignment of the input pins */
+    analog_comp_input_t vplus;     /* Positive input of the checked channels */
+    analog_comp_input_t vminus;    /* Negative input of the checked channels */
+    uint8_t channel_mask;          /* Channels checked, bit n for channel n */
+    uint8_t expected;              /* Expected output of every checked channel */
+} self_test_comp_group_t;
+
+/* Routing groups checked by one comparator sweep */
+typedef struct
+{
+    const self_test_comp_group_t *groups;
+    uint8_t count;
+} self_test_comp_sweep_t;
+#endif
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+extern const self_test_ref_set_t self_test_adc_refs;
+#if SELF_TEST_HAS_OPAMP
+extern const self_test_ref_set_t self_test_opamp_refs;
+#endif
+#if SELF_TEST_HAS_COMPARATOR
+extern const self_test_comp_sweep_t self_test_comp_sweep;
 #endif
 
 /*******************************************************************************
 * Function Prototypes
 *******************************************************************************/
+void self_test_setup(void);
+uint32_t self_test_setup_us(void);
 void adc_test(void);
+uint8_t adc_batch_run(uint32_t samples, adc_batch_result_t *result);
+void adc_batch_test(void);
+void analog_all_test(void);
 
-#if COMPONENT_CAT1A
+#if SELF_TEST_HAS_COMPARATOR
+uint32_t comparator_run(void);
 void comparator_test(void);
+uint32_t comparator_sweep_run(uint32_t *checks);
+void comparator_sweep_test(void);
 #endif
 
-#if (defined(CY_DEVICE_PSOC6A256K) || defined(CY_DEVICE_PSOC6ABLE2))
+#if SELF_TEST_HAS_OPAMP
 void opamp_test(void);
+uint32_t opamp_step_run(opamp_step_result_t *result);
+void opamp_step_test(void);
 #endif
 
 #endif /* SELF_TEST_H_ */
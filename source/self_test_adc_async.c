@@ -0,0 +1,236 @@
+/******************************************************************************
+* File Name:   self_test_adc_async.c
+*
+* Description: This file implements the interrupt driven ADC self test. The
+*              reference and bandgap channels are converted by the SAR (SAR2 on
+*              CAT1C) while the CPU is free, the results are collected by the
+*              end-of-conversion interrupt and the pass/fail evaluation runs
+*              later from the main loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stddef.h>
+#include "self_test_adc_async.h"
+#include "self_test_monitor.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* The bandgap is converted separately only if it has its own channel */
+#define ASYNC_CHANNEL_COUNT                ((VBG_CHANNEL != ADC_REF_CHANNEL) ? 2u : 1u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+typedef enum
+{
+    ASYNC_IDLE = 0u,       /* No conversion in progress */
+    ASYNC_BUSY,            /* Conversion running, waiting for the interrupt */
+    ASYNC_READY            /* Samples collected, evaluation pending */
+} async_state_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const uint32_t async_channels[2] = { ADC_REF_CHANNEL, VBG_CHANNEL };
+static int16_t async_samples[2];
+static volatile async_state_t async_state = ASYNC_IDLE;
+static self_test_adc_async_cb_t async_result_cb;
+
+/*******************************************************************************
+* Function Name: async_conversion_done
+********************************************************************************
+* Summary:
+* Completion callback of the conversion, called from the SAR interrupt. Only
+* marks the samples as ready; the evaluation is deferred.
+*
+*******************************************************************************/
+static void async_conversion_done(void)
+{
+    async_state = ASYNC_READY;
+}
+
+/*******************************************************************************
+* Function Name: self_test_adc_async_start
+********************************************************************************
+* Summary:
+* Starts the conversion of the reference and bandgap channels and returns
+* immediately.
+*
+* Parameters:
+*  result_cb : Callback that self_test_adc_async_process invokes with the
+*              result, or NULL if the caller evaluates the result itself with
+*              self_test_adc_async_evaluate
+*
+* Return :
+*  false if a conversion is already in progress or not yet evaluated
+*
+*******************************************************************************/
+bool self_test_adc_async_start(self_test_adc_async_cb_t result_cb)
+{
+    if (ASYNC_IDLE != async_state)
+    {
+        return false;
+    }
+
+    async_result_cb = result_cb;
+    async_state = ASYNC_BUSY;
+    analog_backend_adc_async_start(async_channels, ASYNC_CHANNEL_COUNT,
+            async_samples, async_conversion_done);
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: self_test_adc_async_busy
+********************************************************************************
+* Summary:
+* Checks whether the conversion is still running. The SAR must not be used
+* for other conversions meanwhile: their end of conversion would be taken by
+* the conversion complete interrupt, or they would change the channels it
+* converts.
+*
+*******************************************************************************/
+bool self_test_adc_async_busy(void)
+{
+    return (ASYNC_BUSY == async_state);
+}
+
+/*******************************************************************************
+* Function Name: self_test_adc_async_is_ready
+********************************************************************************
+* Summary:
+* Checks whether the samples of the conversion have been collected.
+*
+*******************************************************************************/
+bool self_test_adc_async_is_ready(void)
+{
+    return (ASYNC_READY == async_state);
+}
+
+/*******************************************************************************
+* Function Name: self_test_adc_async_evaluate
+********************************************************************************
+* Summary:
+* Evaluates the collected samples: the reference channel must be within
+* ANALOG_ADC_ACURACCY of the expected result. The bandgap reading is reported
+* for information. Must only be called when self_test_adc_async_is_ready
+* returns true; the test is idle again afterwards.
+*
+* Parameters:
+*  ref_mv : Returns the reference channel reading in millivolts
+*  vbg_mv : Returns the bandgap reading in millivolts
+*
+* Return :
+*  OK_STATUS if the test passed, ERROR_STATUS otherwise
+*
+*******************************************************************************/
+uint8_t self_test_adc_async_evaluate(int32_t *ref_mv, int32_t *vbg_mv)
+{
+    int32_t ref = analog_backend_adc_counts_to_mv(ADC_REF_CHANNEL, async_samples[0]);
+    int32_t vbg = 0;
+
+    if (ASYNC_CHANNEL_COUNT > 1u)
+    {
+        vbg = analog_backend_adc_counts_to_mv(VBG_CHANNEL, async_samples[1]);
+    }
+
+    *ref_mv = ref;
+    *vbg_mv = vbg;
+    self_test_monitor_feed_scan(async_channels, async_samples, ASYNC_CHANNEL_COUNT);
+    async_state = ASYNC_IDLE;
+
+    if (!self_test_adc_ref_ok(ref))
+    {
+        return ERROR_STATUS;
+    }
+
+    return OK_STATUS;
+}
+
+/*******************************************************************************
+* Function Name: self_test_adc_async_process
+********************************************************************************
+* Summary:
+* Deferred part of the test, to be called from the main loop. Evaluates the
+* collected samples and invokes the result callback given to
+* self_test_adc_async_start.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_adc_async_process(void)
+{
+    int32_t ref_mv;
+    int32_t vbg_mv;
+    uint8_t status;
+
+    if ((ASYNC_READY != async_state) || (NULL == async_result_cb))
+    {
+        return;
+    }
+
+    status = self_test_adc_async_evaluate(&ref_mv, &vbg_mv);
+    async_result_cb(status, ref_mv, vbg_mv);
+}
+
+/*******************************************************************************
+* Function Name: self_test_adc_async_cancel
+********************************************************************************
+* Summary:
+* Abandons the conversion in progress, e.g. before the SAR is used by a
+* blocking test.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_adc_async_cancel(void)
+{
+    analog_backend_adc_async_cancel();
+    async_state = ASYNC_IDLE;
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,73 @@
+/******************************************************************************
+* File Name:   self_test_adc_async.h
+*
+* Description: This file is the public interface of self_test_adc_async.c,
+*              the interrupt driven ADC self test.
+*
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_ADC_ASYNC_H_
+#define SELF_TEST_ADC_ASYNC_H_
+
+#include "self_test.h"
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Deferred result callback of the asynchronous ADC test. vbg_mv is 0 when the
+ * bandgap shares the SAR channel of the reference voltage.
+ */
+typedef void (*self_test_adc_async_cb_t)(uint8_t status, int32_t ref_mv,
+        int32_t vbg_mv);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+bool self_test_adc_async_start(self_test_adc_async_cb_t result_cb);
+bool self_test_adc_async_busy(void);
+bool self_test_adc_async_is_ready(void);
+uint8_t self_test_adc_async_evaluate(int32_t *ref_mv, int32_t *vbg_mv);
+void self_test_adc_async_process(void);
+void self_test_adc_async_cancel(void);
+
+#endif /* SELF_TEST_ADC_ASYNC_H_ */
+
+/* [] END OF FILE */
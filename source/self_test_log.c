@@ -0,0 +1,482 @@
+/******************************************************************************
+* File Name:   self_test_log.c
+*
+* Description: This file implements the deferred event log of the self tests.
+*              The test paths store fixed-size binary records in a ring
+*              buffer and never wait on the UART. The records are formatted
+*              and printed later from the main loop.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include "self_test_log.h"
+#include "self_test_post.h"
+#include "self_test_wdt.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+#if SELF_TEST_HAS_COMPARATOR
+    #define LOG_MENU_COMPARATOR            "2 : Run SelfTest for Comparator\r\n"
+    #define LOG_MENU_COMP_SWEEP            "c : Run SelfTest sweep for both Comparator channels\r\n"
+#else
+    #define LOG_MENU_COMPARATOR            ""
+    #define LOG_MENU_COMP_SWEEP            ""
+#endif
+#if SELF_TEST_HAS_OPAMP
+    #define LOG_MENU_OPAMP                 "3 : Run SelfTest for OP-AMP\r\n"
+    #define LOG_MENU_OPAMP_STEP            "o : Run SelfTest for OP-AMP step response\r\n"
+#else
+    #define LOG_MENU_OPAMP                 ""
+    #define LOG_MENU_OPAMP_STEP            ""
+#endif
+
+/* Mask of the fractional bits of a Q8 value */
+#define LOG_Q8_FRAC_MASK                   ((1u << SELF_TEST_STATS_Q) - 1u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* One logged event */
+typedef struct
+{
+    uint8_t event;                 /* self_test_log_event_t */
+    uint8_t status;                /* OK_STATUS, ERROR_STATUS or SELF_TEST_LOG_INFO */
+    uint8_t arg;                   /* Small event argument, see the event */
+    int32_t a;                     /* First value, see the event */
+    int32_t b;                     /* Second value, see the event */
+} log_record_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char log_menu[] =
+    "Available commands \r\n"
+    "1 : Run SelfTest for ADC\r\n"
+    LOG_MENU_COMPARATOR
+    LOG_MENU_OPAMP
+    "4 : Show periodic SelfTest statistics\r\n"
+    "5 : Run SelfTest for ADC (interrupt driven)\r\n"
+    "6 : Run SelfTest for ADC (oversampled)\r\n"
+    "7 : Run combined SelfTest for ADC and OP-AMP in one scan\r\n"
+    "8 : Show SelfTest phase timing and watchdog budgets\r\n"
+    "9 : Show ADC plausibility monitor\r\n"
+    "0 : Show stored SelfTest results\r\n"
+    LOG_MENU_COMP_SWEEP
+    LOG_MENU_OPAMP_STEP
+    "\n";
+
+static const char * const log_test_names[SELF_TEST_ID_COUNT] =
+{
+    [SELF_TEST_ID_ADC] = "ADC",
+    [SELF_TEST_ID_COMPARATOR] = "Comparator",
+    [SELF_TEST_ID_OPAMP] = "OP-AMP",
+};
+
+static const char * const log_channel_names[] =
+{
+    [SELF_TEST_LOG_CHANNEL_REF] = "Reference",
+    [SELF_TEST_LOG_CHANNEL_VBG] = "Bandgap",
+};
+
+/* Events not printed yet; log_head is only written by the producer (the
+ * self tests) and log_tail only by the consumer (self_test_log_drain).
+ */
+static log_record_t log_ring[SELF_TEST_LOG_DEPTH];
+static volatile uint32_t log_head;
+static volatile uint32_t log_tail;
+static volatile uint32_t log_dropped;
+static uint32_t log_dropped_reported;
+
+/*******************************************************************************
+* Function Name: log_verdict
+********************************************************************************
+* Summary:
+* Returns the result prefix of a test result event.
+*
+*******************************************************************************/
+static const char *log_verdict(const log_record_t *record)
+{
+    return (OK_STATUS == record->status) ? "SUCCESS" : "Error";
+}
+
+/*******************************************************************************
+* Function Name: log_print_q8
+********************************************************************************
+* Summary:
+* Prints a non-negative Q8 fixed-point value with two decimals.
+*
+*******************************************************************************/
+static void log_print_q8(int32_t value_q)
+{
+    printf("%ld.%02lu", (long)(value_q >> SELF_TEST_STATS_Q),
+            (unsigned long)((((uint32_t)value_q & LOG_Q8_FRAC_MASK) * 100u) >>
+                    SELF_TEST_STATS_Q));
+}
+
+/*******************************************************************************
+* Function Name: log_print_record
+********************************************************************************
+* Summary:
+* Formats and prints one event.
+*
+*******************************************************************************/
+static void log_print_record(const log_record_t *record)
+{
+    const char *verdict = log_verdict(record);
+    bool ok = (OK_STATUS == record->status);
+
+    switch ((self_test_log_event_t)record->event)
+    {
+        case SELF_TEST_LOG_MENU:
+            printf("%s", log_menu);
+            break;
+
+        case SELF_TEST_LOG_SETUP:
+            printf("Analog setup took %ld us\r\n\n", (long)record->a);
+            break;
+
+        case SELF_TEST_LOG_ADC_PROMPT:
+            printf("Ensure that a %ld mV signal is connected to ADC channel %ld.\r\n",
+                    (long)record->a, (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_OPAMP_PROMPT:
+            printf("Ensure that a %ld mV signal is connected to the opamp input.\r\n",
+                    (long)record->a);
+            break;
+
+        case SELF_TEST_LOG_ADC:
+            printf("%s: ADC SelfTest %s for %ld mV signal on channel %ld.\r\n",
+                    verdict, ok ? "passed" : "failed", (long)record->a, (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_ADC_ASYNC:
+            printf("%s: ADC SelfTest (interrupt driven) %s, reference %ld mV, "
+                   "bandgap %ld mV\r\n", verdict, ok ? "passed" : "failed",
+                   (long)record->a, (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_ADC_BATCH_MEAN:
+            printf("%s: mean ", log_channel_names[record->arg]);
+            log_print_q8(record->a);
+            printf(" mV, variance ");
+            log_print_q8(record->b);
+            printf(" mV^2\r\n");
+            break;
+
+        case SELF_TEST_LOG_ADC_BATCH_RANGE:
+            printf("%s: min %ld mV, max %ld mV\r\n", log_channel_names[record->arg],
+                    (long)record->a, (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_ADC_BATCH_COST:
+            printf("Cost per sample: conversion %ld ns, statistics %ld ns\r\n",
+                    (long)record->a, (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_ADC_BATCH:
+            printf("%s: ADC SelfTest (oversampled) %s.\r\n", verdict,
+                    ok ? "passed" : "failed");
+            break;
+
+        case SELF_TEST_LOG_ALL_ADC:
+            printf("%s: ADC check of the combined SelfTest\r\n", verdict);
+            break;
+
+        case SELF_TEST_LOG_ALL_VBG:
+            printf("Bandgap reading: %ld mV\r\n", (long)record->a);
+            break;
+
+        case SELF_TEST_LOG_ALL_OPAMP:
+            printf("%s: OPAMP check of the combined SelfTest\r\n", verdict);
+            break;
+
+        case SELF_TEST_LOG_ALL_TIME:
+            printf("Combined SelfTest took %ld us\r\n", (long)record->a);
+            break;
+
+        case SELF_TEST_LOG_COMP_PROMPT:
+            printf("Apply lower voltage to positive input (CYBSP_DUT_LPCOMP_VPLUS_PIN).\r\n");
+            break;
+
+        case SELF_TEST_LOG_COMP_LOW:
+            printf("%s: LPCOMP lower voltage test%s\r\n", verdict, ok ? "" : " fail");
+            break;
+
+        case SELF_TEST_LOG_COMP_HIGH:
+            printf("%s: LPCOMP higher voltage test%s\r\n", verdict, ok ? "" : " fail");
+            break;
+
+        case SELF_TEST_LOG_COMP_TIME:
+            printf("LPCOMP SelfTest took %ld us, one-time setup %ld us\r\n",
+                    (long)record->a, (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_COMP_SWEEP:
+            printf("%s: LPCOMP sweep %s, %u checks in %ld routing groups, failure mask 0x%lX\r\n",
+                    verdict, ok ? "passed" : "failed", record->arg, (long)record->b,
+                    (unsigned long)record->a);
+            break;
+
+        case SELF_TEST_LOG_COMP_SWEEP_TIME:
+            printf("LPCOMP sweep took %ld ns, %ld ns per check; two-step test %ld ns, "
+                   "%ld ns per check\r\n", (long)record->a,
+                    (long)(record->a / ((0u != record->arg) ? record->arg : 1)),
+                    (long)record->b, (long)(record->b / 2));
+            break;
+
+        case SELF_TEST_LOG_OPAMP:
+            printf("%s: OPAMP test %s for %ld mV signal.\r\n",
+                    verdict, ok ? "passed" : "failed", (long)record->a);
+            break;
+
+        case SELF_TEST_LOG_OPAMP_TIME:
+            printf("OPAMP SelfTest took %ld us, one-time setup %ld us\r\n",
+                    (long)record->a, (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_OPAMP_STEP:
+            printf("%s: OPAMP step response test %s, failure mask 0x%lX, %ld ns per sample\r\n",
+                    verdict, ok ? "passed" : "failed", (unsigned long)record->a,
+                    (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_OPAMP_STEP_LEVELS:
+            printf("OPAMP step from %ld mV to %ld mV, offset %ld mV\r\n", (long)record->a,
+                    (long)record->b, (long)(record->b - OPAMP_REF_EXPECTED));
+            break;
+
+        case SELF_TEST_LOG_OPAMP_STEP_EDGE:
+            printf("OPAMP settled in %ld ns, slew rate at least %ld mV/us\r\n",
+                    (long)record->a, (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_OPAMP_STEP_COST:
+            printf("Cost per sample of %u: capture %ld ns, evaluation %ld ns\r\n",
+                    record->arg, (long)record->a, (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_SCHED:
+            printf("%s: periodic %s SelfTest %s, measured %ld\r\n", verdict,
+                    log_test_names[record->arg], ok ? "passed" : "failed",
+                    (long)record->a);
+            break;
+
+        case SELF_TEST_LOG_MONITOR:
+            printf("%s: ADC monitor, %s channel window mean %ld mV, expected %ld mV\r\n",
+                    verdict, log_channel_names[record->arg], (long)record->a,
+                    (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_WDT_OVERRUN:
+            if (SELF_TEST_WDT_PHASE_RUN == (uint32_t)record->a)
+            {
+                printf("%s: %s periodic SelfTest took %ld us, over its watchdog budget\r\n",
+                        verdict, log_test_names[record->arg], (long)record->b);
+            }
+            else
+            {
+                printf("%s: %s SelfTest %s phase took %ld us, over its watchdog budget\r\n",
+                        verdict, log_test_names[record->arg],
+                        self_test_trace_phase_name((self_test_phase_t)record->a),
+                        (long)record->b);
+            }
+            break;
+
+        case SELF_TEST_LOG_WDT_RESET:
+            if (record->arg >= (uint8_t)SELF_TEST_ID_COUNT)
+            {
+                printf("%s: Watchdog reset outside the SelfTests\r\n", verdict);
+            }
+            else if (SELF_TEST_WDT_PHASE_NONE == (uint32_t)record->a)
+            {
+                printf("%s: Watchdog reset, %s SelfTest hung in its first phase\r\n",
+                        verdict, log_test_names[record->arg]);
+            }
+            else
+            {
+                printf("%s: Watchdog reset, %s SelfTest hung after its %s phase\r\n",
+                        verdict, log_test_names[record->arg],
+                        self_test_trace_phase_name((self_test_phase_t)record->a));
+            }
+            break;
+
+        case SELF_TEST_LOG_POST:
+            printf("%s: Power-on SelfTest %s, failure mask 0x%lX, verdict %ld us after main\r\n",
+                    verdict, ok ? "passed" : "failed", (unsigned long)record->a,
+                    (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_POST_STAGE:
+            printf("  %-10s %8ld us, done at %8ld us\r\n",
+                    self_test_post_stage_name((self_test_post_stage_t)record->arg),
+                    (long)record->a, (long)record->b);
+            break;
+
+        case SELF_TEST_LOG_LP_COMP_WAKE:
+            printf("Comparator supervisor wake-up, comparator SelfTest %s %ld us later\r\n",
+                    ok ? "passed" : "failed", (long)record->a);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_log
+********************************************************************************
+* Summary:
+* Appends one event to the log. It only copies the record to the ring buffer,
+* so it never waits on the UART. If the ring buffer is full the event is
+* dropped and counted. All events must be logged from the same execution
+* context.
+*
+* Parameters:
+*  event  : Event
+*  status : OK_STATUS or ERROR_STATUS for results, SELF_TEST_LOG_INFO otherwise
+*  arg    : Small event argument, see self_test_log_event_t
+*  a      : First value, see self_test_log_event_t
+*  b      : Second value, see self_test_log_event_t
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_log(self_test_log_event_t event, uint8_t status, uint8_t arg,
+        int32_t a, int32_t b)
+{
+    uint32_t head = log_head;
+    log_record_t *record;
+
+    if ((head - log_tail) >= SELF_TEST_LOG_DEPTH)
+    {
+        log_dropped++;
+        return;
+    }
+
+    record = &log_ring[head % SELF_TEST_LOG_DEPTH];
+    record->event = (uint8_t)event;
+    record->status = status;
+    record->arg = arg;
+    record->a = a;
+    record->b = b;
+    log_head = head + 1u;
+}
+
+/*******************************************************************************
+* Function Name: self_test_log_drain
+********************************************************************************
+* Summary:
+* Formats and prints up to max_events pending events. Called from the main
+* loop when no test step is running. Dropped events are reported once.
+*
+* Parameters:
+*  max_events : Largest number of events to print
+*
+* Return :
+*  Number of events printed
+*
+*******************************************************************************/
+uint32_t self_test_log_drain(uint32_t max_events)
+{
+    uint32_t tail = log_tail;
+    uint32_t printed = 0u;
+    uint32_t dropped = log_dropped;
+
+    while ((printed < max_events) && (tail != log_head))
+    {
+        log_print_record(&log_ring[tail % SELF_TEST_LOG_DEPTH]);
+        tail++;
+        log_tail = tail;
+        printed++;
+    }
+
+    if (dropped != log_dropped_reported)
+    {
+        printf("Log: %lu events dropped\r\n", (unsigned long)(dropped - log_dropped_reported));
+        log_dropped_reported = dropped;
+    }
+
+    return printed;
+}
+
+/*******************************************************************************
+* Function Name: self_test_log_discard
+********************************************************************************
+* Summary:
+* Removes up to max_events pending events without printing them, for a build
+* that runs without a console.
+*
+* Parameters:
+*  max_events : Largest number of events to remove
+*
+* Return :
+*  Number of events removed
+*
+*******************************************************************************/
+uint32_t self_test_log_discard(uint32_t max_events)
+{
+    uint32_t pending = log_head - log_tail;
+    uint32_t removed = (pending < max_events) ? pending : max_events;
+
+    log_tail += removed;
+    log_dropped_reported = log_dropped;
+    return removed;
+}
+
+/*******************************************************************************
+* Function Name: self_test_log_dropped
+********************************************************************************
+* Summary:
+* Returns the number of events dropped because the log was full.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  Number of dropped events
+*
+*******************************************************************************/
+uint32_t self_test_log_dropped(void)
+{
+    return log_dropped;
+}
+
+/* [] END OF FILE */
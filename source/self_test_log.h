@@ -0,0 +1,120 @@
+/******************************************************************************
+* File Name:   self_test_log.h
+*
+* Description: This file is the public interface of self_test_log.c, the
+*              deferred event log that decouples the self-test results from
+*              the console output.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_LOG_H_
+#define SELF_TEST_LOG_H_
+
+#include "self_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of events the log holds until they are printed */
+#define SELF_TEST_LOG_DEPTH                (32u)
+
+/* Status of an event that is not a test result */
+#define SELF_TEST_LOG_INFO                 (0xFFu)
+
+/* Channel argument of the oversampled ADC test events */
+#define SELF_TEST_LOG_CHANNEL_REF          (0u)
+#define SELF_TEST_LOG_CHANNEL_VBG          (1u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Logged events. The comment lists the meaning of arg, a and b. */
+typedef enum
+{
+    SELF_TEST_LOG_MENU = 0u,       /* List of the available commands */
+    SELF_TEST_LOG_SETUP,           /* a: one-time setup time in us */
+    SELF_TEST_LOG_ADC_PROMPT,      /* arg: point, a: expected mV, b: channel */
+    SELF_TEST_LOG_ADC,             /* arg: point, a: expected mV, b: channel */
+    SELF_TEST_LOG_ADC_ASYNC,       /* a: reference mV, b: bandgap mV */
+    SELF_TEST_LOG_ADC_BATCH_MEAN,  /* arg: channel, a: mean, b: variance, Q8 */
+    SELF_TEST_LOG_ADC_BATCH_RANGE, /* arg: channel, a: min mV, b: max mV */
+    SELF_TEST_LOG_ADC_BATCH_COST,  /* a: conversion ns, b: statistics ns */
+    SELF_TEST_LOG_ADC_BATCH,       /* Result of the oversampled ADC test */
+    SELF_TEST_LOG_ALL_ADC,         /* ADC result of the combined test */
+    SELF_TEST_LOG_ALL_VBG,         /* a: bandgap mV */
+    SELF_TEST_LOG_ALL_OPAMP,       /* Opamp result of the combined test */
+    SELF_TEST_LOG_ALL_TIME,        /* a: duration of the combined test in us */
+    SELF_TEST_LOG_COMP_PROMPT,     /* Comparator input to drive */
+    SELF_TEST_LOG_COMP_LOW,        /* Result with the lower voltage on VPLUS */
+    SELF_TEST_LOG_COMP_HIGH,       /* Result with the higher voltage on VPLUS */
+    SELF_TEST_LOG_COMP_TIME,       /* a: test time in us, b: setup time in us */
+    SELF_TEST_LOG_COMP_SWEEP,      /* arg: checks, a: failure mask, b: groups */
+    SELF_TEST_LOG_COMP_SWEEP_TIME, /* arg: checks, a: sweep ns, b: two-step ns */
+    SELF_TEST_LOG_OPAMP_PROMPT,    /* arg: point, a: expected mV, b: channel */
+    SELF_TEST_LOG_OPAMP,           /* arg: point, a: expected mV, b: channel */
+    SELF_TEST_LOG_OPAMP_TIME,      /* a: test time in us, b: setup time in us */
+    SELF_TEST_LOG_OPAMP_STEP,      /* a: failure mask, b: sample interval in ns */
+    SELF_TEST_LOG_OPAMP_STEP_LEVELS, /* a: mV before the step, b: final mV */
+    SELF_TEST_LOG_OPAMP_STEP_EDGE, /* a: settling time in ns, b: slew in mV/us */
+    SELF_TEST_LOG_OPAMP_STEP_COST, /* arg: samples, a: capture ns, b: evaluation ns,
+                                    * per sample */
+    SELF_TEST_LOG_SCHED,           /* arg: self_test_id_t, a: measured value */
+    SELF_TEST_LOG_LP_COMP_WAKE,    /* a: wake-to-result latency in us */
+    SELF_TEST_LOG_MONITOR,         /* arg: channel, a: window mean mV, b: expected mV */
+    SELF_TEST_LOG_WDT_OVERRUN,     /* arg: self_test_id_t, a: phase, b: duration us */
+    SELF_TEST_LOG_WDT_RESET,       /* arg: self_test_id_t, a: last completed phase */
+    SELF_TEST_LOG_POST,            /* a: failure mask, b: main-to-verdict time in us */
+    SELF_TEST_LOG_POST_STAGE,      /* arg: self_test_post_stage_t, a: duration us,
+                                    * b: end time us */
+    SELF_TEST_LOG_EVENT_COUNT
+} self_test_log_event_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void self_test_log(self_test_log_event_t event, uint8_t status, uint8_t arg,
+        int32_t a, int32_t b);
+uint32_t self_test_log_drain(uint32_t max_events);
+uint32_t self_test_log_discard(uint32_t max_events);
+uint32_t self_test_log_dropped(void);
+
+#endif /* SELF_TEST_LOG_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,329 @@
+/******************************************************************************
+* File Name:   self_test_lp.c
+*
+* Description: This file implements the low-power mode of the self tests. The
+*              core deep-sleeps until the scheduler has the next test due and
+*              is woken by the low-power timer. Meanwhile the LPCOMP keeps
+*              running as a continuous supervisor and wakes the core early
+*              when its input crosses the threshold, which triggers a fresh
+*              comparator test. The duty cycle gives the average current and
+*              each wake-up is timed until its test result is available.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "self_test_lp.h"
+#include "self_test_sched.h"
+#include "self_test_trace.h"
+#include "self_test_log.h"
+#include "self_test_wdt.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static self_test_lp_stats_t lp_stats;
+
+/* Time the core last woke up, and the reason */
+static uint32_t lp_wake_us;
+static analog_wake_t lp_wake_reason;
+
+#if SELF_TEST_HAS_COMPARATOR
+/* Set while the comparator fails its test; it cannot supervise then */
+static bool lp_comp_faulted;
+#endif
+
+/* Time statistics were last accounted and reported */
+static uint32_t lp_last_us;
+static uint32_t lp_report_us;
+
+/*******************************************************************************
+* Function Name: lp_record_latency
+********************************************************************************
+* Summary:
+* Adds one wake-to-result time to the statistics.
+*
+*******************************************************************************/
+static void lp_record_latency(uint32_t latency_us)
+{
+    if ((0u == lp_stats.latency_count) || (latency_us < lp_stats.latency_min_us))
+    {
+        lp_stats.latency_min_us = latency_us;
+    }
+    if (latency_us > lp_stats.latency_max_us)
+    {
+        lp_stats.latency_max_us = latency_us;
+    }
+    lp_stats.latency_sum_us += latency_us;
+    lp_stats.latency_count++;
+}
+
+/*******************************************************************************
+* Function Name: self_test_lp_init
+********************************************************************************
+* Summary:
+* Resets the low-power statistics. self_test_sched_init must have been called.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_lp_init(void)
+{
+    (void)memset(&lp_stats, 0, sizeof(lp_stats));
+
+    lp_wake_us = analog_backend_time_us();
+    lp_wake_reason = ANALOG_WAKE_TIMER;
+#if SELF_TEST_HAS_COMPARATOR
+    lp_comp_faulted = false;
+#endif
+    lp_last_us = lp_wake_us;
+    lp_report_us = lp_wake_us;
+}
+
+/*******************************************************************************
+* Function Name: self_test_lp_step
+********************************************************************************
+* Summary:
+* Runs one wake-up: completes every test that is due, prints the results and
+* deep-sleeps until the next test is due or the comparator supervisor fires.
+* Call it in an endless loop.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_lp_step(void)
+{
+    bool ran = false;
+    uint32_t sleep_us;
+    uint32_t now;
+#if SELF_TEST_HAS_COMPARATOR
+    const self_test_sched_stats_t *sched_stats = self_test_sched_get_stats();
+    uint32_t comp_runs = sched_stats->test[SELF_TEST_ID_COMPARATOR].runs;
+    uint32_t comp_failures = sched_stats->test[SELF_TEST_ID_COMPARATOR].failures;
+
+    /* The comparator tests change its routing */
+    analog_backend_comp_supervise(false);
+    if (ANALOG_WAKE_COMPARATOR == lp_wake_reason)
+    {
+        self_test_sched_trigger(SELF_TEST_ID_COMPARATOR);
+    }
+#endif
+
+    while (0u == self_test_sched_next_due_us())
+    {
+        self_test_sched_tick();
+        self_test_wdt_service();
+        ran = true;
+        if (0u == self_test_sched_next_due_us())
+        {
+            analog_backend_delay_us(SELF_TEST_LP_POLL_US);
+        }
+    }
+
+    if (ran)
+    {
+        uint32_t latency_us = analog_backend_time_us() - lp_wake_us;
+
+        lp_record_latency(latency_us);
+#if SELF_TEST_HAS_COMPARATOR
+        if (comp_runs != sched_stats->test[SELF_TEST_ID_COMPARATOR].runs)
+        {
+            lp_comp_faulted =
+                    (comp_failures != sched_stats->test[SELF_TEST_ID_COMPARATOR].failures);
+        }
+        if (ANALOG_WAKE_COMPARATOR == lp_wake_reason)
+        {
+            self_test_log(SELF_TEST_LOG_LP_COMP_WAKE,
+                    (uint8_t)(lp_comp_faulted ? ERROR_STATUS : OK_STATUS), 0u,
+                    (int32_t)latency_us, 0);
+        }
+#endif
+    }
+
+    self_test_trace_collect();
+    (void)self_test_log_drain(SELF_TEST_LOG_DEPTH);
+
+    now = analog_backend_time_us();
+    if ((now - lp_report_us) >= SELF_TEST_LP_REPORT_US)
+    {
+        lp_report_us = now;
+        self_test_lp_print_stats();
+    }
+
+#if SELF_TEST_HAS_COMPARATOR
+    /* A faulty comparator would wake the core continuously; the scheduled
+     * comparator test re-arms the supervisor once it passes again.
+     */
+    if (!lp_comp_faulted)
+    {
+        analog_backend_comp_supervise(true);
+    }
+#endif
+    /* The watchdog keeps counting in deep sleep, wake up in time to kick it */
+    sleep_us = self_test_sched_next_due_us();
+    if (sleep_us > SELF_TEST_WDT_SLEEP_MAX_US)
+    {
+        sleep_us = SELF_TEST_WDT_SLEEP_MAX_US;
+    }
+    self_test_wdt_service();
+    now = analog_backend_time_us();
+    lp_stats.total_us += now - lp_last_us;
+
+    if (sleep_us >= SELF_TEST_LP_MIN_SLEEP_US)
+    {
+        lp_wake_reason = analog_backend_deep_sleep(sleep_us);
+        lp_wake_us = analog_backend_time_us();
+        lp_stats.asleep_us += lp_wake_us - now;
+
+        switch (lp_wake_reason)
+        {
+            case ANALOG_WAKE_TIMER:
+                lp_stats.timer_wakes++;
+                break;
+            case ANALOG_WAKE_COMPARATOR:
+                lp_stats.comp_wakes++;
+                break;
+            default:
+                lp_stats.other_wakes++;
+                break;
+        }
+    }
+    else
+    {
+        analog_backend_delay_us(sleep_us);
+        lp_wake_reason = ANALOG_WAKE_TIMER;
+        lp_wake_us = analog_backend_time_us();
+    }
+
+    lp_stats.total_us += lp_wake_us - now;
+    lp_last_us = lp_wake_us;
+}
+
+/*******************************************************************************
+* Function Name: self_test_lp_get_stats
+********************************************************************************
+* Summary:
+* Returns the low-power statistics.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  Pointer to the statistics
+*
+*******************************************************************************/
+const self_test_lp_stats_t *self_test_lp_get_stats(void)
+{
+    return &lp_stats;
+}
+
+/*******************************************************************************
+* Function Name: self_test_lp_average_na
+********************************************************************************
+* Summary:
+* Estimates the average supply current from the measured duty cycle and the
+* active and deep sleep currents, SELF_TEST_LP_ACTIVE_UA and
+* SELF_TEST_LP_SLEEP_UA.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  Average current in nanoamperes, 0 before the first wake-up
+*
+*******************************************************************************/
+uint32_t self_test_lp_average_na(void)
+{
+    uint64_t awake_us = lp_stats.total_us - lp_stats.asleep_us;
+
+    if (0u == lp_stats.total_us)
+    {
+        return 0u;
+    }
+
+    return (uint32_t)((((uint64_t)SELF_TEST_LP_ACTIVE_UA * awake_us) +
+            ((uint64_t)SELF_TEST_LP_SLEEP_UA * lp_stats.asleep_us)) * 1000u /
+            lp_stats.total_us);
+}
+
+/*******************************************************************************
+* Function Name: self_test_lp_print_stats
+********************************************************************************
+* Summary:
+* Prints the wake-ups, the duty cycle, the estimated average current and the
+* wake-to-result latency.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_lp_print_stats(void)
+{
+    uint64_t awake_us = lp_stats.total_us - lp_stats.asleep_us;
+    uint32_t average_na = self_test_lp_average_na();
+    uint32_t duty_ppm = (0u == lp_stats.total_us) ? 0u :
+            (uint32_t)((awake_us * 1000000u) / lp_stats.total_us);
+
+    printf("Low power: wake-ups %lu timer, %lu comparator, %lu other; "
+           "awake %lu.%04lu %%\r\n",
+            (unsigned long)lp_stats.timer_wakes, (unsigned long)lp_stats.comp_wakes,
+            (unsigned long)lp_stats.other_wakes, (unsigned long)(duty_ppm / 10000u),
+            (unsigned long)(duty_ppm % 10000u));
+    printf("  average current %lu.%03lu uA (estimated, %u uA active, %u uA deep sleep)\r\n",
+            (unsigned long)(average_na / 1000u), (unsigned long)(average_na % 1000u),
+            SELF_TEST_LP_ACTIVE_UA, SELF_TEST_LP_SLEEP_UA);
+    if (0u != lp_stats.latency_count)
+    {
+        printf("  wake-to-result min %lu us, avg %lu us, max %lu us over %lu runs\r\n",
+                (unsigned long)lp_stats.latency_min_us,
+                (unsigned long)(lp_stats.latency_sum_us / lp_stats.latency_count),
+                (unsigned long)lp_stats.latency_max_us,
+                (unsigned long)lp_stats.latency_count);
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,104 @@
+/******************************************************************************
+* File Name:   self_test_lp.h
+*
+* Description: This file is the public interface of self_test_lp.c, the
+*              low-power mode that runs the scheduled self tests from timer
+*              wake-ups and deep-sleeps in between.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_LP_H_
+#define SELF_TEST_LP_H_
+
+#include "self_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Set to 1 to run the self tests in low-power mode instead of the console */
+#ifndef SELF_TEST_LOW_POWER_MODE
+    #define SELF_TEST_LOW_POWER_MODE       (0)
+#endif
+
+/* Supply current while the CPU is active and while in deep sleep, in
+ * microamperes. Datasheet typicals for the CM4 at 100 MHz and for deep sleep
+ * with the LPCOMP in ULP mode and the low-power timer running; adjust them to
+ * the clock and power settings of the design.
+ */
+#define SELF_TEST_LP_ACTIVE_UA             (4000u)
+#define SELF_TEST_LP_SLEEP_UA              (7u)
+
+/* Shortest gap worth a deep sleep; shorter gaps are busy-waited */
+#define SELF_TEST_LP_MIN_SLEEP_US          (1000u)
+
+/* Poll interval while a test waits on the hardware */
+#define SELF_TEST_LP_POLL_US               (1u)
+
+/* Interval of the statistics report, in microseconds */
+#define SELF_TEST_LP_REPORT_US             (10000000u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Low-power mode statistics */
+typedef struct
+{
+    uint32_t timer_wakes;          /* Wake-ups by the low-power timer */
+    uint32_t comp_wakes;           /* Wake-ups by the comparator supervisor */
+    uint32_t other_wakes;          /* Wake-ups by any other interrupt */
+    uint64_t total_us;             /* Time since self_test_lp_init */
+    uint64_t asleep_us;            /* Time spent in deep sleep */
+    uint32_t latency_count;        /* Wake-ups that completed tests */
+    uint32_t latency_min_us;       /* Shortest wake-to-result time */
+    uint32_t latency_max_us;       /* Longest wake-to-result time */
+    uint64_t latency_sum_us;       /* Sum of the wake-to-result times */
+} self_test_lp_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void self_test_lp_init(void);
+void self_test_lp_step(void);
+const self_test_lp_stats_t *self_test_lp_get_stats(void);
+uint32_t self_test_lp_average_na(void);
+void self_test_lp_print_stats(void);
+
+#endif /* SELF_TEST_LP_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,312 @@
+/******************************************************************************
+* File Name:   self_test_mailbox.c
+*
+* Description: This file implements the mailbox that carries self-test
+*              results from the CM0+ to the CM4. The mailbox is a ring buffer
+*              in shared memory with one writer per index, so posting and
+*              receiving never block and need no IPC lock. The IPC driver is
+*              used only once, to pass the mailbox address to the CM0+ at
+*              startup. The CM4 cost of receiving and handling each result is
+*              measured.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "self_test_mailbox.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Consumer side state */
+static self_test_mailbox_stats_t mailbox_stats;
+static uint32_t mailbox_next_seq;
+
+/*******************************************************************************
+* Function Name: self_test_mailbox_init
+********************************************************************************
+* Summary:
+* Empties the mailbox and resets the consumer statistics. Called by the
+* consumer before the mailbox is published.
+*
+* Parameters:
+*  mailbox : Mailbox in shared memory
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_mailbox_init(self_test_mailbox_t *mailbox)
+{
+    (void)memset(mailbox, 0, sizeof(*mailbox));
+    (void)memset(&mailbox_stats, 0, sizeof(mailbox_stats));
+    mailbox_next_seq = 0u;
+}
+
+/*******************************************************************************
+* Function Name: self_test_mailbox_post
+********************************************************************************
+* Summary:
+* Posts a result to the consumer without waiting. If the mailbox is full, the
+* result is dropped and counted.
+*
+* Parameters:
+*  mailbox : Mailbox in shared memory
+*  msg     : Result to post; the sequence number is assigned here
+*
+* Return :
+*  true if the result was posted
+*
+*******************************************************************************/
+bool self_test_mailbox_post(self_test_mailbox_t *mailbox, const self_test_mailbox_msg_t *msg)
+{
+    uint32_t head = mailbox->head;
+    self_test_mailbox_msg_t *slot;
+
+    if ((head - mailbox->tail) >= SELF_TEST_MAILBOX_DEPTH)
+    {
+        mailbox->dropped++;
+        return false;
+    }
+
+    slot = &mailbox->msg[head % SELF_TEST_MAILBOX_DEPTH];
+    *slot = *msg;
+    slot->seq = head + mailbox->dropped;
+
+    /* The message must be complete before the consumer can see it */
+    SELF_TEST_MAILBOX_BARRIER();
+    mailbox->head = head + 1u;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: self_test_mailbox_receive
+********************************************************************************
+* Summary:
+* Takes the oldest result from the mailbox without waiting.
+*
+* Parameters:
+*  mailbox : Mailbox in shared memory
+*  msg     : Returns the result
+*
+* Return :
+*  true if a result was received, false if the mailbox is empty
+*
+*******************************************************************************/
+bool self_test_mailbox_receive(self_test_mailbox_t *mailbox, self_test_mailbox_msg_t *msg)
+{
+    uint32_t tail = mailbox->tail;
+
+    if (tail == mailbox->head)
+    {
+        return false;
+    }
+
+    /* Read the message only after its index was seen */
+    SELF_TEST_MAILBOX_BARRIER();
+    *msg = mailbox->msg[tail % SELF_TEST_MAILBOX_DEPTH];
+
+    /* The copy must be complete before the producer may reuse the slot */
+    SELF_TEST_MAILBOX_BARRIER();
+    mailbox->tail = tail + 1u;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: self_test_mailbox_process
+********************************************************************************
+* Summary:
+* Receives up to max results and passes each to handler. The CPU time of
+* receiving and handling each result is recorded, which is the consumer's
+* overhead per diagnostic cycle.
+*
+* Parameters:
+*  mailbox : Mailbox in shared memory
+*  handler : Called for each result
+*  max     : Largest number of results to handle
+*
+* Return :
+*  Number of results handled
+*
+*******************************************************************************/
+uint32_t self_test_mailbox_process(self_test_mailbox_t *mailbox,
+        self_test_mailbox_handler_t handler, uint32_t max)
+{
+    self_test_mailbox_msg_t msg;
+    uint32_t handled = 0u;
+
+    while (handled < max)
+    {
+        uint32_t start = analog_backend_cpu_ticks();
+        uint32_t ticks;
+
+        if (!self_test_mailbox_receive(mailbox, &msg))
+        {
+            break;
+        }
+        handler(&msg);
+        ticks = analog_backend_cpu_ticks() - start;
+
+        mailbox_stats.seq_gaps += msg.seq - mailbox_next_seq;
+        mailbox_next_seq = msg.seq + 1u;
+
+        if ((0u == mailbox_stats.received) || (ticks < mailbox_stats.min_ticks))
+        {
+            mailbox_stats.min_ticks = ticks;
+        }
+        if (ticks > mailbox_stats.max_ticks)
+        {
+            mailbox_stats.max_ticks = ticks;
+        }
+        mailbox_stats.sum_ticks += ticks;
+        mailbox_stats.received++;
+        handled++;
+    }
+
+    return handled;
+}
+
+/*******************************************************************************
+* Function Name: self_test_mailbox_get_stats
+********************************************************************************
+* Summary:
+* Returns the consumer statistics.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  Pointer to the statistics
+*
+*******************************************************************************/
+const self_test_mailbox_stats_t *self_test_mailbox_get_stats(void)
+{
+    return &mailbox_stats;
+}
+
+/*******************************************************************************
+* Function Name: self_test_mailbox_print_stats
+********************************************************************************
+* Summary:
+* Prints the number of results received and lost and the consumer cost per
+* result.
+*
+* Parameters:
+*  mailbox : Mailbox in shared memory
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_mailbox_print_stats(const self_test_mailbox_t *mailbox)
+{
+    uint32_t ticks_per_us = analog_backend_cpu_ticks_per_us();
+
+    printf("Mailbox: %lu results received, %lu dropped, %lu sequence gaps\r\n",
+            (unsigned long)mailbox_stats.received, (unsigned long)mailbox->dropped,
+            (unsigned long)mailbox_stats.seq_gaps);
+    if (0u != mailbox_stats.received)
+    {
+        printf("  cost per result min %lu, avg %lu, max %lu ticks (max %lu us)\r\n",
+                (unsigned long)mailbox_stats.min_ticks,
+                (unsigned long)(mailbox_stats.sum_ticks / mailbox_stats.received),
+                (unsigned long)mailbox_stats.max_ticks,
+                (unsigned long)(mailbox_stats.max_ticks / ticks_per_us));
+    }
+}
+
+#if !defined(SELF_TEST_HOST_SIM)
+/*******************************************************************************
+* Function Name: self_test_mailbox_publish
+********************************************************************************
+* Summary:
+* Empties the mailbox and passes its address to the CM0+ through the data
+* register of SELF_TEST_MAILBOX_IPC_CHANNEL. The channel stays locked to mark
+* the address as valid. Called once by the CM4 before it starts the CM0+
+* self tests.
+*
+* Parameters:
+*  mailbox : Mailbox in memory accessible by both cores
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_mailbox_publish(self_test_mailbox_t *mailbox)
+{
+    IPC_STRUCT_Type *ipc = Cy_IPC_Drv_GetIpcBaseAddress(SELF_TEST_MAILBOX_IPC_CHANNEL);
+
+    self_test_mailbox_init(mailbox);
+    Cy_IPC_Drv_WriteDataValue(ipc, 0u);
+
+    if (CY_IPC_DRV_SUCCESS != Cy_IPC_Drv_LockAcquire(ipc))
+    {
+        CY_ASSERT(0);
+    }
+    SELF_TEST_MAILBOX_BARRIER();
+    Cy_IPC_Drv_WriteDataValue(ipc, (uint32_t)mailbox);
+}
+
+/*******************************************************************************
+* Function Name: self_test_mailbox_attach
+********************************************************************************
+* Summary:
+* Returns the mailbox published by the CM4, without waiting. Called by the
+* CM0+ until it succeeds.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  The mailbox, NULL if not yet published
+*
+*******************************************************************************/
+self_test_mailbox_t *self_test_mailbox_attach(void)
+{
+    IPC_STRUCT_Type *ipc = Cy_IPC_Drv_GetIpcBaseAddress(SELF_TEST_MAILBOX_IPC_CHANNEL);
+    uint32_t address = Cy_IPC_Drv_ReadDataValue(ipc);
+
+    if (!Cy_IPC_Drv_IsLockAcquired(ipc) || (0u == address))
+    {
+        return NULL;
+    }
+
+    SELF_TEST_MAILBOX_BARRIER();
+    return (self_test_mailbox_t *)address;
+}
+#endif
+
+/* [] END OF FILE */
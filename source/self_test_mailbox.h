@@ -0,0 +1,130 @@
+/******************************************************************************
+* File Name:   self_test_mailbox.h
+*
+* Description: This file is the public interface of self_test_mailbox.c, the
+*              lock-free shared-memory mailbox that carries the results of the
+*              self tests run on the CM0+ to the CM4.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_MAILBOX_H_
+#define SELF_TEST_MAILBOX_H_
+
+#include "self_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Set to 1 when the self tests run on the CM0+ (see source/cm0p) and the CM4
+ * only receives their results.
+ */
+#ifndef SELF_TEST_DUAL_CORE
+    #define SELF_TEST_DUAL_CORE            (0)
+#endif
+
+/* Number of messages the mailbox holds, a power of two */
+#define SELF_TEST_MAILBOX_DEPTH            (16u)
+
+/* IPC channel used once at startup to pass the mailbox address to the CM0+ */
+#define SELF_TEST_MAILBOX_IPC_CHANNEL      (CY_IPC_CHAN_USER)
+
+/* Orders the message contents against the index that publishes them. The
+ * PSoC 6 cores have no data cache, so a memory barrier is sufficient.
+ */
+#if defined(SELF_TEST_HOST_SIM)
+    #define SELF_TEST_MAILBOX_BARRIER()    __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#else
+    #define SELF_TEST_MAILBOX_BARRIER()    __DMB()
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Result of one completed self test */
+typedef struct
+{
+    uint32_t seq;                  /* Sequence number, set by the mailbox */
+    uint32_t time_us;              /* Completion time on the producer */
+    int32_t value;                 /* Measured value */
+    uint8_t id;                    /* self_test_id_t */
+    uint8_t status;                /* OK_STATUS if the test passed */
+} self_test_mailbox_msg_t;
+
+/* Single-producer, single-consumer ring in memory shared by both cores. head
+ * is written only by the producer (CM0+), tail only by the consumer (CM4),
+ * so neither side ever waits for the other.
+ */
+typedef struct
+{
+    volatile uint32_t head;        /* Messages posted */
+    volatile uint32_t tail;        /* Messages received */
+    volatile uint32_t dropped;     /* Messages lost because the ring was full */
+    self_test_mailbox_msg_t msg[SELF_TEST_MAILBOX_DEPTH];
+} self_test_mailbox_t;
+
+/* Called by self_test_mailbox_process for each received message */
+typedef void (*self_test_mailbox_handler_t)(const self_test_mailbox_msg_t *msg);
+
+/* Consumer statistics, kept in the consumer's private memory */
+typedef struct
+{
+    uint32_t received;             /* Messages handled */
+    uint32_t seq_gaps;             /* Messages lost, from the sequence numbers */
+    uint32_t min_ticks;            /* Shortest receive and handling time */
+    uint32_t max_ticks;            /* Longest receive and handling time */
+    uint64_t sum_ticks;            /* Sum of the receive and handling times */
+} self_test_mailbox_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void self_test_mailbox_init(self_test_mailbox_t *mailbox);
+bool self_test_mailbox_post(self_test_mailbox_t *mailbox, const self_test_mailbox_msg_t *msg);
+bool self_test_mailbox_receive(self_test_mailbox_t *mailbox, self_test_mailbox_msg_t *msg);
+uint32_t self_test_mailbox_process(self_test_mailbox_t *mailbox,
+        self_test_mailbox_handler_t handler, uint32_t max);
+const self_test_mailbox_stats_t *self_test_mailbox_get_stats(void);
+void self_test_mailbox_print_stats(const self_test_mailbox_t *mailbox);
+
+void self_test_mailbox_publish(self_test_mailbox_t *mailbox);
+self_test_mailbox_t *self_test_mailbox_attach(void);
+
+#endif /* SELF_TEST_MAILBOX_H_ */
+
+/* [] END OF FILE */
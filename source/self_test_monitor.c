@@ -0,0 +1,318 @@
+/******************************************************************************
+* File Name:   self_test_monitor.c
+*
+* Description: This file implements the background ADC plausibility monitor.
+*              Every reference or bandgap sample taken by a SAR scan is fed
+*              in and updates, in constant time and without a sample history,
+*              an exponentially weighted running mean and variance, a drift
+*              tracker against the first window, and the sums of the current
+*              window. A fault is raised only when the mean of
+*              SELF_TEST_MONITOR_FAULT_WINDOWS consecutive windows leaves
+*              ANALOG_ADC_ACURACCY, so single noisy samples do not trip it.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "self_test_monitor.h"
+#include "self_test_log.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static self_test_monitor_config_t monitor_config;
+static self_test_monitor_stream_t monitor_streams[SELF_TEST_MONITOR_STREAMS];
+
+static const char * const monitor_stream_names[SELF_TEST_MONITOR_STREAMS] =
+{
+    "Reference",
+#if (VBG_CHANNEL != ADC_REF_CHANNEL)
+    "Bandgap",
+#endif
+};
+
+/*******************************************************************************
+* Function Name: monitor_window_done
+********************************************************************************
+* Summary:
+* Evaluates a complete window and starts the next one. The first window of the
+* bandgap, when it is monitored, sets its expected reading; the first window
+* of every channel sets the drift baseline.
+*
+*******************************************************************************/
+static void monitor_window_done(uint8_t index, self_test_monitor_stream_t *stream)
+{
+    int32_t window_q = self_test_stats_mean_q(&stream->window);
+    int32_t window_mv = window_q / (1 << SELF_TEST_STATS_Q);
+    int32_t deviation_mv;
+
+    self_test_stats_reset(&stream->window);
+    stream->last_window_q = window_q;
+    stream->windows++;
+
+    if (!stream->learned)
+    {
+        if (0 == stream->expected_mv)
+        {
+            stream->expected_mv = window_mv;
+        }
+        stream->baseline_q = window_q;
+        stream->learned = true;
+    }
+
+    deviation_mv = window_mv - stream->expected_mv;
+    if ((deviation_mv >= -stream->accuracy_mv) && (deviation_mv <= stream->accuracy_mv))
+    {
+        stream->bad_run = 0u;
+        return;
+    }
+
+    stream->bad_windows++;
+    stream->bad_run++;
+    if (stream->bad_run == monitor_config.fault_windows)
+    {
+        stream->faults++;
+        self_test_log(SELF_TEST_LOG_MONITOR, ERROR_STATUS, index, window_mv,
+                stream->expected_mv);
+        if (NULL != monitor_config.fault_cb)
+        {
+            monitor_config.fault_cb(index, window_mv);
+        }
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_monitor_init
+********************************************************************************
+* Summary:
+* Resets the monitor. The reference channel is expected at ADC_REF_EXPECTED.
+* The bandgap is only monitored when it has its own SAR channel; its expected
+* reading is then learned from its first window.
+*
+* Parameters:
+*  config : Monitor configuration, copied; NULL selects the defaults
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_monitor_init(const self_test_monitor_config_t *config)
+{
+    uint32_t i;
+
+    if (NULL != config)
+    {
+        monitor_config = *config;
+    }
+    else
+    {
+        monitor_config.window_samples = SELF_TEST_MONITOR_WINDOW;
+        monitor_config.fault_windows = SELF_TEST_MONITOR_FAULT_WINDOWS;
+        monitor_config.ewma_shift = SELF_TEST_MONITOR_EWMA_SHIFT;
+        monitor_config.fault_cb = NULL;
+    }
+
+    (void)memset(monitor_streams, 0, sizeof(monitor_streams));
+    for (i = 0u; i < SELF_TEST_MONITOR_STREAMS; i++)
+    {
+        self_test_stats_reset(&monitor_streams[i].window);
+        monitor_streams[i].accuracy_mv = ANALOG_ADC_ACURACCY;
+    }
+    monitor_streams[SELF_TEST_LOG_CHANNEL_REF].channel = ADC_REF_CHANNEL;
+    monitor_streams[SELF_TEST_LOG_CHANNEL_REF].expected_mv = ADC_REF_EXPECTED;
+#if (VBG_CHANNEL != ADC_REF_CHANNEL)
+    monitor_streams[SELF_TEST_LOG_CHANNEL_VBG].channel = VBG_CHANNEL;
+#endif
+}
+
+/*******************************************************************************
+* Function Name: self_test_monitor_feed
+********************************************************************************
+* Summary:
+* Adds one sample. Samples of channels that are not monitored are ignored.
+* Constant time: a few adds, shifts and one 64-bit multiply per sample.
+*
+* Parameters:
+*  channel : SAR channel the sample was taken on
+*  mv      : Sample in millivolts
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_monitor_feed(uint32_t channel, int32_t mv)
+{
+    int32_t scale = 1 << monitor_config.ewma_shift;
+    self_test_monitor_stream_t *stream = NULL;
+    uint8_t index;
+    int32_t delta_q;
+    int64_t delta_sq_q;
+    int32_t drift_q;
+
+    for (index = 0u; index < SELF_TEST_MONITOR_STREAMS; index++)
+    {
+        if (channel == monitor_streams[index].channel)
+        {
+            stream = &monitor_streams[index];
+            break;
+        }
+    }
+    if ((NULL == stream) || (0u == monitor_config.window_samples))
+    {
+        return;
+    }
+
+    /* Running mean and variance: m += d / 2^k, v += (d^2 - v) / 2^k */
+    delta_q = (mv * (1 << SELF_TEST_STATS_Q)) - stream->mean_q;
+    if (0u == stream->samples)
+    {
+        stream->mean_q = mv * (1 << SELF_TEST_STATS_Q);
+    }
+    else
+    {
+        delta_sq_q = ((int64_t)delta_q * delta_q) / (1 << SELF_TEST_STATS_Q);
+        stream->mean_q += delta_q / scale;
+        stream->variance_q = (uint32_t)((int64_t)stream->variance_q +
+                ((delta_sq_q - (int64_t)stream->variance_q) / scale));
+    }
+    stream->samples++;
+
+    if (stream->learned)
+    {
+        drift_q = stream->mean_q - stream->baseline_q;
+        if (drift_q < stream->drift_min_q)
+        {
+            stream->drift_min_q = drift_q;
+        }
+        if (drift_q > stream->drift_max_q)
+        {
+            stream->drift_max_q = drift_q;
+        }
+    }
+
+    self_test_stats_add(&stream->window, mv);
+    if (stream->window.count >= monitor_config.window_samples)
+    {
+        monitor_window_done(index, stream);
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_monitor_feed_scan
+********************************************************************************
+* Summary:
+* Adds the results of a SAR scan. Call it with the raw results of any scan
+* that includes the reference or bandgap channel.
+*
+* Parameters:
+*  channels : SAR channels of the scan
+*  counts   : Raw results, in the order of channels
+*  count    : Number of channels
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_monitor_feed_scan(const uint32_t *channels, const int16_t *counts,
+        uint32_t count)
+{
+    uint32_t i;
+
+    for (i = 0u; i < count; i++)
+    {
+        self_test_monitor_feed(channels[i],
+                analog_backend_adc_counts_to_mv(channels[i], counts[i]));
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_monitor_get_stream
+********************************************************************************
+* Summary:
+* Returns the state of a monitored channel.
+*
+* Parameters:
+*  stream : SELF_TEST_LOG_CHANNEL_REF, or SELF_TEST_LOG_CHANNEL_VBG if
+*           SELF_TEST_MONITOR_STREAMS includes the bandgap
+*
+* Return :
+*  Pointer to the state, NULL if the channel is not monitored
+*
+*******************************************************************************/
+const self_test_monitor_stream_t *self_test_monitor_get_stream(uint8_t stream)
+{
+    return (stream < SELF_TEST_MONITOR_STREAMS) ? &monitor_streams[stream] : NULL;
+}
+
+/*******************************************************************************
+* Function Name: self_test_monitor_print_stats
+********************************************************************************
+* Summary:
+* Prints the running mean and variance, the drift range, the last window mean
+* and the window and fault counts of every monitored channel.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_monitor_print_stats(void)
+{
+    uint32_t i;
+
+    for (i = 0u; i < SELF_TEST_MONITOR_STREAMS; i++)
+    {
+        const self_test_monitor_stream_t *stream = &monitor_streams[i];
+
+        printf("%-9s ch %lu: %lu samples, mean %ld mV, variance %lu mV^2, "
+               "drift %ld..%ld mV\r\n", monitor_stream_names[i],
+                (unsigned long)stream->channel, (unsigned long)stream->samples,
+                (long)(stream->mean_q / (1 << SELF_TEST_STATS_Q)),
+                (unsigned long)(stream->variance_q >> SELF_TEST_STATS_Q),
+                (long)(stream->drift_min_q / (1 << SELF_TEST_STATS_Q)),
+                (long)(stream->drift_max_q / (1 << SELF_TEST_STATS_Q)));
+        printf("          expected %ld +/- %ld mV, last window %ld mV, windows %lu, "
+               "out of accuracy %lu, faults %lu\r\n", (long)stream->expected_mv,
+                (long)stream->accuracy_mv,
+                (long)(stream->last_window_q / (1 << SELF_TEST_STATS_Q)),
+                (unsigned long)stream->windows, (unsigned long)stream->bad_windows,
+                (unsigned long)stream->faults);
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,123 @@
+/******************************************************************************
+* File Name:   self_test_monitor.h
+*
+* Description: This file is the public interface of self_test_monitor.c, the
+*              background plausibility monitor that checks the reference and
+*              bandgap readings of the SAR scans the firmware already runs.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_MONITOR_H_
+#define SELF_TEST_MONITOR_H_
+
+#include "self_test.h"
+#include "self_test_stats.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Samples per evaluation window */
+#define SELF_TEST_MONITOR_WINDOW           (16u)
+
+/* Consecutive windows out of accuracy that raise a fault */
+#define SELF_TEST_MONITOR_FAULT_WINDOWS    (2u)
+
+/* Time constant of the running mean and variance, 2^shift samples */
+#define SELF_TEST_MONITOR_EWMA_SHIFT       (4u)
+
+/* Monitored channels: the reference channel, and the bandgap channel when it
+ * has its own SAR channel. The index matches SELF_TEST_LOG_CHANNEL_*.
+ */
+#if (VBG_CHANNEL != ADC_REF_CHANNEL)
+    #define SELF_TEST_MONITOR_STREAMS      (2u)
+#else
+    #define SELF_TEST_MONITOR_STREAMS      (1u)
+#endif
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Called when a monitored channel is found implausible */
+typedef void (*self_test_monitor_fault_cb_t)(uint8_t stream, int32_t window_mean_mv);
+
+/* Monitor configuration */
+typedef struct
+{
+    uint32_t window_samples;       /* See SELF_TEST_MONITOR_WINDOW */
+    uint32_t fault_windows;        /* See SELF_TEST_MONITOR_FAULT_WINDOWS */
+    uint32_t ewma_shift;           /* See SELF_TEST_MONITOR_EWMA_SHIFT */
+    self_test_monitor_fault_cb_t fault_cb; /* Optional fault callback */
+} self_test_monitor_config_t;
+
+/* State and statistics of one monitored channel. Values with a _q suffix
+ * have SELF_TEST_STATS_Q fractional bits.
+ */
+typedef struct
+{
+    uint32_t channel;              /* SAR channel */
+    int32_t expected_mv;           /* Expected reading, learned for the bandgap */
+    int32_t accuracy_mv;           /* Allowed deviation of a window mean */
+    bool learned;                  /* expected_mv and baseline_q are set */
+    int32_t mean_q;                /* Running mean, in mV */
+    uint32_t variance_q;           /* Running variance, in mV^2 */
+    int32_t baseline_q;            /* Mean of the first window */
+    int32_t drift_min_q;           /* Lowest running mean minus baseline */
+    int32_t drift_max_q;           /* Highest running mean minus baseline */
+    self_test_stats_t window;      /* Sums of the current window */
+    int32_t last_window_q;         /* Mean of the last complete window */
+    uint32_t samples;              /* Samples seen */
+    uint32_t windows;              /* Complete windows */
+    uint32_t bad_windows;          /* Windows out of accuracy */
+    uint32_t bad_run;              /* Consecutive windows out of accuracy */
+    uint32_t faults;               /* Faults raised */
+} self_test_monitor_stream_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void self_test_monitor_init(const self_test_monitor_config_t *config);
+void self_test_monitor_feed(uint32_t channel, int32_t mv);
+void self_test_monitor_feed_scan(const uint32_t *channels, const int16_t *counts,
+        uint32_t count);
+const self_test_monitor_stream_t *self_test_monitor_get_stream(uint8_t stream);
+void self_test_monitor_print_stats(void);
+
+#endif /* SELF_TEST_MONITOR_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,684 @@
+/******************************************************************************
+* File Name:   self_test_nvlog.c
+*
+* Description: This file implements the non-volatile store of self-test
+*              results: an append-only log of 16-byte records in the pages the
+*              analog backend reserves in flash. Appending only queues the
+*              record in RAM, so the test path never waits on the flash. The
+*              main loop writes the queued records to the head page, several
+*              at once, with a non-blocking page write. The head moves through
+*              all pages in turn, so every page is written equally often, and
+*              the oldest page is overwritten once the store is full. Each
+*              record carries a sequence number and a CRC; at start-up the
+*              head is found again from them, and records torn by a power
+*              loss are ignored.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include "self_test_nvlog.h"
+#include "self_test_proto.h"
+#include "self_test_trace.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Bytes of a record covered by its CRC */
+#define NVLOG_CRC_BYTES                    (offsetof(self_test_nvlog_record_t, crc))
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Periodic results of one test in the current summary interval */
+typedef struct
+{
+    uint32_t runs;                 /* Results */
+    uint32_t failures;             /* Failed results */
+    uint32_t changes;              /* Verdict changes stored */
+    uint8_t status;                /* Last verdict stored */
+    bool stored;                   /* status holds a stored verdict */
+} nvlog_periodic_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* RAM image of the head page. The backend reads it while a write is in
+ * progress, so it is only changed between writes.
+ */
+static union
+{
+    uint32_t words[ANALOG_BACKEND_NV_PAGE_SIZE / sizeof(uint32_t)];
+    self_test_nvlog_record_t records[SELF_TEST_NVLOG_SLOTS];
+} nvlog_image;
+
+static uint32_t nvlog_page;                /* Head page */
+static uint32_t nvlog_slot;                /* Records in the head page image */
+static uint32_t nvlog_seq;                 /* Sequence number of the next record */
+static bool nvlog_dirty;                   /* Image holds unwritten records */
+static bool nvlog_urgent;                  /* Of them, one has ERROR_STATUS */
+static bool nvlog_flush_pending;           /* self_test_nvlog_flush was called */
+static uint32_t nvlog_dirty_ms;            /* Oldest unwritten record entered the image */
+static bool nvlog_writing;                 /* Page write in progress */
+static uint32_t nvlog_write_start_us;
+static uint32_t nvlog_write_seq;           /* Records committed by the write */
+
+/* Queued records; nvlog_queue_head is written by the appends only and
+ * nvlog_queue_tail by self_test_nvlog_process only.
+ */
+static self_test_nvlog_record_t nvlog_queue[SELF_TEST_NVLOG_QUEUE];
+static uint32_t nvlog_queue_head;
+static uint32_t nvlog_queue_tail;
+
+/* Time since start-up, extended from the 32-bit microsecond time base */
+static uint32_t nvlog_time_ms;
+static uint32_t nvlog_time_us;
+static uint32_t nvlog_time_last_us;
+
+/* Periodic results since the last summary */
+static nvlog_periodic_t nvlog_periodic[SELF_TEST_ID_COUNT];
+static uint32_t nvlog_summary_ms;
+
+static self_test_nvlog_stats_t nvlog_stats;
+static self_test_nvlog_record_t nvlog_print_buf[SELF_TEST_NVLOG_PRINT_MAX];
+
+static const char * const nvlog_test_names[SELF_TEST_ID_COUNT] =
+{
+    [SELF_TEST_ID_ADC] = "ADC",
+    [SELF_TEST_ID_COMPARATOR] = "Comparator",
+    [SELF_TEST_ID_OPAMP] = "OP-AMP",
+};
+
+/*******************************************************************************
+* Function Name: nvlog_time_update
+********************************************************************************
+* Summary:
+* Advances the millisecond clock. It must be called at least once per wrap of
+* the microsecond time base, which the main loop does through
+* self_test_nvlog_process.
+*
+*******************************************************************************/
+static void nvlog_time_update(void)
+{
+    uint32_t now = analog_backend_time_us();
+
+    nvlog_time_us += now - nvlog_time_last_us;
+    nvlog_time_last_us = now;
+    nvlog_time_ms += nvlog_time_us / 1000u;
+    nvlog_time_us %= 1000u;
+}
+
+/*******************************************************************************
+* Function Name: nvlog_record_crc
+********************************************************************************
+* Summary:
+* Returns the CRC of a record.
+*
+*******************************************************************************/
+static uint16_t nvlog_record_crc(const self_test_nvlog_record_t *record)
+{
+    return self_test_proto_crc(0xFFFFu, (const uint8_t *)record, NVLOG_CRC_BYTES);
+}
+
+/*******************************************************************************
+* Function Name: nvlog_record_valid
+********************************************************************************
+* Summary:
+* Checks the CRC of a record read from the store. Erased and torn records
+* fail it.
+*
+*******************************************************************************/
+static bool nvlog_record_valid(const self_test_nvlog_record_t *record)
+{
+    return (record->crc == nvlog_record_crc(record));
+}
+
+/*******************************************************************************
+* Function Name: nvlog_page_records
+********************************************************************************
+* Summary:
+* Returns the records of a page in the store.
+*
+*******************************************************************************/
+static const self_test_nvlog_record_t *nvlog_page_records(uint32_t page)
+{
+    return (const self_test_nvlog_record_t *)(const void *)analog_backend_nv_page(page);
+}
+
+/*******************************************************************************
+* Function Name: nvlog_image_reset
+********************************************************************************
+* Summary:
+* Starts an empty image for the next head page.
+*
+*******************************************************************************/
+static void nvlog_image_reset(void)
+{
+    (void)memset(&nvlog_image, 0xFF, sizeof(nvlog_image));
+    nvlog_slot = 0u;
+}
+
+/*******************************************************************************
+* Function Name: nvlog_summarize
+********************************************************************************
+* Summary:
+* Appends a summary of the periodic results of every test that ran since the
+* last summary and starts the next interval.
+*
+*******************************************************************************/
+static void nvlog_summarize(void)
+{
+    nvlog_periodic_t *state;
+    uint32_t id;
+
+    for (id = 0u; id < (uint32_t)SELF_TEST_ID_COUNT; id++)
+    {
+        state = &nvlog_periodic[id];
+        if (0u != state->runs)
+        {
+            (void)self_test_nvlog_append((uint8_t)id | SELF_TEST_NVLOG_PERIODIC |
+                    SELF_TEST_NVLOG_SUMMARY,
+                    (uint8_t)((0u == state->failures) ? OK_STATUS : ERROR_STATUS),
+                    SELF_TEST_NVLOG_SUMMARY_VALUE(state->runs, state->failures));
+        }
+        state->runs = 0u;
+        state->failures = 0u;
+        state->changes = 0u;
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_nvlog_init
+********************************************************************************
+* Summary:
+* Mounts the store: finds the head page from the first record of every page,
+* which has the highest sequence number there, then the first free slot of
+* the head page. A torn or erased record ends the scan, so a write cut by a
+* power loss costs at most the records of that page. A boot record is then
+* appended, which separates the results of each run.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_nvlog_init(void)
+{
+    const self_test_nvlog_record_t *records;
+    uint32_t start = analog_backend_cpu_ticks();
+    uint32_t best_page = ANALOG_BACKEND_NV_PAGES;
+    uint32_t best_seq = 0u;
+    uint32_t page;
+    uint32_t slot;
+
+    (void)memset(&nvlog_stats, 0, sizeof(nvlog_stats));
+    nvlog_queue_head = 0u;
+    nvlog_queue_tail = 0u;
+    nvlog_dirty = false;
+    nvlog_urgent = false;
+    nvlog_flush_pending = false;
+    nvlog_writing = false;
+    nvlog_time_ms = 0u;
+    nvlog_time_us = 0u;
+    nvlog_time_last_us = analog_backend_time_us();
+    (void)memset(nvlog_periodic, 0, sizeof(nvlog_periodic));
+    nvlog_summary_ms = 0u;
+
+    for (page = 0u; page < ANALOG_BACKEND_NV_PAGES; page++)
+    {
+        records = nvlog_page_records(page);
+        if (nvlog_record_valid(&records[0]) &&
+            ((ANALOG_BACKEND_NV_PAGES == best_page) || (records[0].seq > best_seq)))
+        {
+            best_page = page;
+            best_seq = records[0].seq;
+        }
+    }
+    nvlog_stats.mount_pages = ANALOG_BACKEND_NV_PAGES;
+
+    nvlog_image_reset();
+    nvlog_page = 0u;
+    nvlog_seq = 0u;
+    if (ANALOG_BACKEND_NV_PAGES != best_page)
+    {
+        records = nvlog_page_records(best_page);
+        for (slot = 0u; slot < SELF_TEST_NVLOG_SLOTS; slot++)
+        {
+            if ((!nvlog_record_valid(&records[slot])) ||
+                (records[slot].seq != (best_seq + slot)))
+            {
+                break;
+            }
+        }
+        nvlog_seq = best_seq + slot;
+        nvlog_page = best_page;
+        if (SELF_TEST_NVLOG_SLOTS == slot)
+        {
+            nvlog_page = (best_page + 1u) % ANALOG_BACKEND_NV_PAGES;
+        }
+        else
+        {
+            (void)memcpy(nvlog_image.records, records, slot * sizeof(records[0]));
+            nvlog_slot = slot;
+        }
+    }
+    nvlog_stats.committed_seq = nvlog_seq;
+    nvlog_stats.mount_us = (analog_backend_cpu_ticks() - start) /
+            analog_backend_cpu_ticks_per_us();
+
+    (void)self_test_nvlog_append(SELF_TEST_NVLOG_ID_BOOT, OK_STATUS, (int32_t)nvlog_seq);
+}
+
+/*******************************************************************************
+* Function Name: self_test_nvlog_append
+********************************************************************************
+* Summary:
+* Queues a result for the store in constant time. It never waits on the
+* flash; the record is written by self_test_nvlog_process. All appends must
+* be made from the same execution context.
+*
+* Parameters:
+*  id     : self_test_id_t, optionally with SELF_TEST_NVLOG_PERIODIC
+*  status : OK_STATUS or ERROR_STATUS
+*  value  : Measured value or failure mask
+*
+* Return :
+*  false if the queue was full and the record was dropped
+*
+*******************************************************************************/
+bool self_test_nvlog_append(uint8_t id, uint8_t status, int32_t value)
+{
+    self_test_nvlog_record_t *record;
+
+    nvlog_stats.appended++;
+    if ((nvlog_queue_head - nvlog_queue_tail) >= SELF_TEST_NVLOG_QUEUE)
+    {
+        nvlog_stats.dropped++;
+        return false;
+    }
+
+    nvlog_time_update();
+    record = &nvlog_queue[nvlog_queue_head % SELF_TEST_NVLOG_QUEUE];
+    record->time_ms = nvlog_time_ms;
+    record->value = value;
+    record->id = id;
+    record->status = status;
+    nvlog_queue_head++;
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: self_test_nvlog_periodic
+********************************************************************************
+* Summary:
+* Passes a result of the periodic scheduler to the store. Passing results are
+* not stored one by one: a result is appended when its verdict differs from
+* the last one stored for the test, at most SELF_TEST_NVLOG_CHANGES_MAX times
+* per summary interval, and every SELF_TEST_NVLOG_SUMMARY_MS
+* self_test_nvlog_process appends the number of runs and failures of each
+* test. The records stored therefore do not grow with the test rate.
+*
+* Parameters:
+*  id     : self_test_id_t
+*  status : OK_STATUS or ERROR_STATUS
+*  value  : Measured value
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_nvlog_periodic(uint8_t id, uint8_t status, int32_t value)
+{
+    nvlog_periodic_t *state;
+
+    if (id >= (uint8_t)SELF_TEST_ID_COUNT)
+    {
+        return;
+    }
+
+    state = &nvlog_periodic[id];
+    nvlog_stats.periodic_runs++;
+    state->runs++;
+    if (OK_STATUS != status)
+    {
+        state->failures++;
+    }
+
+    if ((!state->stored || (status != state->status)) &&
+        (state->changes < SELF_TEST_NVLOG_CHANGES_MAX) &&
+        self_test_nvlog_append(id | SELF_TEST_NVLOG_PERIODIC, status, value))
+    {
+        state->stored = true;
+        state->status = status;
+        state->changes++;
+        nvlog_stats.periodic_stored++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_nvlog_process
+********************************************************************************
+* Summary:
+* Completes a page write that has finished and moves the queued records that
+* fit into the image of the head page. Sequence numbers and CRCs are assigned
+* here, off the test path. The head page is written when it is full, when it
+* holds a record with ERROR_STATUS, after self_test_nvlog_flush, or once its
+* oldest unwritten record has waited SELF_TEST_NVLOG_COMMIT_MS. The summaries
+* of the periodic tests are appended here as well. Call it from the main
+* loop.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_nvlog_process(void)
+{
+    self_test_nvlog_record_t *record;
+    uint32_t elapsed;
+
+    nvlog_time_update();
+    if ((nvlog_time_ms - nvlog_summary_ms) >= SELF_TEST_NVLOG_SUMMARY_MS)
+    {
+        nvlog_summary_ms = nvlog_time_ms;
+        nvlog_summarize();
+    }
+
+    if (nvlog_writing)
+    {
+        if (analog_backend_nv_busy())
+        {
+            return;
+        }
+        nvlog_writing = false;
+        elapsed = analog_backend_time_us() - nvlog_write_start_us;
+        if (elapsed > nvlog_stats.max_write_us)
+        {
+            nvlog_stats.max_write_us = elapsed;
+        }
+        nvlog_stats.page_writes++;
+        nvlog_stats.committed_seq = nvlog_write_seq;
+
+        if (SELF_TEST_NVLOG_SLOTS == nvlog_slot)
+        {
+            nvlog_page = (nvlog_page + 1u) % ANALOG_BACKEND_NV_PAGES;
+            nvlog_image_reset();
+        }
+    }
+
+    while ((nvlog_queue_head != nvlog_queue_tail) && (nvlog_slot < SELF_TEST_NVLOG_SLOTS))
+    {
+        record = &nvlog_image.records[nvlog_slot];
+        *record = nvlog_queue[nvlog_queue_tail % SELF_TEST_NVLOG_QUEUE];
+        record->seq = nvlog_seq;
+        record->crc = nvlog_record_crc(record);
+        nvlog_seq++;
+        nvlog_slot++;
+        nvlog_queue_tail++;
+        if (!nvlog_dirty)
+        {
+            nvlog_dirty_ms = nvlog_time_ms;
+            nvlog_dirty = true;
+        }
+        if (OK_STATUS != record->status)
+        {
+            nvlog_urgent = true;
+        }
+    }
+
+    if (!nvlog_dirty)
+    {
+        /* Everything appended is written or being written */
+        nvlog_flush_pending = false;
+        return;
+    }
+
+    if (((SELF_TEST_NVLOG_SLOTS == nvlog_slot) || nvlog_urgent || nvlog_flush_pending ||
+         ((nvlog_time_ms - nvlog_dirty_ms) >= SELF_TEST_NVLOG_COMMIT_MS)) &&
+        analog_backend_nv_write(nvlog_page, (const uint8_t *)nvlog_image.words))
+    {
+        nvlog_dirty = false;
+        nvlog_urgent = false;
+        nvlog_flush_pending = false;
+        nvlog_writing = true;
+        nvlog_write_start_us = analog_backend_time_us();
+        nvlog_write_seq = nvlog_seq;
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_nvlog_flush
+********************************************************************************
+* Summary:
+* Has the records appended so far written by the next calls of
+* self_test_nvlog_process, without waiting for SELF_TEST_NVLOG_COMMIT_MS. Call
+* it before a planned reset or power down.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_nvlog_flush(void)
+{
+    nvlog_flush_pending = true;
+}
+
+/*******************************************************************************
+* Function Name: self_test_nvlog_latest
+********************************************************************************
+* Summary:
+* Copies the latest results, newest first: the queued records, the head page
+* image, then the older pages backwards. The walk ends at the first record
+* that is not older than the one before it, where the log wrapped, so it
+* costs O(max) record reads.
+*
+* Parameters:
+*  records : Output buffer
+*  max     : Size of the buffer in records
+*
+* Return :
+*  Number of records copied
+*
+*******************************************************************************/
+uint32_t self_test_nvlog_latest(self_test_nvlog_record_t *records, uint32_t max)
+{
+    const self_test_nvlog_record_t *page_records;
+    uint32_t count = 0u;
+    uint32_t queued = nvlog_queue_head;
+    uint32_t seq = nvlog_seq;
+    uint32_t page = nvlog_page;
+    uint32_t slot = nvlog_slot;
+    uint32_t pages;
+
+    /* Queued records have no sequence number yet */
+    while ((count < max) && (queued != nvlog_queue_tail))
+    {
+        queued--;
+        records[count] = nvlog_queue[queued % SELF_TEST_NVLOG_QUEUE];
+        records[count].seq = seq + (queued - nvlog_queue_tail);
+        count++;
+    }
+
+    while ((count < max) && (0u != slot))
+    {
+        slot--;
+        records[count] = nvlog_image.records[slot];
+        count++;
+    }
+
+    for (pages = 1u; pages < ANALOG_BACKEND_NV_PAGES; pages++)
+    {
+        page = (page + ANALOG_BACKEND_NV_PAGES - 1u) % ANALOG_BACKEND_NV_PAGES;
+        page_records = nvlog_page_records(page);
+        for (slot = SELF_TEST_NVLOG_SLOTS; (count < max) && (0u != slot); slot--)
+        {
+            const self_test_nvlog_record_t *record = &page_records[slot - 1u];
+
+            if (!nvlog_record_valid(record))
+            {
+                continue;
+            }
+            if ((0u != count) && (record->seq >= records[count - 1u].seq))
+            {
+                return count;
+            }
+            records[count] = *record;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/*******************************************************************************
+* Function Name: self_test_nvlog_get_stats
+********************************************************************************
+* Summary:
+* Returns the store statistics.
+*
+*******************************************************************************/
+const self_test_nvlog_stats_t *self_test_nvlog_get_stats(void)
+{
+    return &nvlog_stats;
+}
+
+/*******************************************************************************
+* Function Name: self_test_nvlog_print
+********************************************************************************
+* Summary:
+* Prints the store statistics and the latest results on the console.
+*
+* Parameters:
+*  count : Number of results to print, at most SELF_TEST_NVLOG_PRINT_MAX
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_nvlog_print(uint32_t count)
+{
+    uint32_t i;
+
+    printf("Result store: %lu records in %lu pages of %lu, %lu written, %lu pending, "
+           "%lu dropped\r\n", (unsigned long)SELF_TEST_NVLOG_CAPACITY,
+            (unsigned long)ANALOG_BACKEND_NV_PAGES, (unsigned long)SELF_TEST_NVLOG_SLOTS,
+            (unsigned long)nvlog_stats.committed_seq,
+            (unsigned long)((nvlog_queue_head - nvlog_queue_tail) +
+                            (nvlog_seq - nvlog_stats.committed_seq)),
+            (unsigned long)nvlog_stats.dropped);
+    printf("  %lu page writes, longest %lu us, mounted in %lu us\r\n",
+            (unsigned long)nvlog_stats.page_writes, (unsigned long)nvlog_stats.max_write_us,
+            (unsigned long)nvlog_stats.mount_us);
+    printf("  %lu periodic results, %lu verdict changes stored\r\n",
+            (unsigned long)nvlog_stats.periodic_runs,
+            (unsigned long)nvlog_stats.periodic_stored);
+
+    if (count > SELF_TEST_NVLOG_PRINT_MAX)
+    {
+        count = SELF_TEST_NVLOG_PRINT_MAX;
+    }
+    count = self_test_nvlog_latest(nvlog_print_buf, count);
+
+    for (i = 0u; i < count; i++)
+    {
+        const self_test_nvlog_record_t *record = &nvlog_print_buf[i];
+        uint8_t id = record->id & (uint8_t)~SELF_TEST_NVLOG_PERIODIC;
+
+        if (SELF_TEST_NVLOG_ID_BOOT == record->id)
+        {
+            printf("  #%-8lu %10lu ms  start-up\r\n", (unsigned long)record->seq,
+                    (unsigned long)record->time_ms);
+        }
+        else if (SELF_TEST_NVLOG_ID_POST == record->id)
+        {
+            printf("  #%-8lu %10lu ms  power-on               %s, failure mask 0x%lX, "
+                   "verdict after %lu us\r\n", (unsigned long)record->seq,
+                    (unsigned long)record->time_ms,
+                    (OK_STATUS == record->status) ? "passed" : "FAILED",
+                    (unsigned long)((uint32_t)record->value >> 24),
+                    (unsigned long)((uint32_t)record->value & SELF_TEST_NVLOG_POST_US_MAX));
+        }
+        else if (0u != (record->id & SELF_TEST_NVLOG_OVERRUN))
+        {
+            uint32_t phase = (uint32_t)record->value >> 24;
+            uint32_t us = (uint32_t)record->value & SELF_TEST_NVLOG_OVERRUN_RESET;
+
+            id = record->id & (uint8_t)~SELF_TEST_NVLOG_OVERRUN;
+            printf("  #%-8lu %10lu ms  %-10s overrun     %s phase", (unsigned long)record->seq,
+                    (unsigned long)record->time_ms,
+                    (id < (uint8_t)SELF_TEST_ID_COUNT) ? nvlog_test_names[id] : "-",
+                    (phase < (uint32_t)SELF_TEST_PHASE_COUNT) ?
+                    self_test_trace_phase_name((self_test_phase_t)phase) :
+                    (((uint32_t)SELF_TEST_PHASE_COUNT == phase) ? "run" : "start"));
+            if (SELF_TEST_NVLOG_OVERRUN_RESET == us)
+            {
+                printf(", watchdog reset\r\n");
+            }
+            else
+            {
+                printf(", %lu us\r\n", (unsigned long)us);
+            }
+        }
+        else if (0u != (record->id & SELF_TEST_NVLOG_SUMMARY))
+        {
+            id = record->id & (uint8_t)~(SELF_TEST_NVLOG_PERIODIC | SELF_TEST_NVLOG_SUMMARY);
+            printf("  #%-8lu %10lu ms  %-10s summary     %lu runs, %lu failed\r\n",
+                    (unsigned long)record->seq, (unsigned long)record->time_ms,
+                    (id < (uint8_t)SELF_TEST_ID_COUNT) ? nvlog_test_names[id] : "-",
+                    (unsigned long)((uint32_t)record->value >> 16),
+                    (unsigned long)((uint32_t)record->value & SELF_TEST_NVLOG_SUMMARY_MAX));
+        }
+        else if (id < (uint8_t)SELF_TEST_ID_COUNT)
+        {
+            printf("  #%-8lu %10lu ms  %-10s %-11s %s, value %ld\r\n",
+                    (unsigned long)record->seq, (unsigned long)record->time_ms,
+                    nvlog_test_names[id],
+                    (0u != (record->id & SELF_TEST_NVLOG_PERIODIC)) ? "periodic" : "interactive",
+                    (OK_STATUS == record->status) ? "passed" : "FAILED", (long)record->value);
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,171 @@
+/******************************************************************************
+* File Name:   self_test_nvlog.h
+*
+* Description: This file is the public interface of self_test_nvlog.c, the
+*              non-volatile store of self-test results.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_NVLOG_H_
+#define SELF_TEST_NVLOG_H_
+
+#include "self_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Records waiting for their page write. Appends beyond it are dropped. */
+#define SELF_TEST_NVLOG_QUEUE              (32u)
+
+/* Longest time a passing record waits in the RAM image of the head page
+ * before the page is written, in milliseconds. Records with ERROR_STATUS are
+ * written at once, and a full page is written at once. Each write erases the
+ * head page, so batching the passing records keeps the page erases per hour
+ * bounded by the commit interval instead of the record rate. A power loss
+ * loses at most the passing records of this interval.
+ */
+#define SELF_TEST_NVLOG_COMMIT_MS          (60000u)
+
+/* Interval of the summary records of the periodic tests, in milliseconds */
+#define SELF_TEST_NVLOG_SUMMARY_MS         (600000u)
+
+/* Verdict changes of one periodic test stored per summary interval. Further
+ * changes, of a test that flaps between pass and fail, are only counted in
+ * the summary.
+ */
+#define SELF_TEST_NVLOG_CHANGES_MAX        (2u)
+
+/* Largest number of results printed by self_test_nvlog_print */
+#define SELF_TEST_NVLOG_PRINT_MAX          (16u)
+
+/* Records per page of the store */
+#define SELF_TEST_NVLOG_SLOTS              (ANALOG_BACKEND_NV_PAGE_SIZE / \
+                                            sizeof(self_test_nvlog_record_t))
+
+/* Record capacity of the store */
+#define SELF_TEST_NVLOG_CAPACITY           (ANALOG_BACKEND_NV_PAGES * SELF_TEST_NVLOG_SLOTS)
+
+/* Flag in the test field of results from the periodic scheduler */
+#define SELF_TEST_NVLOG_PERIODIC           (0x80u)
+
+/* Flag in the test field of the summaries of the periodic tests, together
+ * with SELF_TEST_NVLOG_PERIODIC. The value holds the runs of the interval in
+ * bits 31:16 and the failed runs in bits 15:0, each saturated at
+ * SELF_TEST_NVLOG_SUMMARY_MAX; the status is ERROR_STATUS if a run failed.
+ */
+#define SELF_TEST_NVLOG_SUMMARY            (0x20u)
+#define SELF_TEST_NVLOG_SUMMARY_MAX        (0x0000FFFFuL)
+#define SELF_TEST_NVLOG_SUMMARY_VALUE(runs, failures) \
+    ((int32_t)(((((runs) < SELF_TEST_NVLOG_SUMMARY_MAX) ? (uint32_t)(runs) : \
+    SELF_TEST_NVLOG_SUMMARY_MAX) << 16) | \
+    (((failures) < SELF_TEST_NVLOG_SUMMARY_MAX) ? (uint32_t)(failures) : \
+    SELF_TEST_NVLOG_SUMMARY_MAX)))
+
+/* Flag in the test field of deadline overruns reported by self_test_wdt.c.
+ * The value holds the phase in bits 31:24 and the duration in microseconds in
+ * bits 23:0, SELF_TEST_NVLOG_OVERRUN_RESET for a hang that ended in a
+ * watchdog reset.
+ */
+#define SELF_TEST_NVLOG_OVERRUN            (0x40u)
+#define SELF_TEST_NVLOG_OVERRUN_RESET      (0x00FFFFFFuL)
+#define SELF_TEST_NVLOG_OVERRUN_VALUE(phase, us) \
+    ((int32_t)(((uint32_t)(phase) << 24) | \
+    (((us) < SELF_TEST_NVLOG_OVERRUN_RESET) ? (uint32_t)(us) : SELF_TEST_NVLOG_OVERRUN_RESET)))
+
+/* Test field of the record written at every start-up */
+#define SELF_TEST_NVLOG_ID_BOOT            (0x7Fu)
+
+/* Test field of the verdict of the power-on self test. The value holds the
+ * failure mask in bits 31:24 and the time from main to the verdict in
+ * microseconds in bits 23:0, saturated at SELF_TEST_NVLOG_POST_US_MAX.
+ */
+#define SELF_TEST_NVLOG_ID_POST            (0x7Eu)
+#define SELF_TEST_NVLOG_POST_US_MAX        (0x00FFFFFFuL)
+#define SELF_TEST_NVLOG_POST_VALUE(failed, us) \
+    ((int32_t)(((uint32_t)(failed) << 24) | \
+    (((us) < SELF_TEST_NVLOG_POST_US_MAX) ? (uint32_t)(us) : SELF_TEST_NVLOG_POST_US_MAX)))
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* One stored result, 16 bytes */
+typedef struct
+{
+    uint32_t seq;                  /* Number of records written before this one */
+    uint32_t time_ms;              /* Time since start-up in milliseconds */
+    int32_t value;                 /* Measured value of a periodic run, mask of
+                                    * the failed checks of an interactive run */
+    uint8_t id;                    /* self_test_id_t, SELF_TEST_NVLOG_PERIODIC,
+                                    * SELF_TEST_NVLOG_SUMMARY,
+                                    * SELF_TEST_NVLOG_OVERRUN,
+                                    * SELF_TEST_NVLOG_ID_BOOT or
+                                    * SELF_TEST_NVLOG_ID_POST */
+    uint8_t status;                /* OK_STATUS or ERROR_STATUS */
+    uint16_t crc;                  /* CRC-16/CCITT-FALSE of the fields above */
+} self_test_nvlog_record_t;
+
+/* Store statistics */
+typedef struct
+{
+    uint32_t appended;             /* Records appended */
+    uint32_t dropped;              /* Records dropped, queue full */
+    uint32_t committed_seq;        /* Records in non-volatile memory */
+    uint32_t page_writes;          /* Page writes completed */
+    uint32_t periodic_runs;        /* Periodic results passed to the store */
+    uint32_t periodic_stored;      /* Of them, verdict changes appended */
+    uint32_t max_write_us;         /* Longest page write */
+    uint32_t mount_us;             /* Duration of the last self_test_nvlog_init */
+    uint32_t mount_pages;          /* Pages read by it */
+} self_test_nvlog_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void self_test_nvlog_init(void);
+bool self_test_nvlog_append(uint8_t id, uint8_t status, int32_t value);
+void self_test_nvlog_periodic(uint8_t id, uint8_t status, int32_t value);
+void self_test_nvlog_process(void);
+void self_test_nvlog_flush(void);
+uint32_t self_test_nvlog_latest(self_test_nvlog_record_t *records, uint32_t max);
+const self_test_nvlog_stats_t *self_test_nvlog_get_stats(void);
+void self_test_nvlog_print(uint32_t count);
+
+#endif /* SELF_TEST_NVLOG_H_ */
+
+/* [] END OF FILE */
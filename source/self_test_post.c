@@ -0,0 +1,280 @@
+/******************************************************************************
+* File Name:   self_test_post.c
+*
+* Description: This file contains the power-on self test. It checks the first
+*              ADC reference point and, on devices with a comparator, both
+*              comparator routings once at start-up. The start-up is split
+*              into stages that the caller marks as it completes them, which
+*              gives the breakdown of the time from main to the verdict.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "self_test_post.h"
+#include "self_test_log.h"
+#include "self_test_nvlog.h"
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static self_test_post_result_t post_result;
+
+/* Time base of the stages */
+static uint32_t post_start_us;
+static uint32_t post_last_us;
+
+static const char * const post_stage_names[SELF_TEST_POST_STAGE_COUNT] =
+{
+    [SELF_TEST_POST_STAGE_BOARD] = "board",
+    [SELF_TEST_POST_STAGE_ANALOG] = "analog",
+    [SELF_TEST_POST_STAGE_INIT] = "init",
+    [SELF_TEST_POST_STAGE_SETTLE] = "settle",
+    [SELF_TEST_POST_STAGE_ADC] = "adc",
+    [SELF_TEST_POST_STAGE_COMP] = "comp",
+    [SELF_TEST_POST_STAGE_CONSOLE] = "console",
+};
+
+/*******************************************************************************
+* Function Name: self_test_post_start
+********************************************************************************
+* Summary:
+* Starts the time base and the timing of the start-up. Call it first in main;
+* the time from reset to main, spent in the boot code and the start-up code
+* before main, is not measured. The core clock is switched over by the board
+* initialization, so the first stage is only approximate.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_post_start(void)
+{
+    analog_backend_time_init();
+    post_start_us = analog_backend_time_us();
+    post_last_us = post_start_us;
+}
+
+/*******************************************************************************
+* Function Name: self_test_post_mark
+********************************************************************************
+* Summary:
+* Ends a stage of the start-up: the time since the previous mark is added to
+* the stage. A repeated mark that adds no time keeps the end of the stage.
+*
+* Parameters:
+*  stage : Stage that was just completed
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_post_mark(self_test_post_stage_t stage)
+{
+    uint32_t now = analog_backend_time_us();
+
+    if ((now != post_last_us) || (0u == (post_result.stage_mask & (1uL << stage))))
+    {
+        post_result.stage_us[stage] += now - post_last_us;
+        post_result.end_us[stage] = now - post_start_us;
+        post_result.stage_mask |= 1uL << stage;
+    }
+    post_last_us = now;
+}
+
+/*******************************************************************************
+* Function Name: self_test_post_analog_start
+********************************************************************************
+* Summary:
+* Initializes and enables the AREF and the SAR ADC without waiting for the
+* reference to settle. The caller should do init work that does not need the
+* ADC, such as self_test_setup, and mark it as SELF_TEST_POST_STAGE_INIT
+* before it calls self_test_post_check.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  OK_STATUS on success, ERROR_STATUS otherwise
+*
+*******************************************************************************/
+uint8_t self_test_post_analog_start(void)
+{
+    uint8_t status = analog_backend_init();
+
+    self_test_post_mark(SELF_TEST_POST_STAGE_ANALOG);
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: self_test_post_check
+********************************************************************************
+* Summary:
+* Waits for the part of the reference settling time that the init work since
+* self_test_post_analog_start did not cover, then checks the first point of
+* self_test_adc_refs and, on devices with a comparator, runs the two-step
+* comparator test. The result is kept for self_test_post_report; nothing is
+* printed, so it can run before the console is initialized.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  OK_STATUS if every check passed, ERROR_STATUS otherwise
+*
+*******************************************************************************/
+uint8_t self_test_post_check(void)
+{
+    const self_test_ref_point_t *point = &self_test_adc_refs.points[0];
+    uint32_t failed = 0u;
+#if SELF_TEST_HAS_COMPARATOR
+    uint32_t comp_failed;
+#endif
+
+    analog_backend_delay_us(analog_backend_ref_settle_us());
+    self_test_post_mark(SELF_TEST_POST_STAGE_SETTLE);
+
+    if (OK_STATUS != analog_backend_adc_selftest(point->channel, point->expected_mv,
+            point->accuracy_mv, point->vbg_channel))
+    {
+        failed |= SELF_TEST_POST_ADC_BIT;
+    }
+    self_test_post_mark(SELF_TEST_POST_STAGE_ADC);
+
+#if SELF_TEST_HAS_COMPARATOR
+    comp_failed = comparator_run();
+    if (0u != (comp_failed & COMP_LOW_BIT))
+    {
+        failed |= SELF_TEST_POST_COMP_LOW_BIT;
+    }
+    if (0u != (comp_failed & COMP_HIGH_BIT))
+    {
+        failed |= SELF_TEST_POST_COMP_HIGH_BIT;
+    }
+    self_test_post_mark(SELF_TEST_POST_STAGE_COMP);
+#endif
+
+    post_result.verdict_us = post_last_us - post_start_us;
+    post_result.failed = failed;
+    post_result.status = (uint8_t)((0u == failed) ? OK_STATUS : ERROR_STATUS);
+
+    return post_result.status;
+}
+
+/*******************************************************************************
+* Function Name: self_test_post_report
+********************************************************************************
+* Summary:
+* Logs the verdict and the duration and end time of every stage that ran, in
+* the order the stages ended, and appends the verdict to the result store. Call
+* it once the console is up and the result store is mounted.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_post_report(void)
+{
+    uint32_t stage;
+    uint32_t next;
+    uint32_t reported = 0u;
+
+    self_test_log(SELF_TEST_LOG_POST, post_result.status, 0u,
+            (int32_t)post_result.failed, (int32_t)post_result.verdict_us);
+
+    /* The start-up order decides when each stage runs, so pick the stage that
+     * ended first among the ones not reported yet, and of two stages that
+     * ended together, the one that started first */
+    while (reported != post_result.stage_mask)
+    {
+        next = (uint32_t)SELF_TEST_POST_STAGE_COUNT;
+        for (stage = 0u; stage < (uint32_t)SELF_TEST_POST_STAGE_COUNT; stage++)
+        {
+            if ((0u != (post_result.stage_mask & (1uL << stage))) &&
+                (0u == (reported & (1uL << stage))) &&
+                (((uint32_t)SELF_TEST_POST_STAGE_COUNT == next) ||
+                 (post_result.end_us[stage] < post_result.end_us[next]) ||
+                 ((post_result.end_us[stage] == post_result.end_us[next]) &&
+                  (post_result.stage_us[stage] > post_result.stage_us[next]))))
+            {
+                next = stage;
+            }
+        }
+        self_test_log(SELF_TEST_LOG_POST_STAGE, SELF_TEST_LOG_INFO, (uint8_t)next,
+                (int32_t)post_result.stage_us[next], (int32_t)post_result.end_us[next]);
+        reported |= 1uL << next;
+    }
+
+    (void)self_test_nvlog_append(SELF_TEST_NVLOG_ID_POST, post_result.status,
+            SELF_TEST_NVLOG_POST_VALUE(post_result.failed, post_result.verdict_us));
+}
+
+/*******************************************************************************
+* Function Name: self_test_post_get_result
+********************************************************************************
+* Summary:
+* Returns the verdict and the timing of the power-on self test.
+*
+*******************************************************************************/
+const self_test_post_result_t *self_test_post_get_result(void)
+{
+    return &post_result;
+}
+
+/*******************************************************************************
+* Function Name: self_test_post_stage_name
+********************************************************************************
+* Summary:
+* Returns the name of a stage for the console output.
+*
+* Parameters:
+*  stage : Stage
+*
+* Return :
+*  Name of the stage
+*
+*******************************************************************************/
+const char *self_test_post_stage_name(self_test_post_stage_t stage)
+{
+    return post_stage_names[stage];
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,110 @@
+/******************************************************************************
+* File Name:   self_test_post.h
+*
+* Description: This file is the public interface of self_test_post.c, the
+*              power-on self test that checks the ADC and the comparator
+*              before the console comes up and measures the time from main to
+*              its verdict.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_POST_H_
+#define SELF_TEST_POST_H_
+
+#include "self_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Set to 1 to run the power-on self test right after the board initialization,
+ * before the console comes up, with the reference settling overlapped with
+ * the other init work
+ */
+#ifndef SELF_TEST_FAST_POST
+    #define SELF_TEST_FAST_POST            (0)
+#endif
+
+/* Bits of the checks of the power-on self test in its failure mask */
+#define SELF_TEST_POST_ADC_BIT             (1u << 0)
+#define SELF_TEST_POST_COMP_LOW_BIT        (1u << 1)
+#define SELF_TEST_POST_COMP_HIGH_BIT       (1u << 2)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Stages of the start-up timed by the power-on self test */
+typedef enum
+{
+    SELF_TEST_POST_STAGE_BOARD = 0u, /* Device and board initialization */
+    SELF_TEST_POST_STAGE_ANALOG,   /* AREF and SAR initialization and enable */
+    SELF_TEST_POST_STAGE_INIT,     /* Init work that does not need the ADC */
+    SELF_TEST_POST_STAGE_SETTLE,   /* Rest of the reference settling time */
+    SELF_TEST_POST_STAGE_ADC,      /* ADC check */
+    SELF_TEST_POST_STAGE_COMP,     /* Comparator check */
+    SELF_TEST_POST_STAGE_CONSOLE,  /* Debug UART initialization and banner */
+    SELF_TEST_POST_STAGE_COUNT
+} self_test_post_stage_t;
+
+/* Verdict and timing of the power-on self test */
+typedef struct
+{
+    uint32_t stage_us[SELF_TEST_POST_STAGE_COUNT]; /* Duration of each stage */
+    uint32_t end_us[SELF_TEST_POST_STAGE_COUNT];   /* End of each stage, from
+                                                    * self_test_post_start */
+    uint32_t stage_mask;           /* Stages that ran, bit n for stage n */
+    uint32_t verdict_us;           /* Time from self_test_post_start to the
+                                    * verdict */
+    uint32_t failed;               /* Mask of SELF_TEST_POST_*_BIT */
+    uint8_t status;                /* OK_STATUS if every check passed */
+} self_test_post_result_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void self_test_post_start(void);
+void self_test_post_mark(self_test_post_stage_t stage);
+uint8_t self_test_post_analog_start(void);
+uint8_t self_test_post_check(void);
+void self_test_post_report(void);
+const self_test_post_result_t *self_test_post_get_result(void);
+const char *self_test_post_stage_name(self_test_post_stage_t stage);
+
+#endif /* SELF_TEST_POST_H_ */
+
+/* [] END OF FILE */
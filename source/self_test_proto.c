@@ -0,0 +1,618 @@
+/******************************************************************************
+* File Name:   self_test_proto.c
+*
+* Description: This file implements the binary command protocol. A client
+*              sends framed requests with a CRC; a run request queues a batch
+*              of tests with repeat counts and parameters. The batch is run
+*              one test per call of self_test_proto_process, so the main loop
+*              stays responsive, and every run streams back a compact result
+*              frame. Frames start with a byte that is not a console command,
+*              so the interactive menu keeps working next to the protocol.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stddef.h>
+#include "self_test_proto.h"
+#include "self_test_adc_async.h"
+#include "self_test_wdt.h"
+
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Receiver state */
+typedef enum
+{
+    PROTO_RX_SOF = 0u,             /* Waiting for SELF_TEST_PROTO_SOF */
+    PROTO_RX_LENGTH,               /* Waiting for the payload length */
+    PROTO_RX_PAYLOAD,              /* Receiving the payload */
+    PROTO_RX_CRC_LO,               /* Waiting for the CRC low byte */
+    PROTO_RX_CRC_HI                /* Waiting for the CRC high byte */
+} proto_rx_state_t;
+
+/* One entry of a run request */
+typedef struct
+{
+    uint8_t test;                  /* SELF_TEST_PROTO_TEST_* */
+    uint8_t repeat;                /* Number of runs */
+    uint16_t param;                /* Test parameter */
+} proto_entry_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static self_test_proto_tx_t proto_tx;
+
+/* Frame being received */
+static proto_rx_state_t proto_rx_state;
+static uint8_t proto_rx_payload[SELF_TEST_PROTO_MAX_PAYLOAD];
+static uint32_t proto_rx_length;
+static uint32_t proto_rx_pos;
+static uint16_t proto_rx_crc;
+static uint32_t proto_rx_last_us;
+
+/* Batch in progress */
+static proto_entry_t proto_entries[SELF_TEST_PROTO_MAX_ENTRIES];
+static uint32_t proto_entry_count;
+static uint32_t proto_entry;
+static uint32_t proto_repeat;
+static uint8_t proto_seq;
+static uint16_t proto_runs;
+static uint16_t proto_failures;
+static bool proto_busy;
+
+/* CRC-16/CCITT-FALSE, one nibble at a time */
+static const uint16_t proto_crc_nibble[16] =
+{
+    0x0000u, 0x1021u, 0x2042u, 0x3063u, 0x4084u, 0x50A5u, 0x60C6u, 0x70E7u,
+    0x8108u, 0x9129u, 0xA14Au, 0xB16Bu, 0xC18Cu, 0xD1ADu, 0xE1CEu, 0xF1EFu,
+};
+
+/*******************************************************************************
+* Function Name: proto_put32
+********************************************************************************
+* Summary:
+* Stores a 32-bit value little endian.
+*
+*******************************************************************************/
+static void proto_put32(uint8_t *dst, uint32_t value)
+{
+    dst[0] = (uint8_t)value;
+    dst[1] = (uint8_t)(value >> 8);
+    dst[2] = (uint8_t)(value >> 16);
+    dst[3] = (uint8_t)(value >> 24);
+}
+
+/*******************************************************************************
+* Function Name: proto_send
+********************************************************************************
+* Summary:
+* Frames a payload and writes it to the link.
+*
+*******************************************************************************/
+static void proto_send(const uint8_t *payload, uint32_t length)
+{
+    uint8_t frame[SELF_TEST_PROTO_MAX_PAYLOAD + SELF_TEST_PROTO_OVERHEAD];
+
+    proto_tx(frame, self_test_proto_frame(frame, payload, length));
+}
+
+/*******************************************************************************
+* Function Name: proto_send_nak
+********************************************************************************
+* Summary:
+* Rejects a request.
+*
+*******************************************************************************/
+static void proto_send_nak(uint8_t seq, uint8_t error)
+{
+    const uint8_t payload[] = { SELF_TEST_PROTO_RSP_NAK, seq, error };
+
+    proto_send(payload, sizeof(payload));
+}
+
+/*******************************************************************************
+* Function Name: proto_send_done
+********************************************************************************
+* Summary:
+* Reports the end of a batch and returns to idle.
+*
+*******************************************************************************/
+static void proto_send_done(uint8_t seq)
+{
+    const uint8_t payload[] =
+    {
+        SELF_TEST_PROTO_RSP_DONE, seq,
+        (uint8_t)proto_runs, (uint8_t)(proto_runs >> 8),
+        (uint8_t)proto_failures, (uint8_t)(proto_failures >> 8),
+    };
+
+    proto_send(payload, sizeof(payload));
+    proto_busy = false;
+}
+
+/*******************************************************************************
+* Function Name: proto_test_valid
+********************************************************************************
+* Summary:
+* Checks that a test exists on this device and that its parameter is in range.
+*
+*******************************************************************************/
+static bool proto_test_valid(uint8_t test, uint16_t param)
+{
+    switch (test)
+    {
+        case SELF_TEST_PROTO_TEST_ADC:
+            return (param < self_test_adc_refs.count);
+#if SELF_TEST_HAS_COMPARATOR
+        case SELF_TEST_PROTO_TEST_COMPARATOR:
+            return true;
+#endif
+#if SELF_TEST_HAS_OPAMP
+        case SELF_TEST_PROTO_TEST_OPAMP:
+            return (param < self_test_opamp_refs.count);
+#endif
+        case SELF_TEST_PROTO_TEST_ADC_BATCH:
+            return (param <= SELF_TEST_STATS_MAX_SAMPLES);
+        default:
+            return false;
+    }
+}
+
+/*******************************************************************************
+* Function Name: proto_run_test
+********************************************************************************
+* Summary:
+* Runs one test without console output and returns its status and measured
+* value: the reading in millivolts for the ADC and opamp, the failed halves
+* (bit 0 low, bit 1 high) for the comparator, and the mean reading for the
+* oversampled ADC test. Each run is supervised by the watchdog supervisor as a
+* blocking run, and a conversion that times out fails it.
+*
+*******************************************************************************/
+static uint8_t proto_run_test(uint8_t test, uint16_t param, int32_t *value)
+{
+    const self_test_ref_point_t *point;
+    uint8_t status = ERROR_STATUS;
+
+    switch (test)
+    {
+        case SELF_TEST_PROTO_TEST_ADC:
+            point = &self_test_adc_refs.points[param];
+            self_test_wdt_begin(SELF_TEST_ID_ADC, false);
+            status = analog_backend_adc_selftest(point->channel, point->expected_mv,
+                    point->accuracy_mv, point->vbg_channel);
+            if (OK_STATUS != self_test_wdt_adc_convert(SELF_TEST_ID_ADC, point->channel, value))
+            {
+                status = ERROR_STATUS;
+            }
+            self_test_wdt_end(SELF_TEST_ID_ADC, true);
+            break;
+
+#if SELF_TEST_HAS_COMPARATOR
+        case SELF_TEST_PROTO_TEST_COMPARATOR:
+            *value = 0;
+            self_test_wdt_begin(SELF_TEST_ID_COMPARATOR, false);
+            analog_backend_comp_route(ANALOG_COMP_ROUTE_VPLUS_AMUXB);
+            if (OK_STATUS != analog_backend_comp_selftest(ANALOG_COMP_RESULT2))
+            {
+                *value |= 1;
+            }
+            analog_backend_comp_route(ANALOG_COMP_ROUTE_VPLUS_AMUXA);
+            if (OK_STATUS != analog_backend_comp_selftest(ANALOG_COMP_RESULT1))
+            {
+                *value |= 2;
+            }
+            self_test_wdt_end(SELF_TEST_ID_COMPARATOR, true);
+            status = (uint8_t)((0 == *value) ? OK_STATUS : ERROR_STATUS);
+            break;
+#endif
+
+#if SELF_TEST_HAS_OPAMP
+        case SELF_TEST_PROTO_TEST_OPAMP:
+            point = &self_test_opamp_refs.points[param];
+            self_test_wdt_begin(SELF_TEST_ID_OPAMP, false);
+            status = analog_backend_opamp_selftest(point->expected_mv, point->accuracy_mv,
+                    point->channel);
+            if (OK_STATUS != self_test_wdt_adc_convert(SELF_TEST_ID_OPAMP, point->channel,
+                    value))
+            {
+                status = ERROR_STATUS;
+            }
+            self_test_wdt_end(SELF_TEST_ID_OPAMP, true);
+            break;
+#endif
+
+        case SELF_TEST_PROTO_TEST_ADC_BATCH:
+        {
+            adc_batch_result_t result;
+
+            status = adc_batch_run((0u != param) ? param : ADC_BATCH_SAMPLES, &result);
+            *value = self_test_stats_mean_q(&result.ref) / (1 << SELF_TEST_STATS_Q);
+            break;
+        }
+
+        default:
+            *value = 0;
+            break;
+    }
+
+    return status;
+}
+
+/*******************************************************************************
+* Function Name: proto_handle
+********************************************************************************
+* Summary:
+* Handles a received request with a valid CRC.
+*
+*******************************************************************************/
+static void proto_handle(const uint8_t *payload, uint32_t length)
+{
+    uint8_t seq = (length > 1u) ? payload[1] : 0u;
+    uint32_t count;
+    uint32_t i;
+
+    if (length < 2u)
+    {
+        proto_send_nak(seq, SELF_TEST_PROTO_ERR_LENGTH);
+        return;
+    }
+
+    switch (payload[0])
+    {
+        case SELF_TEST_PROTO_REQ_PING:
+        {
+            const uint8_t pong[] =
+            {
+                SELF_TEST_PROTO_RSP_PONG, seq, SELF_TEST_PROTO_VERSION,
+                SELF_TEST_PROTO_MAX_ENTRIES,
+            };
+
+            proto_send(pong, sizeof(pong));
+            break;
+        }
+
+        case SELF_TEST_PROTO_REQ_RUN:
+            count = (length > 2u) ? payload[2] : 0u;
+            if ((0u == count) || (count > SELF_TEST_PROTO_MAX_ENTRIES) ||
+                (length != (3u + (count * SELF_TEST_PROTO_ENTRY_SIZE))))
+            {
+                proto_send_nak(seq, SELF_TEST_PROTO_ERR_LENGTH);
+                break;
+            }
+            if (proto_busy)
+            {
+                proto_send_nak(seq, SELF_TEST_PROTO_ERR_BUSY);
+                break;
+            }
+            for (i = 0u; i < count; i++)
+            {
+                const uint8_t *src = &payload[3u + (i * SELF_TEST_PROTO_ENTRY_SIZE)];
+
+                proto_entries[i].test = src[0];
+                proto_entries[i].repeat = (0u != src[1]) ? src[1] : 1u;
+                proto_entries[i].param = (uint16_t)(src[2] | ((uint16_t)src[3] << 8));
+                if (!proto_test_valid(proto_entries[i].test, proto_entries[i].param))
+                {
+                    proto_send_nak(seq, SELF_TEST_PROTO_ERR_TEST);
+                    return;
+                }
+            }
+
+            proto_entry_count = count;
+            proto_entry = 0u;
+            proto_repeat = 0u;
+            proto_seq = seq;
+            proto_runs = 0u;
+            proto_failures = 0u;
+            proto_busy = true;
+            {
+                const uint8_t ack[] = { SELF_TEST_PROTO_RSP_ACK, seq, (uint8_t)count };
+
+                proto_send(ack, sizeof(ack));
+            }
+            break;
+
+        case SELF_TEST_PROTO_REQ_ABORT:
+            if (proto_busy)
+            {
+                proto_send_done(proto_seq);
+            }
+            else
+            {
+                proto_runs = 0u;
+                proto_failures = 0u;
+                proto_send_done(seq);
+            }
+            break;
+
+        default:
+            proto_send_nak(seq, SELF_TEST_PROTO_ERR_TYPE);
+            break;
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_proto_crc
+********************************************************************************
+* Summary:
+* Updates a CRC-16/CCITT-FALSE (polynomial 0x1021, initial value 0xFFFF).
+*
+* Parameters:
+*  crc    : CRC so far, 0xFFFF for the first block
+*  data   : Bytes to add
+*  length : Number of bytes
+*
+* Return :
+*  Updated CRC
+*
+*******************************************************************************/
+uint16_t self_test_proto_crc(uint16_t crc, const uint8_t *data, uint32_t length)
+{
+    uint32_t i;
+
+    for (i = 0u; i < length; i++)
+    {
+        crc = (uint16_t)((crc << 4) ^ proto_crc_nibble[(crc >> 12) ^ (data[i] >> 4)]);
+        crc = (uint16_t)((crc << 4) ^ proto_crc_nibble[(crc >> 12) ^ (data[i] & 0x0Fu)]);
+    }
+
+    return crc;
+}
+
+/*******************************************************************************
+* Function Name: self_test_proto_frame
+********************************************************************************
+* Summary:
+* Builds a frame around a payload.
+*
+* Parameters:
+*  frame   : Buffer of length + SELF_TEST_PROTO_OVERHEAD bytes
+*  payload : Payload, 1 to SELF_TEST_PROTO_MAX_PAYLOAD bytes
+*  length  : Payload length
+*
+* Return :
+*  Frame length
+*
+*******************************************************************************/
+uint32_t self_test_proto_frame(uint8_t *frame, const uint8_t *payload, uint32_t length)
+{
+    uint32_t i;
+    uint16_t crc;
+
+    frame[0] = SELF_TEST_PROTO_SOF;
+    frame[1] = (uint8_t)length;
+    for (i = 0u; i < length; i++)
+    {
+        frame[2u + i] = payload[i];
+    }
+    crc = self_test_proto_crc(0xFFFFu, &frame[1], length + 1u);
+    frame[2u + length] = (uint8_t)crc;
+    frame[3u + length] = (uint8_t)(crc >> 8);
+
+    return length + SELF_TEST_PROTO_OVERHEAD;
+}
+
+/*******************************************************************************
+* Function Name: self_test_proto_init
+********************************************************************************
+* Summary:
+* Resets the receiver and drops any batch in progress.
+*
+* Parameters:
+*  tx : Writes response bytes to the link
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_proto_init(self_test_proto_tx_t tx)
+{
+    proto_tx = tx;
+    proto_rx_state = PROTO_RX_SOF;
+    proto_busy = false;
+}
+
+/*******************************************************************************
+* Function Name: self_test_proto_rx_byte
+********************************************************************************
+* Summary:
+* Feeds one received byte to the frame receiver. Outside a frame, only
+* SELF_TEST_PROTO_SOF is taken; any other byte is left to the console menu.
+* A frame whose next byte comes more than SELF_TEST_PROTO_RX_TIMEOUT_US after
+* the previous one is dropped. Complete requests are handled at once; a run
+* request only queues its batch.
+*
+* Parameters:
+*  byte : Received byte
+*
+* Return :
+*  true if the byte belongs to the protocol, false if it is a console command
+*
+*******************************************************************************/
+bool self_test_proto_rx_byte(uint8_t byte)
+{
+    uint32_t now = analog_backend_time_us();
+
+    if ((PROTO_RX_SOF != proto_rx_state) &&
+        ((now - proto_rx_last_us) > SELF_TEST_PROTO_RX_TIMEOUT_US))
+    {
+        /* The rest of the frame never came */
+        proto_rx_state = PROTO_RX_SOF;
+    }
+    proto_rx_last_us = now;
+
+    switch (proto_rx_state)
+    {
+        case PROTO_RX_SOF:
+            if (SELF_TEST_PROTO_SOF != byte)
+            {
+                return false;
+            }
+            proto_rx_state = PROTO_RX_LENGTH;
+            break;
+
+        case PROTO_RX_LENGTH:
+            if ((0u == byte) || (byte > SELF_TEST_PROTO_MAX_PAYLOAD))
+            {
+                proto_send_nak(0u, SELF_TEST_PROTO_ERR_LENGTH);
+                proto_rx_state = PROTO_RX_SOF;
+                break;
+            }
+            proto_rx_length = byte;
+            proto_rx_pos = 0u;
+            proto_rx_crc = self_test_proto_crc(0xFFFFu, &byte, 1u);
+            proto_rx_state = PROTO_RX_PAYLOAD;
+            break;
+
+        case PROTO_RX_PAYLOAD:
+            proto_rx_payload[proto_rx_pos] = byte;
+            proto_rx_pos++;
+            if (proto_rx_pos == proto_rx_length)
+            {
+                proto_rx_crc = self_test_proto_crc(proto_rx_crc, proto_rx_payload,
+                        proto_rx_length);
+                proto_rx_state = PROTO_RX_CRC_LO;
+            }
+            break;
+
+        case PROTO_RX_CRC_LO:
+            proto_rx_crc ^= byte;
+            proto_rx_state = PROTO_RX_CRC_HI;
+            break;
+
+        default:
+            proto_rx_crc ^= (uint16_t)((uint16_t)byte << 8);
+            proto_rx_state = PROTO_RX_SOF;
+            if (0u != proto_rx_crc)
+            {
+                proto_send_nak((proto_rx_length > 1u) ? proto_rx_payload[1] : 0u,
+                        SELF_TEST_PROTO_ERR_CRC);
+                break;
+            }
+            proto_handle(proto_rx_payload, proto_rx_length);
+            break;
+    }
+
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: self_test_proto_busy
+********************************************************************************
+* Summary:
+* Returns whether a batch is in progress. The batch needs the analog blocks,
+* so the periodic tests must not run meanwhile.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  true while a batch is in progress
+*
+*******************************************************************************/
+bool self_test_proto_busy(void)
+{
+    return proto_busy;
+}
+
+/*******************************************************************************
+* Function Name: self_test_proto_process
+********************************************************************************
+* Summary:
+* Runs the next test of the batch in progress and sends its result, and the
+* end of batch after the last one. Call it from the main loop. No test is run
+* while the interrupt driven ADC test is converting.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_proto_process(void)
+{
+    const proto_entry_t *entry;
+    uint8_t payload[SELF_TEST_PROTO_RESULT_SIZE];
+    uint32_t start;
+    uint32_t elapsed;
+    int32_t value;
+    uint8_t status;
+
+    if (!proto_busy || self_test_adc_async_busy())
+    {
+        /* Nothing queued, or the SAR is busy with the interrupt driven ADC
+         * test; the run starts on a later call.
+         */
+        return;
+    }
+
+    entry = &proto_entries[proto_entry];
+    start = analog_backend_cpu_ticks();
+    status = proto_run_test(entry->test, entry->param, &value);
+    elapsed = (analog_backend_cpu_ticks() - start) / analog_backend_cpu_ticks_per_us();
+
+    proto_runs++;
+    if (OK_STATUS != status)
+    {
+        proto_failures++;
+    }
+
+    payload[0] = SELF_TEST_PROTO_RSP_RESULT;
+    payload[1] = proto_seq;
+    payload[2] = (uint8_t)proto_entry;
+    payload[3] = (uint8_t)proto_repeat;
+    payload[4] = entry->test;
+    payload[5] = status;
+    proto_put32(&payload[6], (uint32_t)value);
+    proto_put32(&payload[10], elapsed);
+    proto_send(payload, sizeof(payload));
+
+    proto_repeat++;
+    if (proto_repeat >= entry->repeat)
+    {
+        proto_repeat = 0u;
+        proto_entry++;
+        if (proto_entry >= proto_entry_count)
+        {
+            proto_send_done(proto_seq);
+        }
+    }
+}
+
+/* [] END OF FILE */
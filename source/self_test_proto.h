@@ -0,0 +1,126 @@
+/******************************************************************************
+* File Name:   self_test_proto.h
+*
+* Description: This file is the public interface of self_test_proto.c, the
+*              framed binary command protocol that runs batches of self tests
+*              for automated testers. It also defines the frame format shared
+*              with the host reference client.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_PROTO_H_
+#define SELF_TEST_PROTO_H_
+
+#include "self_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Frame: SOF, payload length, payload, CRC-16/CCITT-FALSE of the length and
+ * payload bytes (little endian). The first payload byte is the message type,
+ * the second the sequence number chosen by the client.
+ */
+#define SELF_TEST_PROTO_SOF                (0xA5u)
+#define SELF_TEST_PROTO_MAX_PAYLOAD        (64u)
+#define SELF_TEST_PROTO_OVERHEAD           (4u)
+#define SELF_TEST_PROTO_VERSION            (1u)
+
+/* Longest gap between two bytes of a frame. A frame that stalls for longer,
+ * for example because the client was restarted mid-frame, is dropped, and the
+ * next byte is taken as the start of a new frame or as a console command.
+ */
+#define SELF_TEST_PROTO_RX_TIMEOUT_US      (20000u)
+
+/* Largest number of entries in one run request */
+#define SELF_TEST_PROTO_MAX_ENTRIES        (8u)
+
+/* Requests */
+#define SELF_TEST_PROTO_REQ_PING           (0x01u)    /* seq */
+#define SELF_TEST_PROTO_REQ_RUN            (0x02u)    /* seq, n, n * entry */
+#define SELF_TEST_PROTO_REQ_ABORT          (0x03u)    /* seq */
+
+/* Responses */
+#define SELF_TEST_PROTO_RSP_PONG           (0x81u)    /* seq, version, max entries */
+#define SELF_TEST_PROTO_RSP_ACK            (0x82u)    /* seq, n */
+#define SELF_TEST_PROTO_RSP_RESULT         (0x83u)    /* seq, entry, repeat, test,
+                                                       * status, value (4),
+                                                       * time us (4) */
+#define SELF_TEST_PROTO_RSP_DONE           (0x84u)    /* seq, runs (2), failures (2) */
+#define SELF_TEST_PROTO_RSP_NAK            (0xFFu)    /* seq, error */
+
+/* Size of one run request entry: test, repeat, param (2) */
+#define SELF_TEST_PROTO_ENTRY_SIZE         (4u)
+
+/* Payload size of a result */
+#define SELF_TEST_PROTO_RESULT_SIZE        (14u)
+
+/* Tests, numbered as the console commands */
+#define SELF_TEST_PROTO_TEST_ADC           (1u)       /* param: reference point */
+#define SELF_TEST_PROTO_TEST_COMPARATOR    (2u)       /* param: unused */
+#define SELF_TEST_PROTO_TEST_OPAMP         (3u)       /* param: reference point */
+#define SELF_TEST_PROTO_TEST_ADC_BATCH     (6u)       /* param: samples, 0 for
+                                                       * ADC_BATCH_SAMPLES */
+
+/* NAK error codes */
+#define SELF_TEST_PROTO_ERR_CRC            (1u)
+#define SELF_TEST_PROTO_ERR_LENGTH         (2u)
+#define SELF_TEST_PROTO_ERR_TYPE           (3u)
+#define SELF_TEST_PROTO_ERR_BUSY           (4u)
+#define SELF_TEST_PROTO_ERR_TEST           (5u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Writes bytes to the link */
+typedef void (*self_test_proto_tx_t)(const uint8_t *data, uint32_t length);
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void self_test_proto_init(self_test_proto_tx_t tx);
+bool self_test_proto_rx_byte(uint8_t byte);
+bool self_test_proto_busy(void);
+void self_test_proto_process(void);
+
+uint16_t self_test_proto_crc(uint16_t crc, const uint8_t *data, uint32_t length);
+uint32_t self_test_proto_frame(uint8_t *frame, const uint8_t *payload, uint32_t length);
+
+#endif /* SELF_TEST_PROTO_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,113 @@
+/******************************************************************************
+* File Name:   self_test_refs.c
+*
+* Description: This file holds the reference points checked by the ADC and
+*              opamp self tests, as constant tables per device family.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include "self_test.h"
+
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* ADC reference points: (VDDA / 3) on ADC_REF_CHANNEL, and with
+ * ADC_REF_VOLTAGE2 also (2VDDA / 3) on ADC_REF2_CHANNEL, which the SAR
+ * configuration of the design must then scan.
+ */
+static const self_test_ref_point_t adc_ref_points[] =
+{
+    { ADC_REF_EXPECTED,       ANALOG_ADC_ACURACCY, ADC_REF_CHANNEL,  VBG_CHANNEL },
+#if ADC_REF_VOLTAGE2
+    { ANALOG_ADC_SAR_RESULT2, ANALOG_ADC_ACURACCY, ADC_REF2_CHANNEL, VBG_CHANNEL },
+#endif
+};
+
+const self_test_ref_set_t self_test_adc_refs =
+{
+    .points = adc_ref_points,
+    .count = (uint8_t)(sizeof(adc_ref_points) / sizeof(adc_ref_points[0])),
+};
+
+#if SELF_TEST_HAS_OPAMP
+/* Opamp reference points: the opamp has a single Vplus input, so one point is
+ * checked per pass. Replace OPAMP_REF_EXPECTED with ANALOG_OPAMP_SAR_RESULT2
+ * when (2VDDA / 3) is connected to the Vplus input.
+ */
+static const self_test_ref_point_t opamp_ref_points[] =
+{
+    { OPAMP_REF_EXPECTED, ANALOG_OPAMP_ACURACCY, OPAMP_SAR_CHANNEL, VBG_CHANNEL },
+};
+
+const self_test_ref_set_t self_test_opamp_refs =
+{
+    .points = opamp_ref_points,
+    .count = (uint8_t)(sizeof(opamp_ref_points) / sizeof(opamp_ref_points[0])),
+};
+#endif
+
+#if SELF_TEST_HAS_COMPARATOR
+/* Comparator sweep, ordered so that the input pins are swapped only twice.
+ * The first two groups are the checks of the two-step comparator test; the
+ * others switch the inputs of both channels to the buses directly, then
+ * compare each bus with the local reference, which is below (VDDA / 3).
+ */
+static const self_test_comp_group_t comp_sweep_groups[] =
+{
+    { ANALOG_COMP_ROUTE_VPLUS_AMUXA, ANALOG_COMP_INPUT_PIN,   ANALOG_COMP_INPUT_PIN,
+      0x1u, ANALOG_COMP_RESULT1 },
+    { ANALOG_COMP_ROUTE_VPLUS_AMUXB, ANALOG_COMP_INPUT_PIN,   ANALOG_COMP_INPUT_PIN,
+      0x1u, ANALOG_COMP_RESULT2 },
+    { ANALOG_COMP_ROUTE_VPLUS_AMUXB, ANALOG_COMP_INPUT_AMUXA, ANALOG_COMP_INPUT_AMUXB,
+      0x3u, ANALOG_COMP_RESULT1 },
+    { ANALOG_COMP_ROUTE_VPLUS_AMUXB, ANALOG_COMP_INPUT_AMUXB, ANALOG_COMP_INPUT_AMUXA,
+      0x3u, ANALOG_COMP_RESULT2 },
+    { ANALOG_COMP_ROUTE_VPLUS_AMUXB, ANALOG_COMP_INPUT_AMUXA, ANALOG_COMP_INPUT_VREF,
+      0x3u, ANALOG_COMP_RESULT1 },
+    { ANALOG_COMP_ROUTE_VPLUS_AMUXB, ANALOG_COMP_INPUT_AMUXB, ANALOG_COMP_INPUT_VREF,
+      0x3u, ANALOG_COMP_RESULT1 },
+};
+
+const self_test_comp_sweep_t self_test_comp_sweep =
+{
+    .groups = comp_sweep_groups,
+    .count = (uint8_t)(sizeof(comp_sweep_groups) / sizeof(comp_sweep_groups[0])),
+};
+#endif
+
+/* [] END OF FILE */
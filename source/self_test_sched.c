@@ -0,0 +1,838 @@
+/******************************************************************************
+* File Name:   self_test_sched.c
+*
+* Description: This file implements a cooperative, time-sliced scheduler for
+*              the analog self tests. Each test is split into short steps
+*              (configure, start conversion, wait, evaluate) that never block,
+*              so the tests can run periodically next to the application.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "self_test_sched.h"
+#include "self_test_adc_async.h"
+#include "self_test_trace.h"
+#include "self_test_wdt.h"
+
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* No test in progress */
+#define SCHED_NONE                         (SELF_TEST_ID_COUNT)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Progress of the test in execution */
+typedef struct
+{
+    uint8_t step;                  /* Next step to execute */
+    uint8_t status;                /* OK_STATUS until a check fails */
+    uint32_t wait_start_us;        /* Start of the current settling wait */
+    uint32_t wait_start_ticks;     /* Start of the settling or conversion wait, in
+                                    * CPU ticks for the phase trace */
+    int32_t value;                 /* Measured value reported on completion */
+} sched_ctx_t;
+
+typedef self_test_step_result_t (*sched_step_fn_t)(sched_ctx_t *ctx);
+
+/* Margin history and adapted period of a test */
+typedef struct
+{
+    int8_t margin[SELF_TEST_SCHED_HISTORY]; /* Ring of the latest margins */
+    uint8_t count;                 /* Valid entries in margin */
+    uint8_t pos;                   /* Next entry to write */
+    uint8_t burst;                 /* Back-to-back runs still to do */
+    uint32_t period_us;            /* Current period */
+} sched_adapt_t;
+
+/* Steps of the conversion based tests */
+enum
+{
+    SCHED_CONV_CONFIGURE = 0u,
+    SCHED_CONV_START,
+    SCHED_CONV_WAIT,
+    SCHED_CONV_EVALUATE
+};
+
+/* Steps of the comparator test */
+enum
+{
+    SCHED_COMP_ROUTE_LOW = 0u,
+    SCHED_COMP_SETTLE_LOW,
+    SCHED_COMP_EVALUATE_LOW,
+    SCHED_COMP_ROUTE_HIGH,
+    SCHED_COMP_SETTLE_HIGH,
+    SCHED_COMP_EVALUATE_HIGH
+};
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+static self_test_step_result_t sched_adc_step(sched_ctx_t *ctx);
+#if SELF_TEST_HAS_COMPARATOR
+static self_test_step_result_t sched_comp_step(sched_ctx_t *ctx);
+#endif
+#if SELF_TEST_HAS_OPAMP
+static self_test_step_result_t sched_opamp_step(sched_ctx_t *ctx);
+#endif
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+/* Step function of each test, NULL if the device does not have the block */
+static const sched_step_fn_t sched_tests[SELF_TEST_ID_COUNT] =
+{
+    [SELF_TEST_ID_ADC] = sched_adc_step,
+#if SELF_TEST_HAS_COMPARATOR
+    [SELF_TEST_ID_COMPARATOR] = sched_comp_step,
+#endif
+#if SELF_TEST_HAS_OPAMP
+    [SELF_TEST_ID_OPAMP] = sched_opamp_step,
+#endif
+};
+
+static const char * const sched_test_names[SELF_TEST_ID_COUNT] =
+{
+    [SELF_TEST_ID_ADC] = "ADC",
+    [SELF_TEST_ID_COMPARATOR] = "Comparator",
+    [SELF_TEST_ID_OPAMP] = "OP-AMP",
+};
+
+static self_test_sched_config_t sched_config;
+static self_test_sched_stats_t sched_stats;
+static sched_ctx_t sched_ctx;
+static uint32_t sched_active = SCHED_NONE;
+static uint32_t sched_next;
+static uint32_t sched_last_done_us[SELF_TEST_ID_COUNT];
+static uint32_t sched_triggered;
+static sched_adapt_t sched_adapt[SELF_TEST_ID_COUNT];
+static uint32_t sched_max_period_us;
+static uint32_t sched_start_us;
+static uint32_t sched_last_tick_us;
+
+/*******************************************************************************
+* Function Name: sched_adc_step
+********************************************************************************
+* Summary:
+* Executes the next step of the ADC test. The conversion of the reference
+* channel runs interrupt driven (see self_test_adc_async.c); the result is
+* checked against the expected result within ANALOG_ADC_ACURACCY. The start,
+* the conversion and the evaluation are traced as the route, convert and
+* evaluate phases; the conversion phase includes the time between the ticks.
+*
+*******************************************************************************/
+static self_test_step_result_t sched_adc_step(sched_ctx_t *ctx)
+{
+    uint32_t start = analog_backend_cpu_ticks();
+    uint8_t status;
+    int32_t vbg_mv;
+
+    switch (ctx->step)
+    {
+        case SCHED_CONV_CONFIGURE:
+        case SCHED_CONV_START:
+            if (!self_test_adc_async_start(NULL))
+            {
+                /* The SAR is busy with an interactive test */
+                return SELF_TEST_STEP_WAIT;
+            }
+            ctx->wait_start_ticks = self_test_trace_phase(SELF_TEST_ID_ADC,
+                    SELF_TEST_PHASE_ROUTE, start);
+            ctx->step = SCHED_CONV_WAIT;
+            return SELF_TEST_STEP_CONTINUE;
+
+        case SCHED_CONV_WAIT:
+            if (!self_test_adc_async_is_ready())
+            {
+                return SELF_TEST_STEP_WAIT;
+            }
+            (void)self_test_trace_phase(SELF_TEST_ID_ADC, SELF_TEST_PHASE_CONVERT,
+                    ctx->wait_start_ticks);
+            ctx->step = SCHED_CONV_EVALUATE;
+            return SELF_TEST_STEP_CONTINUE;
+
+        default:
+            status = self_test_adc_async_evaluate(&ctx->value, &vbg_mv);
+            (void)self_test_trace_phase(SELF_TEST_ID_ADC, SELF_TEST_PHASE_EVALUATE, start);
+            return (OK_STATUS == status) ? SELF_TEST_STEP_PASS : SELF_TEST_STEP_FAIL;
+    }
+}
+
+#if SELF_TEST_HAS_COMPARATOR
+/*******************************************************************************
+* Function Name: sched_comp_step
+********************************************************************************
+* Summary:
+* Executes the next step of the comparator test: the output is checked with the
+* lower and then the higher voltage on the positive input. The reported value
+* holds the output of the first check in bit 0 and of the second in bit 1.
+*
+*******************************************************************************/
+static self_test_step_result_t sched_comp_step(sched_ctx_t *ctx)
+{
+    uint32_t output;
+
+    switch (ctx->step)
+    {
+        case SCHED_COMP_ROUTE_LOW:
+            analog_backend_comp_route(ANALOG_COMP_ROUTE_VPLUS_AMUXB);
+            ctx->wait_start_us = analog_backend_time_us();
+            ctx->wait_start_ticks = analog_backend_cpu_ticks();
+            ctx->step = SCHED_COMP_SETTLE_LOW;
+            return SELF_TEST_STEP_CONTINUE;
+
+        case SCHED_COMP_ROUTE_HIGH:
+            analog_backend_comp_route(ANALOG_COMP_ROUTE_VPLUS_AMUXA);
+            ctx->wait_start_us = analog_backend_time_us();
+            ctx->wait_start_ticks = analog_backend_cpu_ticks();
+            ctx->step = SCHED_COMP_SETTLE_HIGH;
+            return SELF_TEST_STEP_CONTINUE;
+
+        case SCHED_COMP_SETTLE_LOW:
+        case SCHED_COMP_SETTLE_HIGH:
+            if ((analog_backend_time_us() - ctx->wait_start_us) <
+                    SELF_TEST_SCHED_COMP_SETTLE_US)
+            {
+                return SELF_TEST_STEP_WAIT;
+            }
+            (void)self_test_trace_phase(SELF_TEST_ID_COMPARATOR, SELF_TEST_PHASE_SETTLE,
+                    ctx->wait_start_ticks);
+            ctx->step++;
+            return SELF_TEST_STEP_CONTINUE;
+
+        case SCHED_COMP_EVALUATE_LOW:
+            output = analog_backend_comp_read();
+            ctx->value = (int32_t)output;
+            if (!self_test_comp_low_ok(output))
+            {
+                ctx->status = ERROR_STATUS;
+            }
+            ctx->step = SCHED_COMP_ROUTE_HIGH;
+            return SELF_TEST_STEP_CONTINUE;
+
+        default:
+            output = analog_backend_comp_read();
+            ctx->value |= (int32_t)(output << 1u);
+            if (!self_test_comp_high_ok(output))
+            {
+                ctx->status = ERROR_STATUS;
+            }
+            return (OK_STATUS == ctx->status) ?
+                    SELF_TEST_STEP_PASS : SELF_TEST_STEP_FAIL;
+    }
+}
+#endif
+
+#if SELF_TEST_HAS_OPAMP
+/*******************************************************************************
+* Function Name: sched_opamp_step
+********************************************************************************
+* Summary:
+* Executes the next step of the opamp test: the output of the opamp enabled by
+* self_test_setup is converted and checked against the expected result within
+* ANALOG_OPAMP_ACURACCY. The phases are traced as in sched_adc_step.
+*
+*******************************************************************************/
+static self_test_step_result_t sched_opamp_step(sched_ctx_t *ctx)
+{
+    uint32_t start = analog_backend_cpu_ticks();
+    bool ok;
+
+    switch (ctx->step)
+    {
+        case SCHED_CONV_CONFIGURE:
+        case SCHED_CONV_START:
+            if (self_test_adc_async_busy())
+            {
+                /* The SAR is busy with the interrupt driven ADC test */
+                return SELF_TEST_STEP_WAIT;
+            }
+            analog_backend_adc_start(OPAMP_SAR_CHANNEL);
+            ctx->wait_start_ticks = self_test_trace_phase(SELF_TEST_ID_OPAMP,
+                    SELF_TEST_PHASE_ROUTE, start);
+            ctx->step = SCHED_CONV_WAIT;
+            return SELF_TEST_STEP_CONTINUE;
+
+        case SCHED_CONV_WAIT:
+            if (!analog_backend_adc_is_done())
+            {
+                return SELF_TEST_STEP_WAIT;
+            }
+            (void)self_test_trace_phase(SELF_TEST_ID_OPAMP, SELF_TEST_PHASE_CONVERT,
+                    ctx->wait_start_ticks);
+            ctx->step = SCHED_CONV_EVALUATE;
+            return SELF_TEST_STEP_CONTINUE;
+
+        default:
+            ctx->value = analog_backend_adc_read_mv(OPAMP_SAR_CHANNEL);
+            ok = self_test_opamp_ok(ctx->value);
+            (void)self_test_trace_phase(SELF_TEST_ID_OPAMP, SELF_TEST_PHASE_EVALUATE, start);
+            return ok ? SELF_TEST_STEP_PASS : SELF_TEST_STEP_FAIL;
+    }
+}
+#endif
+
+/*******************************************************************************
+* Function Name: sched_pick_next
+********************************************************************************
+* Summary:
+* Selects, in round-robin order, the next test that is triggered, in a burst,
+* or whose adapted period has elapsed.
+*
+* Return :
+*  Test identifier, or SCHED_NONE if no test is due
+*
+*******************************************************************************/
+static uint32_t sched_pick_next(uint32_t now)
+{
+    uint32_t i;
+
+    for (i = 0u; i < (uint32_t)SELF_TEST_ID_COUNT; i++)
+    {
+        uint32_t id = (sched_next + i) % (uint32_t)SELF_TEST_ID_COUNT;
+
+        if ((NULL != sched_tests[id]) &&
+            ((0u != (sched_triggered & (1u << id))) || (0u != sched_adapt[id].burst) ||
+             ((now - sched_last_done_us[id]) >= sched_adapt[id].period_us)))
+        {
+            sched_triggered &= ~(1u << id);
+            sched_next = (id + 1u) % (uint32_t)SELF_TEST_ID_COUNT;
+            return id;
+        }
+    }
+
+    return SCHED_NONE;
+}
+
+/*******************************************************************************
+* Function Name: sched_margin
+********************************************************************************
+* Summary:
+* Returns the margin of a result on the SELF_TEST_SCHED_MARGIN_FULL scale. The
+* comparator output is digital, so its margin is either full or negative.
+*
+*******************************************************************************/
+static int32_t sched_margin(uint32_t id, uint8_t status, int32_t value)
+{
+    int32_t expected;
+    int32_t accuracy;
+    int32_t margin;
+
+    switch (id)
+    {
+        case SELF_TEST_ID_ADC:
+            expected = ADC_REF_EXPECTED;
+            accuracy = ANALOG_ADC_ACURACCY;
+            break;
+
+#if SELF_TEST_HAS_OPAMP
+        case SELF_TEST_ID_OPAMP:
+            expected = OPAMP_REF_EXPECTED;
+            accuracy = ANALOG_OPAMP_ACURACCY;
+            break;
+#endif
+
+        default:
+            return (OK_STATUS == status) ?
+                    SELF_TEST_SCHED_MARGIN_FULL : -SELF_TEST_SCHED_MARGIN_FULL;
+    }
+
+    margin = value - expected;
+    if (margin < 0)
+    {
+        margin = -margin;
+    }
+    margin = ((accuracy - margin) * (SELF_TEST_SCHED_MARGIN_FULL + 1)) / accuracy;
+    if (margin > SELF_TEST_SCHED_MARGIN_FULL)
+    {
+        margin = SELF_TEST_SCHED_MARGIN_FULL;
+    }
+    if (margin < -SELF_TEST_SCHED_MARGIN_FULL)
+    {
+        margin = -SELF_TEST_SCHED_MARGIN_FULL;
+    }
+    /* E.g. the ADC test also fails on the bandgap reading */
+    if ((OK_STATUS != status) && (margin >= 0))
+    {
+        margin = -1;
+    }
+
+    return margin;
+}
+
+/*******************************************************************************
+* Function Name: sched_adapt_update
+********************************************************************************
+* Summary:
+* Adds the margin of a completed run to the history of the test and adapts
+* its period: doubled up to sched_max_period_us while the history is high and
+* stable, back to the base period as soon as the margin shrinks, and a burst
+* of back-to-back runs when it gets close to the limit.
+*
+*******************************************************************************/
+static void sched_adapt_update(uint32_t id, int32_t margin)
+{
+    sched_adapt_t *adapt = &sched_adapt[id];
+    int32_t min = margin;
+    int32_t max = margin;
+    uint32_t i;
+
+    adapt->margin[adapt->pos] = (int8_t)margin;
+    adapt->pos = (uint8_t)((adapt->pos + 1u) % SELF_TEST_SCHED_HISTORY);
+    if (adapt->count < SELF_TEST_SCHED_HISTORY)
+    {
+        adapt->count++;
+    }
+
+    if (0u == sched_max_period_us)
+    {
+        return;
+    }
+
+    if (0u != adapt->burst)
+    {
+        adapt->burst--;
+    }
+    else if (margin < SELF_TEST_SCHED_MARGIN_LOW)
+    {
+        adapt->burst = SELF_TEST_SCHED_BURST_RUNS;
+        sched_stats.test[id].escalations++;
+    }
+
+    for (i = 0u; i < adapt->count; i++)
+    {
+        if (adapt->margin[i] < min)
+        {
+            min = adapt->margin[i];
+        }
+        if (adapt->margin[i] > max)
+        {
+            max = adapt->margin[i];
+        }
+    }
+
+    if (margin < SELF_TEST_SCHED_MARGIN_HIGH)
+    {
+        adapt->period_us = sched_config.period_us;
+    }
+    else if ((SELF_TEST_SCHED_HISTORY == adapt->count) &&
+             (min >= SELF_TEST_SCHED_MARGIN_HIGH) &&
+             ((max - min) <= SELF_TEST_SCHED_MARGIN_STABLE))
+    {
+        adapt->period_us = (adapt->period_us > (sched_max_period_us / 2u)) ?
+                sched_max_period_us : (adapt->period_us * 2u);
+    }
+}
+
+/*******************************************************************************
+* Function Name: sched_release_sar
+********************************************************************************
+* Summary:
+* Stops the conversion of the active test, if it has one in progress, before
+* the test is abandoned.
+*
+*******************************************************************************/
+static void sched_release_sar(void)
+{
+    if (((uint32_t)SELF_TEST_ID_ADC == sched_active) && (SCHED_CONV_WAIT <= sched_ctx.step))
+    {
+        self_test_adc_async_cancel();
+    }
+#if SELF_TEST_HAS_OPAMP
+    if (((uint32_t)SELF_TEST_ID_OPAMP == sched_active) && (SCHED_CONV_WAIT == sched_ctx.step))
+    {
+        analog_backend_adc_stop();
+    }
+#endif
+}
+
+/*******************************************************************************
+* Function Name: sched_complete
+********************************************************************************
+* Summary:
+* Records the completion of the active test and reports its result.
+*
+*******************************************************************************/
+static void sched_complete(uint32_t id, self_test_step_result_t result, uint32_t now)
+{
+    self_test_sched_test_stats_t *stats = &sched_stats.test[id];
+    uint32_t interval = now - sched_last_done_us[id];
+    uint8_t status = (uint8_t)((SELF_TEST_STEP_PASS == result) ? OK_STATUS : ERROR_STATUS);
+
+    stats->runs++;
+    stats->last_value = sched_ctx.value;
+    if (OK_STATUS != status)
+    {
+        stats->failures++;
+    }
+    sched_stats.busy_us += now - sched_start_us;
+
+    stats->margin = sched_margin(id, status, sched_ctx.value);
+    sched_adapt_update(id, stats->margin);
+    stats->period_us = sched_adapt[id].period_us;
+    /* The first interval is measured from self_test_sched_init */
+    if (1u == stats->runs)
+    {
+        interval -= sched_config.period_us;
+    }
+    if (interval > stats->max_interval_us)
+    {
+        stats->max_interval_us = interval;
+    }
+    if (interval > sched_config.coverage_us)
+    {
+        stats->coverage_misses++;
+    }
+    sched_last_done_us[id] = now;
+
+    if (NULL != sched_config.result_cb)
+    {
+        sched_config.result_cb((self_test_id_t)id, status, sched_ctx.value);
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_sched_init
+********************************************************************************
+* Summary:
+* Initializes the scheduler and performs the one-time setup of the analog
+* blocks if it has not been done yet. All available tests are due immediately
+* and start at the base period with an empty margin history.
+*
+* Parameters:
+*  config : Scheduler configuration, or NULL for the default values
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_sched_init(const self_test_sched_config_t *config)
+{
+    uint32_t now;
+    uint32_t i;
+
+    if (NULL != config)
+    {
+        sched_config = *config;
+    }
+    else
+    {
+        sched_config.tick_budget_us = SELF_TEST_SCHED_TICK_BUDGET_US;
+        sched_config.period_us = SELF_TEST_SCHED_PERIOD_US;
+        sched_config.coverage_us = SELF_TEST_SCHED_COVERAGE_US;
+        sched_config.max_period_us = SELF_TEST_SCHED_MAX_PERIOD_US;
+        sched_config.result_cb = NULL;
+    }
+
+    /* A stretched period must still leave one base period to the end of the
+     * coverage interval.
+     */
+    sched_max_period_us = 0u;
+    if (sched_config.coverage_us > (2u * sched_config.period_us))
+    {
+        sched_max_period_us = sched_config.coverage_us - sched_config.period_us;
+        if (sched_config.max_period_us < sched_max_period_us)
+        {
+            sched_max_period_us = sched_config.max_period_us;
+        }
+        if (sched_max_period_us <= sched_config.period_us)
+        {
+            sched_max_period_us = 0u;
+        }
+    }
+
+    /* A restart must not leave a conversion of the previous run in flight */
+    self_test_sched_abort();
+
+    self_test_setup();
+    analog_backend_time_init();
+    now = analog_backend_time_us();
+
+    (void)memset(&sched_stats, 0, sizeof(sched_stats));
+    (void)memset(&sched_ctx, 0, sizeof(sched_ctx));
+    (void)memset(sched_adapt, 0, sizeof(sched_adapt));
+    sched_active = SCHED_NONE;
+    sched_next = 0u;
+    sched_triggered = 0u;
+    sched_last_tick_us = now;
+    for (i = 0u; i < (uint32_t)SELF_TEST_ID_COUNT; i++)
+    {
+        sched_last_done_us[i] = now - sched_config.period_us;
+        sched_adapt[i].period_us = sched_config.period_us;
+        sched_stats.test[i].period_us = sched_config.period_us;
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_sched_tick
+********************************************************************************
+* Summary:
+* Runs test steps until the tick budget is used, the active test waits on the
+* hardware, or no test is due. A step is never interrupted, so the CPU is held
+* for at most the tick budget plus the longest step; both are recorded in the
+* statistics. A run past the deadline of the watchdog supervisor is abandoned
+* as failed.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_sched_tick(void)
+{
+    uint32_t tick_start = analog_backend_time_us();
+    uint32_t now = tick_start;
+    uint32_t elapsed;
+
+    sched_stats.ticks++;
+    sched_stats.elapsed_us += tick_start - sched_last_tick_us;
+
+    while ((now - tick_start) < sched_config.tick_budget_us)
+    {
+        self_test_step_result_t result;
+        uint32_t step_us;
+
+        if (SCHED_NONE == sched_active)
+        {
+            sched_active = sched_pick_next(now);
+            if (SCHED_NONE == sched_active)
+            {
+                break;
+            }
+            (void)memset(&sched_ctx, 0, sizeof(sched_ctx));
+            sched_ctx.status = OK_STATUS;
+            sched_start_us = now;
+            self_test_wdt_begin((self_test_id_t)sched_active, true);
+        }
+
+        if (self_test_wdt_expired())
+        {
+            /* The run overran its deadline, e.g. on a conversion that never
+             * completes: abandon it as failed so the next run starts afresh.
+             */
+            sched_release_sar();
+            sched_complete(sched_active, SELF_TEST_STEP_FAIL, now);
+            sched_active = SCHED_NONE;
+            continue;
+        }
+
+        result = sched_tests[sched_active](&sched_ctx);
+
+        step_us = analog_backend_time_us() - now;
+        if (step_us > sched_stats.max_step_us)
+        {
+            sched_stats.max_step_us = step_us;
+        }
+        now += step_us;
+
+        if (SELF_TEST_STEP_WAIT == result)
+        {
+            break;
+        }
+        if (SELF_TEST_STEP_CONTINUE != result)
+        {
+            self_test_wdt_end((self_test_id_t)sched_active, true);
+            sched_complete(sched_active, result, now);
+            sched_active = SCHED_NONE;
+        }
+    }
+
+    sched_last_tick_us = analog_backend_time_us();
+    elapsed = sched_last_tick_us - tick_start;
+    if (elapsed > sched_stats.max_tick_us)
+    {
+        sched_stats.max_tick_us = elapsed;
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_sched_abort
+********************************************************************************
+* Summary:
+* Abandons the test in progress, e.g. before a test is run interactively on
+* the same peripheral. The abandoned test restarts from its first step.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_sched_abort(void)
+{
+    if (SCHED_NONE != sched_active)
+    {
+        sched_release_sar();
+        self_test_wdt_end((self_test_id_t)sched_active, false);
+        sched_stats.busy_us += analog_backend_time_us() - sched_start_us;
+        sched_next = sched_active;
+        sched_active = SCHED_NONE;
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_sched_trigger
+********************************************************************************
+* Summary:
+* Makes a test due immediately, independent of its period, e.g. after an
+* event that calls for a fresh diagnostic.
+*
+* Parameters:
+*  id : Test to run
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_sched_trigger(self_test_id_t id)
+{
+    if (NULL != sched_tests[id])
+    {
+        sched_triggered |= (1u << (uint32_t)id);
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_sched_next_due_us
+********************************************************************************
+* Summary:
+* Returns the time until the scheduler has work again, so that the caller can
+* sleep in between.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  Time in microseconds until the next test is due, 0 if a test is in
+*  progress or due now
+*
+*******************************************************************************/
+uint32_t self_test_sched_next_due_us(void)
+{
+    uint32_t now = analog_backend_time_us();
+    uint32_t next = UINT32_MAX;
+    uint32_t since;
+    uint32_t i;
+
+    if ((SCHED_NONE != sched_active) || (0u != sched_triggered))
+    {
+        return 0u;
+    }
+
+    for (i = 0u; i < (uint32_t)SELF_TEST_ID_COUNT; i++)
+    {
+        if (NULL == sched_tests[i])
+        {
+            continue;
+        }
+        since = now - sched_last_done_us[i];
+        if ((since >= sched_adapt[i].period_us) || (0u != sched_adapt[i].burst))
+        {
+            return 0u;
+        }
+        if ((sched_adapt[i].period_us - since) < next)
+        {
+            next = sched_adapt[i].period_us - since;
+        }
+    }
+
+    return next;
+}
+
+/*******************************************************************************
+* Function Name: self_test_sched_get_stats
+********************************************************************************
+* Summary:
+* Returns the scheduler statistics.
+*
+*******************************************************************************/
+const self_test_sched_stats_t *self_test_sched_get_stats(void)
+{
+    return &sched_stats;
+}
+
+/*******************************************************************************
+* Function Name: self_test_sched_print_stats
+********************************************************************************
+* Summary:
+* Prints the scheduler statistics on the console.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_sched_print_stats(void)
+{
+    uint32_t i;
+    uint32_t occupancy = (0u != sched_stats.elapsed_us) ?
+            (uint32_t)((sched_stats.busy_us * 10000u) / sched_stats.elapsed_us) : 0u;
+
+    printf("Scheduler: %lu ticks, worst-case tick %lu us, worst-case step %lu us, "
+           "analog occupancy %lu.%02lu %%\r\n",
+            (unsigned long)sched_stats.ticks, (unsigned long)sched_stats.max_tick_us,
+            (unsigned long)sched_stats.max_step_us, (unsigned long)(occupancy / 100u),
+            (unsigned long)(occupancy % 100u));
+
+    for (i = 0u; i < (uint32_t)SELF_TEST_ID_COUNT; i++)
+    {
+        const self_test_sched_test_stats_t *stats = &sched_stats.test[i];
+
+        if (NULL == sched_tests[i])
+        {
+            continue;
+        }
+        printf("  %-10s runs %lu, failures %lu, last %ld, max interval %lu us, "
+               "coverage misses %lu\r\n", sched_test_names[i],
+                (unsigned long)stats->runs, (unsigned long)stats->failures,
+                (long)stats->last_value, (unsigned long)stats->max_interval_us,
+                (unsigned long)stats->coverage_misses);
+        printf("  %-10s margin %ld/%d, period %lu us, escalations %lu\r\n", "",
+                (long)stats->margin, SELF_TEST_SCHED_MARGIN_FULL,
+                (unsigned long)stats->period_us, (unsigned long)stats->escalations);
+    }
+}
+
+/* [] END OF FILE */
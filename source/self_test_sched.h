@@ -0,0 +1,156 @@
+/******************************************************************************
+* File Name:   self_test_sched.h
+*
+* Description: This file is the public interface of self_test_sched.c, the
+*              cooperative scheduler that runs the analog self tests
+*              periodically in short resumable steps.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_SCHED_H_
+#define SELF_TEST_SCHED_H_
+
+#include "self_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Maximum time a tick may start new steps for, in microseconds */
+#define SELF_TEST_SCHED_TICK_BUDGET_US     (50u)
+
+/* Time between two runs of the same test, in microseconds */
+#define SELF_TEST_SCHED_PERIOD_US          (100000u)
+
+/* Diagnostic coverage interval: every test must complete at least once
+ * within this time, in microseconds.
+ */
+#define SELF_TEST_SCHED_COVERAGE_US        (1000000u)
+
+/* Longest period a test with a large and stable margin is stretched to, in
+ * microseconds. The scheduler limits it to coverage_us - period_us, which
+ * leaves one base period for a due test to wait for its turn and complete.
+ */
+#define SELF_TEST_SCHED_MAX_PERIOD_US      (800000u)
+
+/* Number of margins kept per test */
+#define SELF_TEST_SCHED_HISTORY            (8u)
+
+/* Margin of a result, relative to the test accuracy: SELF_TEST_SCHED_MARGIN_FULL
+ * at the expected value, 0 at the accuracy limit, negative for a failed test.
+ * The period is doubled while every margin in the history is at least
+ * SELF_TEST_SCHED_MARGIN_HIGH and they spread by at most
+ * SELF_TEST_SCHED_MARGIN_STABLE. A margin below SELF_TEST_SCHED_MARGIN_HIGH
+ * restores the base period; one below SELF_TEST_SCHED_MARGIN_LOW also
+ * repeats the test SELF_TEST_SCHED_BURST_RUNS times back to back.
+ */
+#define SELF_TEST_SCHED_MARGIN_FULL        (127)
+#define SELF_TEST_SCHED_MARGIN_HIGH        (64)
+#define SELF_TEST_SCHED_MARGIN_LOW         (32)
+#define SELF_TEST_SCHED_MARGIN_STABLE      (16)
+#define SELF_TEST_SCHED_BURST_RUNS         (4u)
+
+/* Comparator output settling time after an input routing change */
+#define SELF_TEST_SCHED_COMP_SETTLE_US     (COMP_SETTLE_US)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Result of one step of a test */
+typedef enum
+{
+    SELF_TEST_STEP_CONTINUE = 0u,  /* Step done, call again for the next one */
+    SELF_TEST_STEP_WAIT,           /* Waiting on the hardware, yield the CPU */
+    SELF_TEST_STEP_PASS,           /* Test completed and passed */
+    SELF_TEST_STEP_FAIL            /* Test completed and failed */
+} self_test_step_result_t;
+
+/* Callback invoked when a scheduled test completes */
+typedef void (*self_test_sched_result_cb_t)(self_test_id_t id, uint8_t status,
+        int32_t value);
+
+/* Scheduler configuration */
+typedef struct
+{
+    uint32_t tick_budget_us;       /* See SELF_TEST_SCHED_TICK_BUDGET_US */
+    uint32_t period_us;            /* See SELF_TEST_SCHED_PERIOD_US */
+    uint32_t coverage_us;          /* See SELF_TEST_SCHED_COVERAGE_US */
+    uint32_t max_period_us;        /* See SELF_TEST_SCHED_MAX_PERIOD_US, 0 to
+                                    * run every test at period_us */
+    self_test_sched_result_cb_t result_cb; /* Optional completion callback */
+} self_test_sched_config_t;
+
+/* Per test statistics */
+typedef struct
+{
+    uint32_t runs;                 /* Completed runs */
+    uint32_t failures;             /* Completed runs that failed */
+    int32_t last_value;            /* Last measured value */
+    uint32_t max_interval_us;      /* Longest time between two completions */
+    uint32_t coverage_misses;      /* Completions later than coverage_us */
+    int32_t margin;                /* Margin of the last run */
+    uint32_t period_us;            /* Current adapted period */
+    uint32_t escalations;          /* Back-to-back bursts started */
+} self_test_sched_test_stats_t;
+
+/* Scheduler statistics */
+typedef struct
+{
+    uint32_t ticks;                /* Calls of self_test_sched_tick */
+    uint32_t max_tick_us;          /* Worst-case CPU time held by one tick */
+    uint32_t max_step_us;          /* Worst-case duration of one step */
+    uint64_t elapsed_us;           /* Time covered by the ticks */
+    uint64_t busy_us;              /* Time a test was in progress */
+    self_test_sched_test_stats_t test[SELF_TEST_ID_COUNT];
+} self_test_sched_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void self_test_sched_init(const self_test_sched_config_t *config);
+void self_test_sched_tick(void);
+void self_test_sched_abort(void);
+void self_test_sched_trigger(self_test_id_t id);
+uint32_t self_test_sched_next_due_us(void);
+const self_test_sched_stats_t *self_test_sched_get_stats(void);
+void self_test_sched_print_stats(void);
+
+#endif /* SELF_TEST_SCHED_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,209 @@
+/******************************************************************************
+* File Name:   self_test_stats.c
+*
+* Description: This file implements the integer-only statistics kernels. The
+*              mean and variance are returned in fixed point with
+*              SELF_TEST_STATS_Q fractional bits. The step response kernel
+*              measures the levels, settling and steepest edge of a captured
+*              buffer.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdbool.h>
+#include "self_test_stats.h"
+
+
+/*******************************************************************************
+* Function Name: self_test_stats_reset
+********************************************************************************
+* Summary:
+* Clears the running sums before a new batch.
+*
+* Parameters:
+*  stats : Running sums
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_stats_reset(self_test_stats_t *stats)
+{
+    stats->count = 0u;
+    stats->min = INT32_MAX;
+    stats->max = INT32_MIN;
+    stats->sum = 0;
+    stats->sum_sq = 0u;
+}
+
+/*******************************************************************************
+* Function Name: self_test_stats_mean_q
+********************************************************************************
+* Summary:
+* Returns the mean of the batch.
+*
+* Parameters:
+*  stats : Running sums
+*
+* Return :
+*  Mean with SELF_TEST_STATS_Q fractional bits, 0 for an empty batch
+*
+*******************************************************************************/
+int32_t self_test_stats_mean_q(const self_test_stats_t *stats)
+{
+    if (0u == stats->count)
+    {
+        return 0;
+    }
+
+    return (int32_t)(((int64_t)stats->sum * (1 << SELF_TEST_STATS_Q)) /
+            (int64_t)stats->count);
+}
+
+/*******************************************************************************
+* Function Name: self_test_stats_variance_q
+********************************************************************************
+* Summary:
+* Returns the population variance of the batch,
+* (n * sum(x^2) - sum(x)^2) / n^2, computed exactly in 64-bit integers.
+*
+* Parameters:
+*  stats : Running sums
+*
+* Return :
+*  Variance with SELF_TEST_STATS_Q fractional bits, 0 for an empty batch
+*
+*******************************************************************************/
+uint32_t self_test_stats_variance_q(const self_test_stats_t *stats)
+{
+    uint64_t n = stats->count;
+    int64_t sum = stats->sum;
+    uint64_t spread;
+
+    if (0u == n)
+    {
+        return 0u;
+    }
+
+    spread = (n * stats->sum_sq) - (uint64_t)(sum * sum);
+
+    return (uint32_t)((spread << SELF_TEST_STATS_Q) / (n * n));
+}
+
+/*******************************************************************************
+* Function Name: self_test_stats_step
+********************************************************************************
+* Summary:
+* Evaluates a captured step response in one pass, walking the buffer from its
+* end: the last SELF_TEST_STATS_STEP_TAIL samples give the final level, the
+* first sample outside the band around it (the last one in time) ends the
+* settling, and the samples before the step give the base level. The largest
+* rise and fall between two consecutive samples are tracked on the way, and
+* the one in the direction of the step is returned. Each sample costs one
+* subtraction, two compares and one range check folded into an unsigned
+* compare; the only divisions are the two level means.
+*
+* Parameters:
+*  samples : Captured response; samples[pre] is the first one after the step
+*  count   : Number of samples, at least pre + SELF_TEST_STATS_STEP_TAIL
+*  pre     : Number of samples before the step, at least 1
+*  band    : Half width of the settling band around the final level
+*  step    : Returns the levels and dynamics
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_stats_step(const int16_t *samples, uint32_t count, uint32_t pre,
+        uint32_t band, self_test_step_t *step)
+{
+    const uint32_t tail = count - SELF_TEST_STATS_STEP_TAIL;
+    uint32_t settled = pre;
+    uint32_t i = count;
+    int32_t sum = 0;
+    int32_t final = 0;
+    int32_t rise = 0;
+    int32_t fall = 0;
+    int32_t next = samples[count - 1u];
+    int32_t delta;
+    int32_t x;
+    bool outside = false;
+
+    while (i > 0u)
+    {
+        i--;
+        x = samples[i];
+        delta = next - x;
+        next = x;
+        if (delta > rise)
+        {
+            rise = delta;
+        }
+        if (delta < fall)
+        {
+            fall = delta;
+        }
+
+        if (i >= tail)
+        {
+            sum += x;
+            if (i == tail)
+            {
+                final = sum / (int32_t)SELF_TEST_STATS_STEP_TAIL;
+                sum = 0;
+            }
+        }
+        else if (i >= pre)
+        {
+            if ((!outside) && ((uint32_t)(x - (final - (int32_t)band)) > (2u * band)))
+            {
+                settled = i + 1u;
+                outside = true;
+            }
+        }
+        else
+        {
+            sum += x;
+        }
+    }
+
+    step->base = sum / (int32_t)pre;
+    step->final = final;
+    step->settle_samples = settled - pre;
+    step->max_delta = (final >= step->base) ? rise : -fall;
+}
+
+/* [] END OF FILE */
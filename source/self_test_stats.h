@@ -0,0 +1,130 @@
+/******************************************************************************
+* File Name:   self_test_stats.h
+*
+* Description: This file is the public interface of self_test_stats.c, the
+*              integer-only statistics kernels used to evaluate batches of
+*              samples and captured step responses.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_STATS_H_
+#define SELF_TEST_STATS_H_
+
+#include <stdint.h>
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Fractional bits of the fixed-point mean and variance */
+#define SELF_TEST_STATS_Q                  (8u)
+
+/* Largest number of samples the accumulators are sized for */
+#define SELF_TEST_STATS_MAX_SAMPLES        (4096u)
+
+/* Samples at the end of a step response averaged into its final level */
+#define SELF_TEST_STATS_STEP_TAIL          (8u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Running sums of a batch of samples */
+typedef struct
+{
+    uint32_t count;                /* Number of samples */
+    int32_t min;                   /* Smallest sample */
+    int32_t max;                   /* Largest sample */
+    int32_t sum;                   /* Sum of the samples */
+    uint64_t sum_sq;               /* Sum of the squared samples */
+} self_test_stats_t;
+
+/* Levels and dynamics of a captured step response */
+typedef struct
+{
+    int32_t base;                  /* Mean of the samples before the step */
+    int32_t final;                 /* Mean of the last SELF_TEST_STATS_STEP_TAIL
+                                    * samples */
+    uint32_t settle_samples;       /* Samples from the step until the response
+                                    * stays within the band around final */
+    int32_t max_delta;             /* Largest change between two consecutive
+                                    * samples in the step direction */
+} self_test_step_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void self_test_stats_reset(self_test_stats_t *stats);
+int32_t self_test_stats_mean_q(const self_test_stats_t *stats);
+uint32_t self_test_stats_variance_q(const self_test_stats_t *stats);
+void self_test_stats_step(const int16_t *samples, uint32_t count, uint32_t pre,
+        uint32_t band, self_test_step_t *step);
+
+/*******************************************************************************
+* Function Name: self_test_stats_add
+********************************************************************************
+* Summary:
+* Adds one sample to the running sums. Kept inline because it runs once per
+* sample: one compare pair, one add and one 32x32->64 multiply-accumulate.
+*
+* Parameters:
+*  stats  : Running sums
+*  sample : New sample, |sample| < 2^16
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+static inline void self_test_stats_add(self_test_stats_t *stats, int32_t sample)
+{
+    if (sample < stats->min)
+    {
+        stats->min = sample;
+    }
+    if (sample > stats->max)
+    {
+        stats->max = sample;
+    }
+    stats->sum += sample;
+    stats->sum_sq += (uint64_t)((int64_t)sample * sample);
+    stats->count++;
+}
+
+#endif /* SELF_TEST_STATS_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,140 @@
+/******************************************************************************
+* File Name:   self_test_target.h
+*
+* Description: This file holds the compile-time descriptor of each target
+*              family: the analog blocks that can be tested, the SAR channels
+*              of the test signals and the expected results with their
+*              tolerances. The evaluation kernels are generated from the
+*              descriptor with the thresholds folded in as constants, so the
+*              test code has neither device-type conditionals nor runtime
+*              branches on the device type.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_TARGET_H_
+#define SELF_TEST_TARGET_H_
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Target family descriptors. Only the family selection tests the device
+ * macros; everything else uses the SELF_TEST_* descriptor values.
+ */
+#if COMPONENT_CAT1A
+    /* PSoC 6: LPCOMP on all parts, CTB opamp on the 256K and 1M flash parts */
+    #define SELF_TEST_TARGET_NAME          "PSoC 6"
+    #define SELF_TEST_HAS_COMPARATOR       (1)
+    #if (defined(CY_DEVICE_PSOC6A256K) || defined(CY_DEVICE_PSOC6ABLE2))
+        #define SELF_TEST_HAS_OPAMP        (1)
+    #else
+        #define SELF_TEST_HAS_OPAMP        (0)
+    #endif
+    /* Channel no. where the VBG voltage is connected */
+    #define VBG_CHANNEL                    (0u)
+#elif COMPONENT_CAT1C
+    /* XMC7000: SAR2 only, no LPCOMP and no CTB */
+    #define SELF_TEST_TARGET_NAME          "XMC7000"
+    #define SELF_TEST_HAS_COMPARATOR       (0)
+    #define SELF_TEST_HAS_OPAMP            (0)
+    /* Channel no. where the VBG voltage is connected */
+    #define VBG_CHANNEL                    (1u)
+#else
+    #error "Unsupported target family"
+#endif
+
+/* SAR channel the (VDDA / 3) reference voltage is connected to. The periodic,
+ * interrupt driven, oversampled and combined tests check this reference.
+ */
+#define ADC_REF_CHANNEL                    (0u)
+
+/* Set to 1 to also check (2VDDA / 3) on ADC_REF2_CHANNEL. The default designs
+ * configure only the channels up to OPAMP_SAR_CHANNEL, so the channel must be
+ * added to the SAR configuration first.
+ */
+#ifndef ADC_REF_VOLTAGE2
+    #define ADC_REF_VOLTAGE2               (0)
+#endif
+
+/* SAR channel the (2VDDA / 3) reference voltage is connected to */
+#define ADC_REF2_CHANNEL                   (2u)
+
+/* SAR channel the opamp output is connected to */
+#define OPAMP_SAR_CHANNEL                  (1u)
+
+/* Expected result on ADC_REF_CHANNEL and on the opamp output, in millivolts */
+#define ADC_REF_EXPECTED                   (ANALOG_ADC_SAR_RESULT1)
+#define OPAMP_REF_EXPECTED                 (ANALOG_OPAMP_SAR_RESULT1)
+
+/* Generates a range check of expected +/- accuracy. Both limits are folded
+ * into one unsigned compare: below the lower limit, the difference wraps to
+ * a large value.
+ */
+#define SELF_TEST_RANGE_KERNEL(name, expected, accuracy)                    \
+    static inline bool name(int32_t value)                                  \
+    {                                                                       \
+        return ((uint32_t)(value - ((expected) - (accuracy))) <=            \
+                (uint32_t)(2 * (accuracy)));                                \
+    }
+
+/* Generates a check of a digital output against its expected level */
+#define SELF_TEST_LEVEL_KERNEL(name, expected)                              \
+    static inline bool name(uint32_t output)                                \
+    {                                                                       \
+        return ((expected) == output);                                      \
+    }
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+/* Evaluation kernels of the tests available on the target */
+SELF_TEST_RANGE_KERNEL(self_test_adc_ref_ok, ADC_REF_EXPECTED, ANALOG_ADC_ACURACCY)
+
+#if SELF_TEST_HAS_COMPARATOR
+/* Lower voltage on the positive input, then the higher one */
+SELF_TEST_LEVEL_KERNEL(self_test_comp_low_ok, ANALOG_COMP_RESULT2)
+SELF_TEST_LEVEL_KERNEL(self_test_comp_high_ok, ANALOG_COMP_RESULT1)
+#endif
+
+#if SELF_TEST_HAS_OPAMP
+SELF_TEST_RANGE_KERNEL(self_test_opamp_ok, OPAMP_REF_EXPECTED, ANALOG_OPAMP_ACURACCY)
+#endif
+
+#endif /* SELF_TEST_TARGET_H_ */
+
+/* [] END OF FILE */
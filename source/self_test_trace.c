@@ -0,0 +1,281 @@
+/******************************************************************************
+* File Name:   self_test_trace.c
+*
+* Description: This file records how long each phase of the analog self tests
+*              takes. The test paths store one record per phase in a ring
+*              buffer, and the records are folded into per-phase minimum,
+*              average and maximum outside the test paths.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "self_test_trace.h"
+#include "self_test_wdt.h"
+
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* One recorded phase */
+typedef struct
+{
+    uint8_t id;                    /* self_test_id_t of the test */
+    uint8_t phase;                 /* self_test_phase_t of the phase */
+    uint32_t ticks;                /* Duration in CPU ticks */
+} trace_record_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char * const trace_test_names[SELF_TEST_ID_COUNT] =
+{
+    [SELF_TEST_ID_ADC] = "ADC",
+    [SELF_TEST_ID_COMPARATOR] = "Comparator",
+    [SELF_TEST_ID_OPAMP] = "OP-AMP",
+};
+
+static const char * const trace_phase_names[SELF_TEST_PHASE_COUNT] =
+{
+    [SELF_TEST_PHASE_SETUP] = "setup",
+    [SELF_TEST_PHASE_ROUTE] = "route",
+    [SELF_TEST_PHASE_SETTLE] = "settle",
+    [SELF_TEST_PHASE_CONVERT] = "convert",
+    [SELF_TEST_PHASE_CAPTURE] = "capture",
+    [SELF_TEST_PHASE_EVALUATE] = "evaluate",
+    [SELF_TEST_PHASE_REPORT] = "report",
+};
+
+/* Records not collected yet; trace_head is only written by the test paths and
+ * trace_tail only by self_test_trace_collect.
+ */
+static trace_record_t trace_ring[SELF_TEST_TRACE_DEPTH];
+static volatile uint32_t trace_head;
+static volatile uint32_t trace_tail;
+static uint32_t trace_dropped;
+
+static self_test_trace_stats_t trace_stats[SELF_TEST_ID_COUNT][SELF_TEST_PHASE_COUNT];
+
+/*******************************************************************************
+* Function Name: self_test_trace_phase
+********************************************************************************
+* Summary:
+* Records the end of a phase that started at start_ticks. The returned end time
+* is the start of the next phase, so consecutive phases can be chained:
+*   t = analog_backend_cpu_ticks();
+*   ...
+*   t = self_test_trace_phase(id, SELF_TEST_PHASE_ROUTE, t);
+* The record is dropped, and counted, if the ring buffer is full. The phase is
+* also checked against its budget by the watchdog supervisor.
+*
+* Parameters:
+*  id          : Test the phase belongs to
+*  phase       : Phase that ended
+*  start_ticks : CPU ticks at the start of the phase
+*
+* Return :
+*  CPU ticks at the end of the phase
+*
+*******************************************************************************/
+uint32_t self_test_trace_phase(self_test_id_t id, self_test_phase_t phase,
+        uint32_t start_ticks)
+{
+    uint32_t now = analog_backend_cpu_ticks();
+    uint32_t head = trace_head;
+    trace_record_t *record;
+
+    self_test_wdt_phase(id, phase);
+
+    if ((head - trace_tail) >= SELF_TEST_TRACE_DEPTH)
+    {
+        trace_dropped++;
+        return now;
+    }
+
+    record = &trace_ring[head % SELF_TEST_TRACE_DEPTH];
+    record->id = (uint8_t)id;
+    record->phase = (uint8_t)phase;
+    record->ticks = now - start_ticks;
+    trace_head = head + 1u;
+
+    return now;
+}
+
+/*******************************************************************************
+* Function Name: self_test_trace_collect
+********************************************************************************
+* Summary:
+* Folds the records in the ring buffer into the per-phase statistics. Called
+* from the main loop, outside the test paths.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_trace_collect(void)
+{
+    uint32_t tail = trace_tail;
+    const trace_record_t *record;
+    self_test_trace_stats_t *stats;
+
+    while (tail != trace_head)
+    {
+        record = &trace_ring[tail % SELF_TEST_TRACE_DEPTH];
+        stats = &trace_stats[record->id][record->phase];
+
+        if ((0u == stats->count) || (record->ticks < stats->min))
+        {
+            stats->min = record->ticks;
+        }
+        if (record->ticks > stats->max)
+        {
+            stats->max = record->ticks;
+        }
+        stats->sum += record->ticks;
+        stats->count++;
+
+        tail++;
+    }
+    trace_tail = tail;
+}
+
+/*******************************************************************************
+* Function Name: self_test_trace_get_stats
+********************************************************************************
+* Summary:
+* Returns the collected timing of one phase of one test.
+*
+* Parameters:
+*  id    : Test
+*  phase : Phase
+*
+* Return :
+*  Timing statistics in CPU ticks
+*
+*******************************************************************************/
+const self_test_trace_stats_t *self_test_trace_get_stats(self_test_id_t id,
+        self_test_phase_t phase)
+{
+    return &trace_stats[id][phase];
+}
+
+/*******************************************************************************
+* Function Name: self_test_trace_phase_name
+********************************************************************************
+* Summary:
+* Returns the name of a phase for the console output.
+*
+* Parameters:
+*  phase : Phase
+*
+* Return :
+*  Name of the phase
+*
+*******************************************************************************/
+const char *self_test_trace_phase_name(self_test_phase_t phase)
+{
+    return trace_phase_names[phase];
+}
+
+/*******************************************************************************
+* Function Name: self_test_trace_reset
+********************************************************************************
+* Summary:
+* Discards the pending records and clears the statistics.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_trace_reset(void)
+{
+    trace_tail = trace_head;
+    trace_dropped = 0u;
+    (void)memset(trace_stats, 0, sizeof(trace_stats));
+}
+
+/*******************************************************************************
+* Function Name: self_test_trace_print
+********************************************************************************
+* Summary:
+* Collects the pending records and prints the minimum, average and maximum
+* duration of every recorded phase.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_trace_print(void)
+{
+    uint32_t ticks_per_us = analog_backend_cpu_ticks_per_us();
+    const self_test_trace_stats_t *stats;
+    uint32_t id;
+    uint32_t phase;
+
+    self_test_trace_collect();
+
+    printf("Phase timing in CPU ticks (%lu per us), dropped records %lu\r\n",
+            (unsigned long)ticks_per_us, (unsigned long)trace_dropped);
+    for (id = 0u; id < (uint32_t)SELF_TEST_ID_COUNT; id++)
+    {
+        for (phase = 0u; phase < (uint32_t)SELF_TEST_PHASE_COUNT; phase++)
+        {
+            stats = &trace_stats[id][phase];
+            if (0u == stats->count)
+            {
+                continue;
+            }
+            printf("  %-10s %-8s n %lu, min %lu, avg %lu, max %lu (%lu us)\r\n",
+                    trace_test_names[id], trace_phase_names[phase],
+                    (unsigned long)stats->count, (unsigned long)stats->min,
+                    (unsigned long)(stats->sum / stats->count),
+                    (unsigned long)stats->max,
+                    (unsigned long)(stats->max / ticks_per_us));
+        }
+    }
+}
+
+/* [] END OF FILE */
@@ -0,0 +1,96 @@
+/******************************************************************************
+* File Name:   self_test_trace.h
+*
+* Description: This file is the public interface of self_test_trace.c, the
+*              phase timing instrumentation of the analog self tests.
+*
+* Related Document: See README.md
+*
+*
+*******************************************************************************
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_TRACE_H_
+#define SELF_TEST_TRACE_H_
+
+#include "self_test.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Number of phase records the ring buffer holds until they are collected */
+#define SELF_TEST_TRACE_DEPTH              (64u)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Phases of a self test run */
+typedef enum
+{
+    SELF_TEST_PHASE_SETUP = 0u,    /* One-time peripheral initialization */
+    SELF_TEST_PHASE_ROUTE,         /* GPIO / AMUXBUS routing */
+    SELF_TEST_PHASE_SETTLE,        /* Waiting for inputs to settle */
+    SELF_TEST_PHASE_CONVERT,       /* SAR conversion and its evaluation */
+    SELF_TEST_PHASE_CAPTURE,       /* Burst of SAR samples of a waveform */
+    SELF_TEST_PHASE_EVALUATE,      /* Reading and checking a result */
+    SELF_TEST_PHASE_REPORT,        /* Console output of the result */
+    SELF_TEST_PHASE_COUNT
+} self_test_phase_t;
+
+/* Timing of one phase over all collected runs, in CPU ticks */
+typedef struct
+{
+    uint32_t count;                /* Number of recorded phases */
+    uint32_t min;                  /* Shortest duration */
+    uint32_t max;                  /* Longest duration */
+    uint64_t sum;                  /* Sum of the durations */
+} self_test_trace_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+uint32_t self_test_trace_phase(self_test_id_t id, self_test_phase_t phase,
+        uint32_t start_ticks);
+void self_test_trace_collect(void);
+const self_test_trace_stats_t *self_test_trace_get_stats(self_test_id_t id,
+        self_test_phase_t phase);
+const char *self_test_trace_phase_name(self_test_phase_t phase);
+void self_test_trace_reset(void);
+void self_test_trace_print(void);
+
+#endif /* SELF_TEST_TRACE_H_ */
+
+/* [] END OF FILE */
@@ -0,0 +1,575 @@
+/******************************************************************************
+* File Name:   self_test_wdt.c
+*
+* Description: This file implements the watchdog supervisor of the self
+*              tests. Every phase of a blocking test is checked against a
+*              time budget learned from its first runs, and the hardware
+*              watchdog is kicked only when the phase completed within it.
+*              A scheduled test, which waits on the hardware across several
+*              ticks, is given a deadline for the whole run instead. Overruns
+*              are logged and stored as a fault of their own, and a hang that
+*              ends in a watchdog reset is reported at the next start-up.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+#include <stdio.h>
+#include <string.h>
+#include "self_test_wdt.h"
+#include "self_test_log.h"
+#include "self_test_nvlog.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Marks a valid progress record, see wdt_record */
+#define WDT_RECORD_MAGIC                   (0x57445447uL)
+
+/* No test is supervised */
+#define WDT_NONE                           ((uint32_t)SELF_TEST_ID_COUNT)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Progress of the supervised test, kept over a watchdog reset */
+typedef struct
+{
+    uint32_t magic;                /* WDT_RECORD_MAGIC while a test runs */
+    uint32_t state;                /* Test in bits 7:0, last completed phase in
+                                    * bits 15:8 */
+    uint32_t state_inv;            /* Complement of state */
+} wdt_record_t;
+
+/* Learned duration of a phase or of a scheduled run */
+typedef struct
+{
+    uint32_t max_us;               /* Longest duration while learning */
+    uint32_t count;                /* Runs measured, up to SELF_TEST_WDT_LEARN_RUNS */
+} wdt_learn_t;
+
+/*******************************************************************************
+* Global Variables
+*******************************************************************************/
+static const char * const wdt_test_names[SELF_TEST_ID_COUNT] =
+{
+    [SELF_TEST_ID_ADC] = "ADC",
+    [SELF_TEST_ID_COMPARATOR] = "Comparator",
+    [SELF_TEST_ID_OPAMP] = "OP-AMP",
+};
+
+/* Not initialized by the start-up code, so that it survives the reset */
+CY_NOINIT static wdt_record_t wdt_record;
+
+static bool wdt_ready;
+static self_test_wdt_stats_t wdt_stats;
+static wdt_learn_t wdt_phase_learn[SELF_TEST_ID_COUNT][SELF_TEST_PHASE_COUNT];
+static wdt_learn_t wdt_run_learn[SELF_TEST_ID_COUNT];
+
+/* Supervised test, WDT_NONE if none */
+static uint32_t wdt_active = WDT_NONE;
+static bool wdt_stepped;
+static uint32_t wdt_run_start_us;
+static uint32_t wdt_phase_start_us;
+
+/*******************************************************************************
+* Function Name: wdt_record_set
+********************************************************************************
+* Summary:
+* Records the test in progress and its last completed phase.
+*
+*******************************************************************************/
+static void wdt_record_set(uint32_t id, uint32_t phase)
+{
+    uint32_t state = id | (phase << 8);
+
+    wdt_record.state = state;
+    wdt_record.state_inv = ~state;
+    wdt_record.magic = WDT_RECORD_MAGIC;
+}
+
+/*******************************************************************************
+* Function Name: wdt_budget
+********************************************************************************
+* Summary:
+* Returns the budget of a phase or run: the ceiling while it is learned, then
+* SELF_TEST_WDT_BUDGET_FACTOR times the longest duration measured, within
+* min_us and max_us.
+*
+*******************************************************************************/
+static uint32_t wdt_budget(const wdt_learn_t *learn, uint32_t min_us, uint32_t max_us)
+{
+    uint32_t budget;
+
+    if (learn->count < SELF_TEST_WDT_LEARN_RUNS)
+    {
+        return max_us;
+    }
+
+    budget = learn->max_us * SELF_TEST_WDT_BUDGET_FACTOR;
+    if (budget < min_us)
+    {
+        budget = min_us;
+    }
+    if (budget > max_us)
+    {
+        budget = max_us;
+    }
+    return budget;
+}
+
+/*******************************************************************************
+* Function Name: wdt_learn
+********************************************************************************
+* Summary:
+* Adds a duration within the budget to the learned maximum, for the first
+* SELF_TEST_WDT_LEARN_RUNS runs only; the budget is fixed from then on.
+*
+*******************************************************************************/
+static void wdt_learn(wdt_learn_t *learn, uint32_t elapsed_us)
+{
+    if (learn->count < SELF_TEST_WDT_LEARN_RUNS)
+    {
+        if (elapsed_us > learn->max_us)
+        {
+            learn->max_us = elapsed_us;
+        }
+        learn->count++;
+    }
+}
+
+/*******************************************************************************
+* Function Name: wdt_overrun
+********************************************************************************
+* Summary:
+* Reports a phase or run that overran its budget, or a hang that ended in a
+* watchdog reset, as a fault of its own in the log and the result store.
+*
+*******************************************************************************/
+static void wdt_overrun(uint32_t id, uint32_t phase, uint32_t elapsed_us)
+{
+    wdt_stats.overruns++;
+    wdt_stats.last_overrun_us = elapsed_us;
+    self_test_log(SELF_TEST_LOG_WDT_OVERRUN, ERROR_STATUS, (uint8_t)id, (int32_t)phase,
+            (int32_t)elapsed_us);
+    (void)self_test_nvlog_append((uint8_t)id | SELF_TEST_NVLOG_OVERRUN, ERROR_STATUS,
+            SELF_TEST_NVLOG_OVERRUN_VALUE(phase, elapsed_us));
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_init
+********************************************************************************
+* Summary:
+* Starts the hardware watchdog with SELF_TEST_WDT_TIMEOUT_MS and clears the
+* learned budgets. If the watchdog caused the last reset, the test and phase
+* that hung are taken from the progress record and reported. Call it once the
+* result store is mounted, before the first test runs.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_wdt_init(void)
+{
+    uint32_t id = WDT_NONE;
+    uint32_t phase = SELF_TEST_WDT_PHASE_NONE;
+
+    self_test_wdt_reset();
+
+    if (analog_backend_wdt_caused_reset())
+    {
+        if ((WDT_RECORD_MAGIC == wdt_record.magic) &&
+            (wdt_record.state == ~wdt_record.state_inv))
+        {
+            id = wdt_record.state & 0xFFu;
+            phase = (wdt_record.state >> 8) & 0xFFu;
+        }
+        wdt_stats.resets++;
+        self_test_log(SELF_TEST_LOG_WDT_RESET, ERROR_STATUS, (uint8_t)id, (int32_t)phase, 0);
+        if (id < WDT_NONE)
+        {
+            wdt_stats.overruns++;
+            (void)self_test_nvlog_append((uint8_t)id | SELF_TEST_NVLOG_OVERRUN,
+                    ERROR_STATUS, SELF_TEST_NVLOG_OVERRUN_VALUE(phase,
+                    SELF_TEST_NVLOG_OVERRUN_RESET));
+        }
+    }
+    wdt_record.magic = 0u;
+
+    analog_backend_wdt_start(SELF_TEST_WDT_TIMEOUT_MS);
+    wdt_ready = true;
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_reset
+********************************************************************************
+* Summary:
+* Clears the statistics and the learned budgets and ends the supervision of
+* the run in progress. The hardware watchdog is left as it is.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_wdt_reset(void)
+{
+    (void)memset(&wdt_stats, 0, sizeof(wdt_stats));
+    (void)memset(wdt_phase_learn, 0, sizeof(wdt_phase_learn));
+    (void)memset(wdt_run_learn, 0, sizeof(wdt_run_learn));
+    wdt_active = WDT_NONE;
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_begin
+********************************************************************************
+* Summary:
+* Starts the supervision of a test run. The phases of a blocking run are each
+* checked by self_test_wdt_phase. A stepped run of the scheduler is only given
+* a deadline for the whole run, checked by self_test_wdt_expired, as its
+* phases include the application work between the ticks.
+*
+* Parameters:
+*  id      : Test that starts
+*  stepped : true for a run of the scheduler
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_wdt_begin(self_test_id_t id, bool stepped)
+{
+    if (!wdt_ready)
+    {
+        return;
+    }
+
+    wdt_active = (uint32_t)id;
+    wdt_stepped = stepped;
+    wdt_run_start_us = analog_backend_time_us();
+    wdt_phase_start_us = wdt_run_start_us;
+    wdt_stats.runs++;
+    wdt_record_set((uint32_t)id, SELF_TEST_WDT_PHASE_NONE);
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_phase
+********************************************************************************
+* Summary:
+* Called by self_test_trace_phase at the end of every phase. A phase of the
+* supervised blocking run that completed within its budget kicks the
+* watchdog; one that overran it is reported and does not, so a test that
+* keeps overrunning ends in a watchdog reset. Phases outside a supervised
+* blocking run are ignored.
+*
+* Parameters:
+*  id    : Test the phase belongs to
+*  phase : Phase that ended
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_wdt_phase(self_test_id_t id, self_test_phase_t phase)
+{
+    wdt_learn_t *learn;
+    uint32_t start;
+    uint32_t now;
+    uint32_t elapsed;
+
+    if ((wdt_active != (uint32_t)id) || wdt_stepped)
+    {
+        return;
+    }
+
+    start = analog_backend_cpu_ticks();
+    now = analog_backend_time_us();
+    elapsed = now - wdt_phase_start_us;
+    wdt_phase_start_us = now;
+    learn = &wdt_phase_learn[id][phase];
+    wdt_stats.phases++;
+
+    if (elapsed > wdt_budget(learn, SELF_TEST_WDT_PHASE_MIN_US, SELF_TEST_WDT_PHASE_MAX_US))
+    {
+        wdt_overrun((uint32_t)id, (uint32_t)phase, elapsed);
+    }
+    else
+    {
+        wdt_learn(learn, elapsed);
+        analog_backend_wdt_kick();
+        wdt_stats.kicks++;
+    }
+    wdt_record_set((uint32_t)id, (uint32_t)phase);
+
+    elapsed = analog_backend_cpu_ticks() - start;
+    if (elapsed > wdt_stats.max_check_ticks)
+    {
+        wdt_stats.max_check_ticks = elapsed;
+    }
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_end
+********************************************************************************
+* Summary:
+* Ends the supervision of a test run. The duration of a completed stepped run
+* is learned for the deadline of the next runs; an abandoned one is not.
+*
+* Parameters:
+*  id        : Test that ended
+*  completed : false if the run was abandoned
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_wdt_end(self_test_id_t id, bool completed)
+{
+    if (wdt_active != (uint32_t)id)
+    {
+        return;
+    }
+
+    if (wdt_stepped && completed)
+    {
+        wdt_learn(&wdt_run_learn[id], analog_backend_time_us() - wdt_run_start_us);
+    }
+    wdt_active = WDT_NONE;
+    wdt_record.magic = 0u;
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_expired
+********************************************************************************
+* Summary:
+* Checks the deadline of the supervised stepped run. A run past its deadline
+* is reported and its supervision ends; the scheduler then abandons it as a
+* failed run.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  true if the run overran its deadline
+*
+*******************************************************************************/
+bool self_test_wdt_expired(void)
+{
+    uint32_t elapsed;
+
+    if ((WDT_NONE == wdt_active) || !wdt_stepped)
+    {
+        return false;
+    }
+
+    elapsed = analog_backend_time_us() - wdt_run_start_us;
+    if (elapsed <= wdt_budget(&wdt_run_learn[wdt_active], SELF_TEST_WDT_RUN_MIN_US,
+            SELF_TEST_WDT_RUN_MAX_US))
+    {
+        return false;
+    }
+
+    wdt_overrun(wdt_active, SELF_TEST_WDT_PHASE_RUN, elapsed);
+    wdt_active = WDT_NONE;
+    wdt_record.magic = 0u;
+    return true;
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_service
+********************************************************************************
+* Summary:
+* Kicks the watchdog from the main loop, unless a stepped run is past its
+* deadline and has not been abandoned yet. Call it once per pass of the main
+* loop.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_wdt_service(void)
+{
+    if (!wdt_ready)
+    {
+        return;
+    }
+
+    if ((WDT_NONE != wdt_active) && wdt_stepped &&
+        ((analog_backend_time_us() - wdt_run_start_us) > wdt_budget(
+            &wdt_run_learn[wdt_active], SELF_TEST_WDT_RUN_MIN_US, SELF_TEST_WDT_RUN_MAX_US)))
+    {
+        return;
+    }
+
+    analog_backend_wdt_kick();
+    wdt_stats.kicks++;
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_adc_convert
+********************************************************************************
+* Summary:
+* Converts one SAR channel and waits for the result, at most
+* ANALOG_BACKEND_SAR_TIMEOUT_US. A conversion that does not complete in time
+* is stopped and reported as an overrun of the convert phase of the test, so
+* a stalled SAR fails the test instead of hanging it until the watchdog resets
+* the device.
+*
+* Parameters:
+*  id      : Test the conversion belongs to
+*  channel : SAR channel
+*  mv      : Returns the result in millivolts, 0 on a timeout
+*
+* Return :
+*  OK_STATUS if the conversion completed, ERROR_STATUS on a timeout
+*
+*******************************************************************************/
+uint8_t self_test_wdt_adc_convert(self_test_id_t id, uint32_t channel, int32_t *mv)
+{
+    uint32_t start;
+    uint32_t elapsed;
+
+    analog_backend_adc_start(channel);
+    start = analog_backend_time_us();
+    while (!analog_backend_adc_is_done())
+    {
+        elapsed = analog_backend_time_us() - start;
+        if (elapsed >= ANALOG_BACKEND_SAR_TIMEOUT_US)
+        {
+            analog_backend_adc_stop();
+            wdt_overrun((uint32_t)id, (uint32_t)SELF_TEST_PHASE_CONVERT, elapsed);
+            *mv = 0;
+            return ERROR_STATUS;
+        }
+    }
+    *mv = analog_backend_adc_read_mv(channel);
+
+    return OK_STATUS;
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_budget_us
+********************************************************************************
+* Summary:
+* Returns the current budget of a phase of a blocking run, or of a whole
+* stepped run for SELF_TEST_WDT_PHASE_RUN.
+*
+* Parameters:
+*  id    : Test
+*  phase : self_test_phase_t or SELF_TEST_WDT_PHASE_RUN
+*
+* Return :
+*  Budget in microseconds
+*
+*******************************************************************************/
+uint32_t self_test_wdt_budget_us(self_test_id_t id, uint32_t phase)
+{
+    if (SELF_TEST_WDT_PHASE_RUN == phase)
+    {
+        return wdt_budget(&wdt_run_learn[id], SELF_TEST_WDT_RUN_MIN_US,
+                SELF_TEST_WDT_RUN_MAX_US);
+    }
+    return wdt_budget(&wdt_phase_learn[id][phase], SELF_TEST_WDT_PHASE_MIN_US,
+            SELF_TEST_WDT_PHASE_MAX_US);
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_get_stats
+********************************************************************************
+* Summary:
+* Returns the supervisor statistics.
+*
+*******************************************************************************/
+const self_test_wdt_stats_t *self_test_wdt_get_stats(void)
+{
+    return &wdt_stats;
+}
+
+/*******************************************************************************
+* Function Name: self_test_wdt_print_stats
+********************************************************************************
+* Summary:
+* Prints the supervisor statistics and the budget of every phase and run
+* measured so far, marking the ones still learned.
+*
+* Parameters:
+*  none
+*
+* Return :
+*  void
+*
+*******************************************************************************/
+void self_test_wdt_print_stats(void)
+{
+    const wdt_learn_t *learn;
+    uint32_t id;
+    uint32_t phase;
+
+    printf("Watchdog supervisor: timeout %lu ms, %lu runs, %lu phases checked, "
+           "%lu kicks\r\n", (unsigned long)SELF_TEST_WDT_TIMEOUT_MS,
+            (unsigned long)wdt_stats.runs, (unsigned long)wdt_stats.phases,
+            (unsigned long)wdt_stats.kicks);
+    printf("  %lu overruns, %lu watchdog resets, longest check %lu ticks\r\n",
+            (unsigned long)wdt_stats.overruns, (unsigned long)wdt_stats.resets,
+            (unsigned long)wdt_stats.max_check_ticks);
+
+    for (id = 0u; id < (uint32_t)SELF_TEST_ID_COUNT; id++)
+    {
+        for (phase = 0u; phase <= SELF_TEST_WDT_PHASE_RUN; phase++)
+        {
+            learn = (SELF_TEST_WDT_PHASE_RUN == phase) ? &wdt_run_learn[id] :
+                    &wdt_phase_learn[id][phase];
+            if (0u == learn->count)
+            {
+                continue;
+            }
+            printf("  %-10s %-8s budget %6lu us, longest %6lu us%s\r\n",
+                    wdt_test_names[id], (SELF_TEST_WDT_PHASE_RUN == phase) ? "run" :
+                    self_test_trace_phase_name((self_test_phase_t)phase),
+                    (unsigned long)self_test_wdt_budget_us((self_test_id_t)id, phase),
+                    (unsigned long)learn->max_us,
+                    (learn->count < SELF_TEST_WDT_LEARN_RUNS) ? " (learning)" : "");
+        }
+    }
+}
+
+/* [] END OF FILE */
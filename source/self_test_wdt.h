@@ -0,0 +1,122 @@
+/******************************************************************************
+* File Name:   self_test_wdt.h
+*
+* Description: This file is the public interface of self_test_wdt.c, the
+*              watchdog supervisor that bounds the duration of every self-test
+*              phase and scheduled test run.
+*
+* Related Document: See README.md
+*
+*
+* Copyright 2024, Cypress Semiconductor Corporation (an Infineon company) or
+* an affiliate of Cypress Semiconductor Corporation.  All rights reserved.
+*
+* This software, including source code, documentation and related
+* materials ("Software") is owned by Cypress Semiconductor Corporation
+* or one of its affiliates ("Cypress") and is protected by and subject to
+* worldwide patent protection (United States and foreign),
+* United States copyright laws and international treaty provisions.
+* Therefore, you may use this Software only as provided in the license
+* agreement accompanying the software package from which you
+* obtained this Software ("EULA").
+* If no EULA applies, Cypress hereby grants you a personal, non-exclusive,
+* non-transferable license to copy, modify, and compile the Software
+* source code solely for use in connection with Cypress's
+* integrated circuit products.  Any reproduction, modification, translation,
+* compilation, or representation of this Software except as specified
+* above is prohibited without the express written permission of Cypress.
+*
+* Disclaimer: THIS SOFTWARE IS PROVIDED AS-IS, WITH NO WARRANTY OF ANY KIND,
+* EXPRESS OR IMPLIED, INCLUDING, BUT NOT LIMITED TO, NONINFRINGEMENT, IMPLIED
+* WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE. Cypress
+* reserves the right to make changes to the Software without notice. Cypress
+* does not assume any liability arising out of the application or use of the
+* Software or any product or circuit described in the Software. Cypress does
+* not authorize its products for use in any products where a malfunction or
+* failure of the Cypress product may reasonably be expected to result in
+* significant property damage, injury or death ("High Risk Product"). By
+* including Cypress's product in a High Risk Product, the manufacturer
+* of such system or application assumes all risk of such use and in doing
+* so agrees to indemnify Cypress against all liability.
+*******************************************************************************/
+
+/*******************************************************************************
+* Include guard
+*******************************************************************************/
+#ifndef SELF_TEST_WDT_H_
+#define SELF_TEST_WDT_H_
+
+#include "self_test.h"
+#include "self_test_trace.h"
+
+/*******************************************************************************
+* Macros
+*******************************************************************************/
+/* Hardware watchdog timeout, in milliseconds. It only resets the device if a
+ * test hangs so that no phase completes and the main loop does not run.
+ */
+#define SELF_TEST_WDT_TIMEOUT_MS           (500u)
+
+/* Runs of a phase, or scheduled runs of a test, measured before their budget
+ * is enforced. Until then the budget is the ceiling.
+ */
+#define SELF_TEST_WDT_LEARN_RUNS           (8u)
+
+/* A learned budget is this multiple of the longest duration measured */
+#define SELF_TEST_WDT_BUDGET_FACTOR        (2u)
+
+/* Bounds of the budget of a phase of a blocking test, in microseconds */
+#define SELF_TEST_WDT_PHASE_MIN_US         (50u)
+#define SELF_TEST_WDT_PHASE_MAX_US         (20000u)
+
+/* Bounds of the budget of a scheduled run, in microseconds. A scheduled run
+ * spans several ticks, so its floor leaves room for slow passes of the
+ * application loop in between.
+ */
+#define SELF_TEST_WDT_RUN_MIN_US           (10000u)
+#define SELF_TEST_WDT_RUN_MAX_US           (SELF_TEST_WDT_TIMEOUT_MS * 500u)
+
+/* Longest deep sleep of the low-power mode, so that the watchdog is kicked in
+ * time; the watchdog keeps counting in deep sleep.
+ */
+#define SELF_TEST_WDT_SLEEP_MAX_US         (SELF_TEST_WDT_TIMEOUT_MS * 500u)
+
+/* Phase argument of an overrun of a whole scheduled run */
+#define SELF_TEST_WDT_PHASE_RUN            ((uint32_t)SELF_TEST_PHASE_COUNT)
+
+/* Phase argument of a hang detected before the first phase completed */
+#define SELF_TEST_WDT_PHASE_NONE           (0xFFu)
+
+/*******************************************************************************
+* Data Types
+*******************************************************************************/
+/* Supervisor statistics */
+typedef struct
+{
+    uint32_t runs;                 /* Supervised runs */
+    uint32_t phases;               /* Phases checked against their budget */
+    uint32_t kicks;                /* Watchdog kicks */
+    uint32_t overruns;             /* Phases and runs over their budget */
+    uint32_t last_overrun_us;      /* Duration of the last overrun */
+    uint32_t resets;               /* Watchdog resets reported at start-up */
+    uint32_t max_check_ticks;      /* Longest phase check, in CPU ticks */
+} self_test_wdt_stats_t;
+
+/*******************************************************************************
+* Function Prototypes
+*******************************************************************************/
+void self_test_wdt_init(void);
+void self_test_wdt_reset(void);
+void self_test_wdt_begin(self_test_id_t id, bool stepped);
+void self_test_wdt_phase(self_test_id_t id, self_test_phase_t phase);
+void self_test_wdt_end(self_test_id_t id, bool completed);
+bool self_test_wdt_expired(void);
+void self_test_wdt_service(void);
+uint8_t self_test_wdt_adc_convert(self_test_id_t id, uint32_t channel, int32_t *mv);
+uint32_t self_test_wdt_budget_us(self_test_id_t id, uint32_t phase);
+const self_test_wdt_stats_t *self_test_wdt_get_stats(void);
+void self_test_wdt_print_stats(void);
+
+#endif /* SELF_TEST_WDT_H_ */
+
+/* [] END OF FILE */